@@ -0,0 +1,310 @@
+// Checks the per feature attribute index (AttrIndex) against the plain scan of the attribute list on random lists and
+// times single lookups both ways. Then runs the conditional symbology procedures over every feature of a dense harbour
+// cell with the index and with the scan, and checks both queue the same drawers. Lookup table resolution (findBestItem)
+// is timed the same way as it also asks for attributes. The first argument is the folder of the presentation library (../bin by default), the second one a cell to use
+// instead of the generated one.
+//     cl /O2 /EHsc /std:c++17 csp_bench.cpp drawing_stubs.cpp ..\parser.cpp ..\s57.cpp ..\geo.cpp ..\abstract_tools.cpp ..\chart_cache.cpp ..\dai_cache.cpp ..\csp.cpp ..\drawers.cpp ..\settings.cpp user32.lib gdi32.lib
+//     g++ -O2 -std=c++17 -Iwinstub csp_bench.cpp drawing_stubs.cpp ../parser.cpp ../s57.cpp ../geo.cpp ../abstract_tools.cpp ../chart_cache.cpp ../dai_cache.cpp ../csp.cpp ../drawers.cpp ../settings.cpp -o csp_bench -lpthread
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "../parser.h"
+#include "../drawers.h"
+#include "synthetic_cell.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const int NUM_OF_RUNS = 5;
+static const int NUM_OF_ROUNDS = 3;
+static const size_t GRID_SIZE = 40;
+static const size_t NUM_OF_POINTS = 8000;
+static const size_t NUM_OF_RANDOM_LISTS = 100000;
+
+struct CspRunResult {
+    size_t numOfCalls;
+    size_t numOfDrawers;
+    size_t numOfEdgePres;
+    uint64_t fingerprint;       // What the procedures left in the item copies
+    double itemSeconds;
+    double cspSeconds;
+};
+
+// Codes mostly below 192 as in real cells, some up to the mask limit and beyond it, and a few national ones
+static uint16_t randomAttrCode (std::mt19937& random) {
+    uint32_t kind = random () % 10;
+
+    if (kind < 7) return (uint16_t) (random () % 192);
+    if (kind < 9) return (uint16_t) (random () % 600);
+
+    return (uint16_t) (17000 + random () % 100);
+}
+
+// Every code below 600 and around the national ones probed on each list, the scan being the reference
+static size_t checkAttrIndex (size_t& numOfLookups) {
+    std::mt19937 random (14);
+    FeatureObject feature;
+    size_t numOfMismatches = 0;
+
+    numOfLookups = 0;
+
+    for (size_t i = 0; i < NUM_OF_RANDOM_LISTS; ++ i) {
+        feature.attributes.resize (random () % 20);
+
+        for (auto& attr: feature.attributes) attr.classCode = randomAttrCode (random);
+
+        std::vector<Attr *> expected;
+
+        feature.dropAttrIndex ();
+
+        for (size_t code = 0; code < 600; ++ code) expected.push_back (feature.getAttr (code));
+        for (size_t code = 16990; code < 17110; ++ code) expected.push_back (feature.getAttr (code));
+
+        feature.buildAttrIndex ();
+
+        for (size_t code = 0, probe = 0; code < 17110; ++ code) {
+            if (code == 600) code = 16990;
+
+            if (feature.getAttr (code) != expected [probe ++] && numOfMismatches ++ < 10) printf ("Attribute %zu found at another position\n", code);
+
+            ++ numOfLookups;
+        }
+    }
+
+    return numOfMismatches;
+}
+
+// 20000 features of the given attribute count, 24 random probes on each of them
+static void timeAttrLookups (size_t numOfAttrs) {
+    std::mt19937 random (7);
+    std::vector<FeatureObject> features (20000);
+    std::vector<uint16_t> probes (24);
+    size_t sink = 0;
+
+    for (auto& feature: features) {
+        feature.attributes.resize (numOfAttrs);
+
+        for (auto& attr: feature.attributes) attr.classCode = randomAttrCode (random);
+    }
+
+    for (auto& probe: probes) probe = (uint16_t) (random () % 192);
+
+    auto startedAt = Clock::now ();
+
+    for (auto& feature: features) feature.buildAttrIndex ();
+
+    double buildSeconds = std::chrono::duration<double> (Clock::now () - startedAt).count ();
+
+    startedAt = Clock::now ();
+
+    for (int run = 0; run < NUM_OF_RUNS; ++ run) {
+        for (auto& feature: features) {
+            for (auto probe: probes) sink += (size_t) feature.getAttr (probe);
+        }
+    }
+
+    double indexSeconds = std::chrono::duration<double> (Clock::now () - startedAt).count ();
+
+    for (auto& feature: features) feature.dropAttrIndex ();
+
+    startedAt = Clock::now ();
+
+    for (int run = 0; run < NUM_OF_RUNS; ++ run) {
+        for (auto& feature: features) {
+            for (auto probe: probes) sink -= (size_t) feature.getAttr (probe);
+        }
+    }
+
+    double scanSeconds = std::chrono::duration<double> (Clock::now () - startedAt).count ();
+    double numOfLookups = (double) NUM_OF_RUNS * features.size () * probes.size ();
+
+    printf (
+        "%2zu attributes: build %5.0f ns/feature, index %5.2f ns/lookup, scan %5.2f ns/lookup%s\n",
+        numOfAttrs,
+        buildSeconds * 1.0e9 / features.size (),
+        indexSeconds * 1.0e9 / numOfLookups,
+        scanSeconds * 1.0e9 / numOfLookups,
+        sink == 0 ? "" : " (results differ)"
+    );
+}
+
+static TableSet getTableSet (FeatureObject& feature) {
+    switch (feature.primitive) {
+        case PRIM::Point: return TableSet::SIMPLIFIED;
+        case PRIM::Line: return TableSet::LINES;
+        default: return TableSet::PLAIN_BOUNDARIES;
+    }
+}
+
+static uint64_t addToFingerprint (uint64_t fingerprint, LookupTableItem& item) {
+    auto add = [&fingerprint] (uint64_t value) { fingerprint = (fingerprint ^ value) * 0x100000001B3ull; };
+
+    add (item.displayPriority);
+    add (item.penIndex);
+    add (item.brushIndex);
+    add (item.patternBrushIndex);
+    add (item.centralSymbolIndex);
+    add (item.drawArc);
+
+    for (auto& symbol: item.symbols) add (symbol.symbolIndex);
+
+    return fingerprint;
+}
+
+// Same steps as the painter on a first render: resolve the lookup table entry, run its CSP on a copy
+static CspRunResult runCSPs (Chart& chart, Environment& environment, View& view, DrawQueue& drawQueue) {
+    CspRunResult result { 0, 0, 0, 0, 0.0, 0.0 };
+    std::vector<LookupTableItem *> items (chart.features.size ());
+    LookupTableItem item;
+    auto startedAt = Clock::now ();
+
+    for (int run = 0; run < NUM_OF_RUNS; ++ run) {
+        for (size_t i = 0; i < chart.features.size (); ++ i) {
+            items [i] = chart.features [i].findBestItem (DisplayCat::STANDARD, getTableSet (chart.features [i]), environment.dai);
+        }
+    }
+
+    result.itemSeconds = std::chrono::duration<double> (Clock::now () - startedAt).count () / NUM_OF_RUNS;
+    startedAt = Clock::now ();
+
+    for (int run = 0; run < NUM_OF_RUNS; ++ run) {
+        drawQueue.clear ();
+        drawQueue.edgePresentations.clear ();
+
+        for (size_t i = 0; i < chart.features.size (); ++ i) {
+            if (!items [i] || items [i]->procIndex == LookupTableItem::NOT_EXIST) continue;
+
+            item.reset ();
+            item.copyFrom (*items [i]);
+            environment.runCSP (& item, & chart.features [i], chart, view, drawQueue);
+
+            if (run == 0) {
+                ++ result.numOfCalls;
+                result.fingerprint = addToFingerprint (result.fingerprint, item);
+            }
+        }
+    }
+
+    result.cspSeconds = std::chrono::duration<double> (Clock::now () - startedAt).count () / NUM_OF_RUNS;
+    result.numOfDrawers = drawQueue.container.size ();
+    result.numOfEdgePres = drawQueue.edgePresentations.size ();
+    drawQueue.clear ();
+    drawQueue.edgePresentations.clear ();
+
+    return result;
+}
+
+static void keepBest (CspRunResult& best, CspRunResult& result) {
+    best.itemSeconds = std::min (best.itemSeconds, result.itemSeconds);
+    best.cspSeconds = std::min (best.cspSeconds, result.cspSeconds);
+}
+
+static void printResult (const char *name, CspRunResult& result, size_t numOfFeatures) {
+    printf (
+        "%-16s findBestItem %7.1f ms (%5.0f ns/feature)  CSPs %7.1f ms (%5.0f ns/call)\n",
+        name,
+        result.itemSeconds * 1000.0,
+        result.itemSeconds * 1.0e9 / numOfFeatures,
+        result.cspSeconds * 1000.0,
+        result.cspSeconds * 1.0e9 / result.numOfCalls
+    );
+}
+
+int main (int argc, char **argv) {
+    std::string libraryFolder (argc > 1 ? argv [1] : "../bin");
+    const char *path = argc > 2 ? argv [2] : "harbour_cell.000";
+    Environment environment;
+    MappedS57File s57File;
+    Chart chart;
+    size_t numOfLookups;
+    size_t numOfIndexMismatches = checkAttrIndex (numOfLookups);
+
+    printf ("%zu random attribute lists, %zu lookups compared, %zu mismatches\n", NUM_OF_RANDOM_LISTS, numOfLookups, numOfIndexMismatches);
+
+    for (size_t numOfAttrs: { 4, 8, 16, 32 }) timeAttrLookups (numOfAttrs);
+
+    loadObjectDictionary ((libraryFolder + "/objclass.dic").c_str (), environment.objectDictionary);
+    loadAttrDictionary ((libraryFolder + "/attributes.dic").c_str (), environment.attrDictionary);
+    loadColorTable ((libraryFolder + "/ColTables.rgb").c_str (), environment.dai);
+    loadDai ((libraryFolder + "/PresLib_e4.0.3.dai").c_str (), environment);
+
+    if (environment.dai.lookupTables.empty ()) {
+        printf ("Unable to load the presentation library from %s\n", libraryFolder.c_str ()); return 1;
+    }
+
+    if (argc < 3) {
+        SyntheticCell cell;
+
+        cell.generateHarbour (GRID_SIZE, NUM_OF_POINTS);
+
+        if (!cell.save (path)) {
+            printf ("Unable to write %s\n", path); return 1;
+        }
+    }
+
+    if (!s57File.open (path)) {
+        printf ("Unable to open %s\n", path); return 1;
+    }
+
+    // completeChart () without writing the chart cache
+    extractChart (s57File, chart);
+    deformatAttrValues (environment.attrDictionary, chart);
+    buildPointLocationInfo (chart);
+
+    auto [hasCoverage, zoom, north, west, south, east] = getCoverageRect (chart);
+    size_t numOfAttrs = 0;
+
+    if (!hasCoverage) {
+        north = 60.0; west = 10.6; south = 59.9; east = 10.8;
+        zoom = getZoomToCover (north, west, south, east);
+    }
+
+    for (auto& feature: chart.features) numOfAttrs += feature.attributes.size ();
+
+    RECT client { 0, 0, 1920, 1080 };
+    View view (north, west, zoom);
+    DrawQueue drawQueue (client, 0, PaletteIndex::Day, environment.dai, environment.attrDictionary, view);
+    size_t numOfFeatures = chart.features.size ();
+    CspRunResult indexed, scanned;
+    bool same = true;
+
+    // Rounds alternate so neither variant always runs on a warmed up heap
+    for (int round = 0; round < NUM_OF_ROUNDS; ++ round) {
+        CspRunResult result = runCSPs (chart, environment, view, drawQueue);
+
+        if (round == 0) indexed = result; else keepBest (indexed, result);
+
+        for (auto& feature: chart.features) feature.dropAttrIndex ();
+
+        result = runCSPs (chart, environment, view, drawQueue);
+
+        if (round == 0) scanned = result; else keepBest (scanned, result);
+
+        for (auto& feature: chart.features) feature.buildAttrIndex ();
+
+        same = same &&
+            result.numOfCalls == indexed.numOfCalls &&
+            result.numOfDrawers == indexed.numOfDrawers &&
+            result.numOfEdgePres == indexed.numOfEdgePres &&
+            result.fingerprint == indexed.fingerprint;
+    }
+
+    printf (
+        "%s: %zu features, %.1f attributes per feature, %zu CSP calls, %zu drawers and %zu edge presentations queued%s\n",
+        path,
+        numOfFeatures,
+        (double) numOfAttrs / numOfFeatures,
+        indexed.numOfCalls,
+        indexed.numOfDrawers,
+        indexed.numOfEdgePres,
+        same ? "" : " (the scan queued something else)"
+    );
+    printResult ("attribute index", indexed, numOfFeatures);
+    printResult ("attribute scan", scanned, numOfFeatures);
+
+    return same && numOfIndexMismatches == 0 ? 0 : 1;
+}
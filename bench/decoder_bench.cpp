@@ -0,0 +1,143 @@
+// Compares the ISO 8211 record decoding paths on a cell: the string keyed map path (parseDataRecord), the compiled
+// decoder converted back to field instances (readRecord + convertRecordView, what the structure view gets) and the
+// compiled decoder with views only (readRecord + FieldView::decode, what the chart extraction uses). The first two
+// must give the same subfield values. Without an argument a generated cell of 20000 edges is used.
+//     cl /O2 /EHsc /std:c++17 decoder_bench.cpp drawing_stubs.cpp ..\parser.cpp ..\s57.cpp ..\geo.cpp ..\abstract_tools.cpp ..\chart_cache.cpp ..\dai_cache.cpp ..\csp.cpp ..\drawers.cpp user32.lib gdi32.lib
+//     g++ -O2 -std=c++17 -Iwinstub decoder_bench.cpp drawing_stubs.cpp ../parser.cpp ../s57.cpp ../geo.cpp ../abstract_tools.cpp ../chart_cache.cpp ../dai_cache.cpp ../csp.cpp ../drawers.cpp -o decoder_bench -lpthread
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../parser.h"
+#include "synthetic_cell.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const int NUM_OF_RUNS = 3;
+
+static bool sameValue (SubFieldInstance& first, SubFieldInstance& second) {
+    return first.intValue == second.intValue && first.floatValue == second.floatValue && first.stringValue == second.stringValue && first.binaryValue == second.binaryValue;
+}
+
+// Every subfield value of every record through the map path and through the converted views
+static size_t compareDecoders (MappedS57File& s57File, std::vector<const char *>& recordStarts, size_t& numOfValues) {
+    std::vector<FieldInstance> expected, actual;
+    std::vector<SubFieldView> subFields;
+    RecordView record;
+    size_t numOfMismatches = 0;
+
+    numOfValues = 0;
+
+    for (auto recStart: recordStarts) {
+        parseDataRecord (recStart, s57File.dataDescriptiveFields, expected);
+
+        if (!s57File.readRecord (recStart, record)) {
+            ++ numOfMismatches; continue;
+        }
+
+        convertRecordView (record, actual, subFields);
+
+        if (expected.size () != actual.size ()) {
+            ++ numOfMismatches; continue;
+        }
+
+        for (size_t i = 0; i < expected.size (); ++ i) {
+            auto& expectedField = expected [i];
+            auto& actualField = actual [i];
+
+            if (expectedField.tag != actualField.tag || expectedField.instanceValues.size () != actualField.instanceValues.size ()) {
+                if (numOfMismatches ++ < 10) printf ("%s: %zu instances instead of %zu\n", expectedField.tag.c_str (), actualField.instanceValues.size (), expectedField.instanceValues.size ());
+                continue;
+            }
+
+            for (size_t j = 0; j < expectedField.instanceValues.size (); ++ j) {
+                for (auto& [tag, value]: expectedField.instanceValues [j]) {
+                    ++ numOfValues;
+
+                    if (!sameValue (value, actualField.instanceValues [j][tag]) && numOfMismatches ++ < 10) printf ("%s/%s differs\n", expectedField.tag.c_str (), tag.c_str ());
+                }
+            }
+        }
+    }
+
+    return numOfMismatches;
+}
+
+static void printRate (const char *name, Clock::time_point startedAt, size_t numOfRecords, size_t size) {
+    double seconds = std::chrono::duration<double> (Clock::now () - startedAt).count () / NUM_OF_RUNS;
+
+    printf ("%-32s %8.0f k records/s %7.1f MB/s\n", name, numOfRecords / seconds / 1000.0, size / seconds / 1048576.0);
+}
+
+int main (int argc, char **argv) {
+    const char *path = argc > 1 ? argv [1] : "synthetic_cell.000";
+    MappedS57File s57File;
+    std::vector<const char *> recordStarts;
+
+    if (argc < 2) {
+        SyntheticCell cell;
+
+        cell.generate (20000);
+
+        if (!cell.save (path)) {
+            printf ("Unable to write %s\n", path); return 1;
+        }
+    }
+
+    if (!s57File.open (path)) {
+        printf ("Unable to open %s\n", path); return 1;
+    }
+
+    size_t numOfRecords = s57File.scanRecords (recordStarts);
+    size_t numOfValues;
+    size_t numOfMismatches = compareDecoders (s57File, recordStarts, numOfValues);
+
+    printf ("%s: %zu records, %.1f MB; %zu subfield values compared, %zu mismatches\n", path, numOfRecords, s57File.file.size / 1048576.0, numOfValues, numOfMismatches);
+
+    std::vector<FieldInstance> fieldInstances;
+    std::vector<SubFieldView> subFields;
+    RecordView record;
+    size_t sink = 0;
+    auto startedAt = Clock::now ();
+
+    for (int run = 0; run < NUM_OF_RUNS; ++ run) {
+        for (auto recStart: recordStarts) sink += parseDataRecord (recStart, s57File.dataDescriptiveFields, fieldInstances);
+    }
+
+    printRate ("parseDataRecord (maps)", startedAt, numOfRecords, s57File.file.size);
+    startedAt = Clock::now ();
+
+    for (int run = 0; run < NUM_OF_RUNS; ++ run) {
+        for (auto recStart: recordStarts) {
+            if (s57File.readRecord (recStart, record)) convertRecordView (record, fieldInstances, subFields);
+
+            sink += fieldInstances.size ();
+        }
+    }
+
+    printRate ("readRecord + convertRecordView", startedAt, numOfRecords, s57File.file.size);
+    startedAt = Clock::now ();
+
+    for (int run = 0; run < NUM_OF_RUNS; ++ run) {
+        for (auto recStart: recordStarts) {
+            if (!s57File.readRecord (recStart, record)) continue;
+
+            for (auto& field: record.fields) {
+                size_t numOfInstances = field.decode (subFields);
+
+                for (auto& subField: subFields) {
+                    if (subField.hasValue && subField.type () == 'b') sink += subField.intValue ();
+                }
+
+                sink += numOfInstances;
+            }
+        }
+    }
+
+    printRate ("readRecord + FieldView::decode", startedAt, numOfRecords, s57File.file.size);
+    printf ("(%zu)\n", sink);
+
+    return numOfMismatches == 0 ? 0 : 1;
+}
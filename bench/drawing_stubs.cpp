@@ -0,0 +1,111 @@
+// Functions of painter.cpp the parser, the CSPs and the drawers refer to. Benchmarks never paint, so they are linked
+// against these instead.
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "../parser.h"
+#include "../painter.h"
+
+void createPatternTools (Dai& dai) {}
+
+HBRUSH createPatternBrush (PatternDesc& pattern, PaletteIndex paletteIndex, Dai& dai) {
+    return 0;
+}
+
+void paintLine (
+    RECT& client,
+    HDC paintDC,
+    int style,
+    int width,
+    size_t colorIndex,
+    double lat,
+    double lon,
+    double brg,
+    double lengthInMm,
+    View& view,
+    PaletteIndex paletteIndex,
+    Palette& palette
+) {}
+
+void paintArc (
+    RECT& client,
+    HDC paintDC,
+    int style,
+    int width,
+    size_t colorIndex,
+    double centerLat,
+    double centerLon,
+    double start,
+    double end,
+    double radiusInMm,
+    View& view,
+    PaletteIndex paletteIndex,
+    Palette& palette
+) {}
+
+void paintPolyPolyline (
+    RECT& client,
+    HDC paintDC,
+    int style,
+    int width,
+    size_t colorIndex,
+    Contours& contours,
+    View& view,
+    PaletteIndex paletteIndex,
+    Palette& palette
+) {}
+
+void paintPolyPolygon (
+    RECT& client,
+    HDC paintDC,
+    size_t fillBrushIndex,
+    size_t patternBrushIndex,
+    Contours& contours,
+    View& view,
+    PaletteIndex paletteIndex,
+    Palette& palette
+) {}
+
+void paintText (
+    RECT& client,
+    HDC paintDC,
+    char *text,
+    unsigned int format,
+    double lat,
+    double lon,
+    int xOffset,
+    int yOffset,
+    size_t colorIndex,
+    View& view,
+    PaletteIndex paletteIndex,
+    Dai& dai
+) {}
+
+void paintSymbol (
+    RECT& client,
+    HDC paintDC,
+    double lat,
+    double lon,
+    size_t symbolIndex,
+    double rotAngle,
+    Dai& dai,
+    View& view,
+    PaletteIndex paletteIndex
+) {}
+
+void paintSymbol (
+    RECT& client,
+    HDC paintDC,
+    int x,
+    int y,
+    size_t symbolIndex,
+    double rotAngle,
+    Dai& dai,
+    PaletteIndex paletteIndex
+) {}
+
+std::tuple<bool, int, int> getCenterPos (size_t edgeIndex, RECT& client, Chart& chart, View& view) {
+    return std::tuple<bool, int, int> (false, 0, 0);
+}
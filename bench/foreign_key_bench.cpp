@@ -0,0 +1,293 @@
+// Checks ForeignKeyIndex against a linear scan of the same keys on random key sets under random set, erase and find
+// calls, then times it against the std::map it replaced, on synthetic key sets and on the references of a large cell.
+// Extraction of the cell is timed as a whole, so the share of the key lookups in it is seen. Without an argument a
+// generated 150 x 150 harbour grid with 40000 point features is used.
+//     cl /O2 /EHsc /std:c++17 foreign_key_bench.cpp drawing_stubs.cpp ..\parser.cpp ..\s57.cpp ..\geo.cpp ..\abstract_tools.cpp ..\chart_cache.cpp ..\dai_cache.cpp ..\csp.cpp ..\drawers.cpp user32.lib gdi32.lib
+//     g++ -O2 -std=c++17 -Iwinstub foreign_key_bench.cpp drawing_stubs.cpp ../parser.cpp ../s57.cpp ../geo.cpp ../abstract_tools.cpp ../chart_cache.cpp ../dai_cache.cpp ../csp.cpp ../drawers.cpp -o foreign_key_bench -lpthread
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "../parser.h"
+#include "synthetic_cell.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const int NUM_OF_RUNS = 3;
+static const int NUM_OF_ROUNDS = 200;
+static const size_t GRID_SIZE = 150;
+static const size_t NUM_OF_POINTS = 40000;
+
+// Reference the index has to agree with: the first entry of a key wins, as in ForeignKeyIndex::build
+struct LinearKeyList {
+    std::vector<std::pair<uint64_t, size_t>> entries;
+
+    size_t find (uint64_t key) {
+        for (auto& entry: entries) {
+            if (entry.first == key) return entry.second;
+        }
+        return LookupTableItem::NOT_EXIST;
+    }
+    void set (uint64_t key, size_t index) {
+        for (auto& entry: entries) {
+            if (entry.first == key) {
+                entry.second = index; return;
+            }
+        }
+        entries.emplace_back (key, index);
+    }
+    void erase (uint64_t key) {
+        for (size_t i = 0; i < entries.size (); ++ i) {
+            if (entries [i].first == key) {
+                entries.erase (entries.begin () + i); return;
+            }
+        }
+    }
+};
+
+static double getMs (Clock::time_point startedAt, Clock::time_point finishedAt) {
+    return std::chrono::duration<double, std::milli> (finishedAt - startedAt).count ();
+}
+
+// Odd rounds have dense RCIDs (direct tables), even ones random RCIDs (sorted vector); some keys are tombstones
+static size_t checkIndex (size_t& numOfCalls) {
+    std::mt19937 random (17);
+    size_t numOfMismatches = 0;
+
+    numOfCalls = 0;
+
+    for (int round = 0; round < NUM_OF_ROUNDS; ++ round) {
+        bool dense = (round & 1) != 0;
+        uint32_t numOfKeys = random () % 500;
+        std::vector<uint64_t> keys;
+        LinearKeyList reference;
+        ForeignKeyIndex index;
+
+        for (uint32_t i = 0; i < numOfKeys; ++ i) {
+            uint8_t recName = (uint8_t) (110 + random () % 3 * 10);
+            uint32_t rcid = dense ? random () % (numOfKeys + 5) + 1 : (uint32_t) random ();
+            uint64_t key = random () % 20 == 0 ? (uint64_t) LookupTableItem::NOT_EXIST : constructForeignKey (recName, rcid);
+
+            keys.push_back (key);
+
+            if (key != LookupTableItem::NOT_EXIST && reference.find (key) == LookupTableItem::NOT_EXIST) reference.set (key, i);
+        }
+
+        index.build (keys);
+
+        for (uint32_t call = 0; call < 2000; ++ call) {
+            uint8_t recName = (uint8_t) (110 + random () % 3 * 10);
+            uint32_t operation = random () % 4;
+            uint32_t rcid;
+
+            if (dense) {
+                rcid = random () % (numOfKeys + 50);
+            } else if (call % 2 == 1 && numOfKeys > 0) {
+                rcid = (uint32_t) keys [random () % numOfKeys];
+            } else {
+                rcid = (uint32_t) random ();
+            }
+
+            uint64_t key = constructForeignKey (recName, rcid);
+
+            if (operation == 0) {
+                index.set (key, call);
+                reference.set (key, call);
+            } else if (operation == 1) {
+                index.erase (key);
+                reference.erase (key);
+            }
+
+            ++ numOfCalls;
+
+            if (index.find (key) != reference.find (key) && numOfMismatches ++ < 10) printf ("Round %d: key %016llx differs\n", round, (unsigned long long) key);
+        }
+
+        for (auto& [key, position]: reference.entries) {
+            ++ numOfCalls;
+
+            if (index.find (key) != position && numOfMismatches ++ < 10) printf ("Round %d: key %016llx lost\n", round, (unsigned long long) key);
+        }
+    }
+
+    return numOfMismatches;
+}
+
+struct LookupTimes {
+    double indexBuildMs, indexFindMs, mapBuildMs, mapFindMs;
+    bool same;
+};
+
+// Both structures built from the key lists of the collections and asked for every probe
+static LookupTimes timeLookups (std::vector<std::vector<uint64_t>>& keyLists, std::vector<uint64_t>& probes, std::vector<size_t>& listOfProbe) {
+    LookupTimes times { 0.0, 0.0, 0.0, 0.0, true };
+    std::vector<size_t> expected (probes.size ()), actual (probes.size ());
+
+    for (int run = 0; run < NUM_OF_RUNS; ++ run) {
+        std::vector<ForeignKeyIndex> indexes (keyLists.size ());
+        std::vector<std::map<uint64_t, size_t>> maps (keyLists.size ());
+        auto startedAt = Clock::now ();
+
+        for (size_t i = 0; i < keyLists.size (); ++ i) indexes [i].build (keyLists [i]);
+
+        auto builtAt = Clock::now ();
+
+        for (size_t i = 0; i < probes.size (); ++ i) actual [i] = indexes [listOfProbe [i]].find (probes [i]);
+
+        auto foundAt = Clock::now ();
+
+        for (size_t i = 0; i < keyLists.size (); ++ i) {
+            for (size_t j = 0; j < keyLists [i].size (); ++ j) maps [i].emplace (keyLists [i][j], j);
+        }
+
+        auto mapBuiltAt = Clock::now ();
+
+        for (size_t i = 0; i < probes.size (); ++ i) {
+            auto& map = maps [listOfProbe [i]];
+            auto pos = map.find (probes [i]);
+
+            expected [i] = pos == map.end () ? LookupTableItem::NOT_EXIST : pos->second;
+        }
+
+        auto mapFoundAt = Clock::now ();
+
+        times.indexBuildMs += getMs (startedAt, builtAt) / NUM_OF_RUNS;
+        times.indexFindMs += getMs (builtAt, foundAt) / NUM_OF_RUNS;
+        times.mapBuildMs += getMs (foundAt, mapBuiltAt) / NUM_OF_RUNS;
+        times.mapFindMs += getMs (mapBuiltAt, mapFoundAt) / NUM_OF_RUNS;
+        times.same = times.same && expected == actual;
+    }
+
+    return times;
+}
+
+static void printTimes (const char *name, LookupTimes& times) {
+    printf (
+        "%-22s index build %6.1f ms + lookups %6.1f ms, std::map build %6.1f ms + lookups %6.1f ms%s\n",
+        name,
+        times.indexBuildMs,
+        times.indexFindMs,
+        times.mapBuildMs,
+        times.mapFindMs,
+        times.same ? "" : " (results differ)"
+    );
+}
+
+// 100000 connected nodes and 50000 edges, looked up 600000 times
+static void timeSyntheticKeys (bool dense) {
+    std::mt19937 random (9);
+    std::vector<std::vector<uint64_t>> keyLists (2);
+    std::vector<uint64_t> probes;
+    std::vector<size_t> listOfProbe;
+
+    for (uint32_t i = 0; i < 150000; ++ i) {
+        bool node = i < 100000;
+
+        keyLists [node ? 0 : 1].push_back (constructForeignKey (node ? 120 : 130, dense ? 1 + i % 100000 : (uint32_t) random ()));
+    }
+
+    for (size_t i = 0; i < 600000; ++ i) {
+        size_t list = random () % 3 == 0 ? 1 : 0;
+
+        listOfProbe.push_back (list);
+        probes.push_back (keyLists [list][random () % keyLists [list].size ()]);
+    }
+
+    LookupTimes times = timeLookups (keyLists, probes, listOfProbe);
+
+    printTimes (dense ? "dense rcids" : "random rcids", times);
+}
+
+int main (int argc, char **argv) {
+    const char *path = argc > 1 ? argv [1] : "large_cell.000";
+    size_t numOfCalls;
+    size_t numOfMismatches = checkIndex (numOfCalls);
+
+    printf ("%d random key sets, %zu calls checked against a linear scan, %zu mismatches\n", NUM_OF_ROUNDS, numOfCalls, numOfMismatches);
+    timeSyntheticKeys (true);
+    timeSyntheticKeys (false);
+
+    if (argc < 2) {
+        SyntheticCell cell;
+
+        cell.generateHarbour (GRID_SIZE, NUM_OF_POINTS);
+
+        if (!cell.save (path)) {
+            printf ("Unable to write %s\n", path); return 1;
+        }
+    }
+
+    MappedS57File s57File;
+
+    if (!s57File.open (path)) {
+        printf ("Unable to open %s\n", path); return 1;
+    }
+
+    double extractMs = 0.0;
+    Chart chart;
+
+    for (int run = 0; run < NUM_OF_RUNS; ++ run) {
+        Chart runChart;
+        auto startedAt = Clock::now ();
+
+        extractChart (s57File, runChart);
+        extractMs += getMs (startedAt, Clock::now ()) / NUM_OF_RUNS;
+
+        if (run == NUM_OF_RUNS - 1) std::swap (chart, runChart);
+    }
+
+    // Keys of the nodes and edges, and every VRPT and FSPT reference the extraction resolved, again as keys
+    std::vector<std::vector<uint64_t>> keyLists (2);
+    std::vector<uint64_t> probes;
+    std::vector<size_t> listOfProbe, resolved;
+
+    for (auto& node: chart.nodes) keyLists [0].push_back (constructForeignKey (node.recordName, node.id));
+    for (auto& edge: chart.edges) keyLists [1].push_back (constructForeignKey (edge.recordName, edge.id));
+
+    auto addProbe = [&] (size_t list, size_t position) {
+        if (position >= keyLists [list].size ()) return;
+
+        probes.push_back (keyLists [list][position]);
+        listOfProbe.push_back (list);
+        resolved.push_back (position);
+    };
+
+    for (auto& edge: chart.edges) {
+        addProbe (0, edge.beginIndex);
+        addProbe (0, edge.endIndex);
+    }
+
+    for (auto& feature: chart.features) {
+        if (feature.primitive == PRIM::Point) addProbe (0, feature.nodeIndex);
+
+        for (auto& edgeRef: feature.edgeRefs) addProbe (1, edgeRef.index);
+    }
+
+    LookupTimes times = timeLookups (keyLists, probes, listOfProbe);
+    std::vector<size_t> found;
+
+    ForeignKeyIndex nodeIndex, edgeIndex;
+
+    nodeIndex.build (keyLists [0]);
+    edgeIndex.build (keyLists [1]);
+
+    for (size_t i = 0; i < probes.size (); ++ i) found.push_back ((listOfProbe [i] == 0 ? nodeIndex : edgeIndex).find (probes [i]));
+
+    times.same = times.same && found == resolved;
+
+    printf (
+        "%s: %zu nodes, %zu edges, %zu features, %zu references; extractChart %.1f ms\n",
+        path,
+        chart.nodes.size (),
+        chart.edges.size (),
+        chart.features.size (),
+        probes.size (),
+        extractMs
+    );
+    printTimes ("references of the cell", times);
+
+    return numOfMismatches == 0 && times.same ? 0 : 1;
+}
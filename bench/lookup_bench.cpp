@@ -0,0 +1,314 @@
+// Checks the compiled lookup table matcher (FeatureObject::matchItem) against the linear fitsInAttrsRequired scan it
+// replaced, on random tables and on every table of the presentation library with features built from the table's own
+// conditions. Then resolves every feature of a large cell through findBestItem with the matchers and with the linear
+// scan (the path taken when a table has no matcher). The first argument is the folder of the presentation library
+// (../bin by default), the second one a cell to use instead of a generated 150 x 150 harbour grid with 40000 points.
+//     cl /O2 /EHsc /std:c++17 lookup_bench.cpp drawing_stubs.cpp ..\parser.cpp ..\s57.cpp ..\geo.cpp ..\abstract_tools.cpp ..\chart_cache.cpp ..\dai_cache.cpp ..\csp.cpp ..\drawers.cpp ..\settings.cpp user32.lib gdi32.lib
+//     g++ -O2 -std=c++17 -Iwinstub lookup_bench.cpp drawing_stubs.cpp ../parser.cpp ../s57.cpp ../geo.cpp ../abstract_tools.cpp ../chart_cache.cpp ../dai_cache.cpp ../csp.cpp ../drawers.cpp ../settings.cpp -o lookup_bench -lpthread
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "../parser.h"
+#include "synthetic_cell.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const int NUM_OF_RUNS = 5;
+static const size_t NUM_OF_RANDOM_TABLES = 3000;
+static const size_t FEATURES_PER_TABLE = 200;
+static const size_t GRID_SIZE = 150;
+static const size_t NUM_OF_POINTS = 40000;
+
+// findBestItem without a matcher
+static LookupTableItem *findLinear (FeatureObject& feature, LookupTable& table) {
+    for (size_t i = 1; i < table.size (); ++ i) {
+        if (feature.fitsInAttrsRequired (table [i].attrCombination)) return & table [i];
+    }
+
+    return & table [0];
+}
+
+static void setAttrValue (Attr& attr, char domain, bool noValue, uint32_t intValue, double floatValue, std::vector<uint8_t>& list, StringPool& pool) {
+    attr.noValue = noValue;
+
+    switch (domain) {
+        case 'E':
+        case 'I':
+            attr.setInt (domain, intValue); break;
+        case 'F':
+            attr.setFloat (floatValue); break;
+        case 'L':
+            attr.setList (pool, list.data (), list.size ()); break;
+        default:
+            attr.domain = domain;
+    }
+}
+
+// Few class codes and values so conditions hit often; one code lies above the matcher presence mask
+static size_t checkRandomTables (size_t& numOfFeatures) {
+    static const uint16_t CODES [] = { 17, 75, 87, 149, 600 };
+    static const char DOMAINS [] = { 'E', 'I', 'F', 'L', 'A' };
+    std::mt19937 random (23);
+    auto uniform = [&random] (uint32_t limit) { return (uint32_t) (random () % limit); };
+    StringPool pool;
+    size_t numOfMismatches = 0;
+
+    numOfFeatures = 0;
+
+    for (size_t t = 0; t < NUM_OF_RANDOM_TABLES; ++ t) {
+        LookupTable table (1 + uniform (40));
+        LookupTableMatcher matcher;
+
+        for (auto& item: table) {
+            for (uint32_t i = uniform (4); i > 0; -- i) {
+                auto& required = item.attrCombination.emplace_back ();
+                size_t kind = uniform (5);
+
+                required.classCode = CODES [kind];
+                required.domain = DOMAINS [kind];
+                required.noValue = uniform (6) == 0;
+                required.intValue = uniform (3);
+                required.floatValue = uniform (3);
+
+                if (required.domain == 'L') {
+                    for (uint32_t j = uniform (3); j > 0; -- j) required.listValue.push_back ((uint8_t) (1 + uniform (2)));
+                }
+            }
+        }
+
+        matcher.compile (table);
+
+        for (size_t f = 0; f < FEATURES_PER_TABLE / 4; ++ f) {
+            FeatureObject feature;
+
+            for (size_t kind = 0; kind < 5; ++ kind) {
+                if (uniform (2) == 0) continue;
+
+                std::vector<uint8_t> list;
+
+                for (uint32_t j = uniform (3); j > 0; -- j) list.push_back ((uint8_t) (1 + uniform (2)));
+
+                auto& attr = feature.attributes.emplace_back ();
+
+                attr.classCode = CODES [kind];
+                setAttrValue (attr, DOMAINS [kind], uniform (5) == 0, uniform (3), uniform (3), list, pool);
+            }
+
+            if (uniform (2) == 0) feature.buildAttrIndex ();
+
+            ++ numOfFeatures;
+
+            if (feature.matchItem (table, matcher) != findLinear (feature, table) && numOfMismatches ++ < 10) printf ("Random table %zu: another item chosen\n", t);
+        }
+    }
+
+    return numOfMismatches;
+}
+
+// A few required attributes of random items of the table, some with another value, plus attributes no rule asks for
+static void makeLibraryFeature (FeatureObject& feature, LookupTable& table, std::mt19937& random, StringPool& pool) {
+    auto uniform = [&random] (uint32_t limit) { return (uint32_t) (random () % limit); };
+
+    feature.attributes.clear ();
+    feature.dropAttrIndex ();
+
+    for (uint32_t i = uniform (3) + 1; i > 0 && table.size () > 1; -- i) {
+        auto& item = table [1 + uniform ((uint32_t) table.size () - 1)];
+
+        for (auto& required: item.attrCombination) {
+            if (uniform (4) == 0) continue;
+
+            bool changed = uniform (3) == 0;
+            std::vector<uint8_t> list (required.listValue);
+
+            if (changed) list.push_back (1);
+
+            auto& attr = feature.attributes.emplace_back ();
+
+            attr.classCode = required.classCode;
+            setAttrValue (attr, required.domain, required.noValue && !changed, required.intValue + (changed ? 1 : 0), required.floatValue + (changed ? 1.0 : 0.0), list, pool);
+        }
+    }
+
+    for (uint32_t i = uniform (5); i > 0; -- i) {
+        auto& attr = feature.attributes.emplace_back ();
+
+        attr.classCode = (uint16_t) (100 + uniform (100));
+        attr.setInt ('I', uniform (10));
+        attr.noValue = false;
+    }
+
+    feature.buildAttrIndex ();
+}
+
+struct TableSizeBucket {
+    size_t maxSize;
+    size_t numOfFeatures;
+    double linearSeconds, matcherSeconds;
+};
+
+// Every table of the library, checked and timed by table size
+static size_t checkLibraryTables (Dai& dai, std::vector<TableSizeBucket>& buckets, size_t& numOfFeatures) {
+    std::mt19937 random (230);
+    std::vector<FeatureObject> features (FEATURES_PER_TABLE);
+    StringPool pool;
+    size_t numOfMismatches = 0;
+
+    numOfFeatures = 0;
+
+    for (size_t t = 0; t < dai.lookupTables.size (); ++ t) {
+        auto& table = dai.lookupTables [t];
+        auto& matcher = dai.lookupTableMatchers [t];
+        size_t bucket = 0;
+
+        while (bucket + 1 < buckets.size () && table.size () > buckets [bucket].maxSize) ++ bucket;
+
+        for (auto& feature: features) makeLibraryFeature (feature, table, random, pool);
+
+        for (auto& feature: features) {
+            if (feature.matchItem (table, matcher) != findLinear (feature, table) && numOfMismatches ++ < 10) printf ("Table %zu (%s): another item chosen\n", t, table [0].acronym);
+        }
+
+        size_t sink = 0;
+        auto startedAt = Clock::now ();
+
+        for (int run = 0; run < NUM_OF_RUNS; ++ run) {
+            for (auto& feature: features) sink += (size_t) findLinear (feature, table);
+        }
+
+        auto scannedAt = Clock::now ();
+
+        for (int run = 0; run < NUM_OF_RUNS; ++ run) {
+            for (auto& feature: features) sink -= (size_t) feature.matchItem (table, matcher);
+        }
+
+        buckets [bucket].linearSeconds += std::chrono::duration<double> (scannedAt - startedAt).count ();
+        buckets [bucket].matcherSeconds += std::chrono::duration<double> (Clock::now () - scannedAt).count ();
+        buckets [bucket].numOfFeatures += features.size () * NUM_OF_RUNS;
+        numOfFeatures += features.size ();
+
+        if (sink != 0 && numOfMismatches ++ < 10) printf ("Table %zu (%s): timed runs differ\n", t, table [0].acronym);
+    }
+
+    return numOfMismatches;
+}
+
+// Display variants the painter can ask for
+static const TableSet POINT_TABLE_SETS [] = { TableSet::SIMPLIFIED, TableSet::PAPER_CHARTS };
+static const TableSet AREA_TABLE_SETS [] = { TableSet::PLAIN_BOUNDARIES, TableSet::SYMBOLIZED_BOUNDARIES };
+
+static void resolveFeatures (Chart& chart, Dai& dai, std::vector<LookupTableItem *>& items) {
+    items.clear ();
+
+    for (auto& feature: chart.features) {
+        for (int variant = 0; variant < 2; ++ variant) {
+            TableSet tableSet;
+
+            switch (feature.primitive) {
+                case PRIM::Point: tableSet = POINT_TABLE_SETS [variant]; break;
+                case PRIM::Line: tableSet = TableSet::LINES; break;
+                default: tableSet = AREA_TABLE_SETS [variant];
+            }
+
+            items.push_back (feature.findBestItem (DisplayCat::STANDARD, tableSet, dai));
+        }
+    }
+}
+
+static double timeResolving (Chart& chart, Dai& dai, std::vector<LookupTableItem *>& items) {
+    auto startedAt = Clock::now ();
+
+    for (int run = 0; run < NUM_OF_RUNS; ++ run) resolveFeatures (chart, dai, items);
+
+    return std::chrono::duration<double> (Clock::now () - startedAt).count () / NUM_OF_RUNS;
+}
+
+int main (int argc, char **argv) {
+    std::string libraryFolder (argc > 1 ? argv [1] : "../bin");
+    const char *path = argc > 2 ? argv [2] : "large_cell.000";
+    Environment environment;
+    Dai& dai = environment.dai;
+    size_t numOfFeatures;
+    size_t numOfMismatches = checkRandomTables (numOfFeatures);
+
+    printf ("%zu random tables, %zu features checked against the linear scan, %zu mismatches\n", NUM_OF_RANDOM_TABLES, numOfFeatures, numOfMismatches);
+
+    loadObjectDictionary ((libraryFolder + "/objclass.dic").c_str (), environment.objectDictionary);
+    loadAttrDictionary ((libraryFolder + "/attributes.dic").c_str (), environment.attrDictionary);
+    loadColorTable ((libraryFolder + "/ColTables.rgb").c_str (), dai);
+    loadDai ((libraryFolder + "/PresLib_e4.0.3.dai").c_str (), environment);
+
+    if (dai.lookupTables.empty ()) {
+        printf ("Unable to load the presentation library from %s\n", libraryFolder.c_str ()); return 1;
+    }
+
+    std::vector<TableSizeBucket> buckets { { 5, 0, 0.0, 0.0 }, { 20, 0, 0.0, 0.0 }, { 50, 0, 0.0, 0.0 }, { 100, 0, 0.0, 0.0 }, { SIZE_MAX, 0, 0.0, 0.0 } };
+    size_t numOfLibraryMismatches = checkLibraryTables (dai, buckets, numOfFeatures);
+
+    printf ("%zu library tables, %zu features checked against the linear scan, %zu mismatches\n", dai.lookupTables.size (), numOfFeatures, numOfLibraryMismatches);
+
+    for (size_t i = 0, minSize = 1; i < buckets.size (); minSize = buckets [i ++].maxSize + 1) {
+        auto& bucket = buckets [i];
+
+        if (bucket.numOfFeatures == 0) continue;
+
+        std::string range = bucket.maxSize == SIZE_MAX ? std::to_string (minSize) + "+" : std::to_string (minSize) + "-" + std::to_string (bucket.maxSize);
+
+        printf (
+            "  tables of %-7s items: scan %6.0f ns/feature, matcher %6.0f ns/feature\n",
+            range.c_str (),
+            bucket.linearSeconds * 1.0e9 / bucket.numOfFeatures,
+            bucket.matcherSeconds * 1.0e9 / bucket.numOfFeatures
+        );
+    }
+
+    if (argc < 3) {
+        SyntheticCell cell;
+
+        cell.generateHarbour (GRID_SIZE, NUM_OF_POINTS);
+
+        if (!cell.save (path)) {
+            printf ("Unable to write %s\n", path); return 1;
+        }
+    }
+
+    MappedS57File s57File;
+    Chart chart;
+
+    if (!s57File.open (path)) {
+        printf ("Unable to open %s\n", path); return 1;
+    }
+
+    extractChart (s57File, chart);
+    deformatAttrValues (environment.attrDictionary, chart);
+
+    std::vector<LookupTableItem *> matched, scanned;
+    std::vector<LookupTableMatcher> matchers;
+    double matcherSeconds = timeResolving (chart, dai, matched);
+
+    // Without matchers findBestItem falls back to the scan
+    matchers.swap (dai.lookupTableMatchers);
+
+    double linearSeconds = timeResolving (chart, dai, scanned);
+
+    matchers.swap (dai.lookupTableMatchers);
+
+    bool same = matched == scanned;
+
+    printf (
+        "%s: %zu features resolved for both display variants; scan %.1f ms (%.0f ns/feature), matcher %.1f ms (%.0f ns/feature)%s\n",
+        path,
+        chart.features.size (),
+        linearSeconds * 1000.0,
+        linearSeconds * 1.0e9 / matched.size (),
+        matcherSeconds * 1000.0,
+        matcherSeconds * 1.0e9 / matched.size (),
+        same ? "" : " (results differ)"
+    );
+
+    return numOfMismatches == 0 && numOfLibraryMismatches == 0 && same ? 0 : 1;
+}
@@ -0,0 +1,510 @@
+#pragma once
+
+// Base cell generator for the benchmarks. Record layout and field formats follow real ENC cells: dataset records,
+// isolated nodes with a position or a sounding array, edges with node pointers and coordinates, and features with
+// attributes and edge pointers. Values are random, references point to existing records.
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../classes.h"
+
+struct SyntheticField {
+    const char *tag;
+    std::string data;
+};
+
+struct SyntheticAttr {
+    uint16_t code;
+    std::string value;
+};
+
+struct SyntheticCell {
+    static const char UT = 0x1F;
+    static const char FT = 0x1E;
+
+    std::mt19937 random;
+    std::string content;
+    uint32_t recordId;
+
+    SyntheticCell (uint32_t seed = 1): random (seed), recordId (0) {}
+
+    uint32_t uniform (uint32_t first, uint32_t last) {
+        return std::uniform_int_distribution<uint32_t> (first, last) (random);
+    }
+
+    static void put (std::string& data, uint64_t value, size_t numOfBytes) {
+        for (size_t i = 0; i < numOfBytes; ++ i, value >>= 8) data += (char) (value & 0xFF);
+    }
+
+    // Leader, directory (3 digit lengths, 4 digit positions) and field area
+    void addRecord (std::vector<SyntheticField>& fields, bool descriptive = false) {
+        std::string directory, area;
+        char buffer [32];
+
+        for (auto& field: fields) {
+            snprintf (buffer, sizeof (buffer), "%s%03zu%04zu", field.tag, field.data.size (), area.size ());
+            directory += buffer;
+            area += field.data;
+        }
+
+        directory += FT;
+
+        size_t base = 24 + directory.size ();
+
+        snprintf (buffer, sizeof (buffer), descriptive ? "%05zu3LE1 09%05zu ! 3404" : "%05zu D     %05zu   3404", base + area.size (), base);
+        content += buffer + directory + area;
+    }
+
+    void addDescriptiveRecord () {
+        static const char *definitions [][5] = {
+            { "0001", "0100;&   ", "ISO 8211 Record Identifier", "", "(b12)" },
+            { "DSID", "1600;&   ", "Data set identification field", "RCNM!RCID!EDTN!UPDN", "(b11,b14,2A)" },
+            { "DSPM", "1600;&   ", "Data set parameter field", "RCNM!RCID!COMF!SOMF", "(b11,b14,2b14)" },
+            { "VRID", "1600;&   ", "Vector record identifier field", "RCNM!RCID!RVER!RUIN", "(b11,b14,b12,b11)" },
+            { "ATTV", "2600;&   ", "Vector record attribute field", "*ATTL!ATVL", "(b12,A)" },
+            { "VRPT", "2600;&   ", "Vector record pointer field", "*NAME!ORNT!USAG!TOPI!MASK", "(B(40),4b11)" },
+            { "SG2D", "2500;&   ", "2-D coordinate field", "*YCOO!XCOO", "(2b24)" },
+            { "SG3D", "2500;&   ", "3-D coordinate (sounding array) field", "*YCOO!XCOO!VE3D", "(3b24)" },
+            { "FRID", "1600;&   ", "Feature record identifier field", "RCNM!RCID!PRIM!GRUP!OBJL!RVER!RUIN", "(b11,b14,2b11,2b12,b11)" },
+            { "FOID", "1600;&   ", "Feature object identifier field", "AGEN!FIDN!FIDS", "(b12,b14,b12)" },
+            { "ATTF", "2600;&   ", "Feature record attribute field", "*ATTL!ATVL", "(b12,A)" },
+            { "FSPT", "2600;&   ", "Feature record to spatial record pointer field", "*NAME!ORNT!USAG!MASK", "(B(40),3b11)" },
+        };
+        std::vector<SyntheticField> fields;
+
+        fields.push_back ({ "0000", std::string ("0000;&   S57 cell") + UT + "0001DSID0001DSPM0001VRID0001FRIDVRIDATTVVRIDVRPTVRIDSG2DVRIDSG3DFRIDFOIDFRIDATTFFRIDFSPT" + FT });
+
+        for (auto& definition: definitions) {
+            fields.push_back ({ definition [0], std::string (definition [1]) + definition [2] + UT + definition [3] + UT + definition [4] + FT });
+        }
+
+        addRecord (fields, true);
+    }
+
+    std::string recordIdField () {
+        std::string data;
+
+        put (data, ++ recordId, 2);
+
+        return data + FT;
+    }
+
+    static void putPosition (std::string& data, int32_t lat, int32_t lon) {
+        put (data, (uint32_t) lat, 4);
+        put (data, (uint32_t) lon, 4);
+    }
+
+    void addCoords (std::string& data, size_t numOfPoints, bool withDepth) {
+        for (size_t i = 0; i < numOfPoints; ++ i) {
+            put (data, uniform (0, 1800000000) - 900000000u, 4);
+            put (data, uniform (0, 3600000000u) - 1800000000u, 4);
+
+            if (withDepth) put (data, uniform (0, 9999), 4);
+        }
+
+        data += FT;
+    }
+
+    static std::string attrField (const std::vector<SyntheticAttr>& attrs) {
+        std::string data;
+
+        for (auto& attr: attrs) {
+            put (data, attr.code, 2);
+            data += attr.value + UT;
+        }
+
+        return data + FT;
+    }
+
+    // FSPT instance: NAME, ORNT, USAG, MASK (2 - show)
+    static void addSpatialPointer (std::string& data, uint8_t recName, uint32_t id, uint8_t orient = 1, uint8_t usage = 1) {
+        put (data, recName, 1);
+        put (data, id, 4);
+        data += { (char) orient, (char) usage, (char) 2 };
+    }
+
+    // COMF 10^7 and SOMF 10 as in most ENCs
+    void addDatasetRecords () {
+        std::vector<SyntheticField> fields = { { "0001", recordIdField () }, { "DSID", "" } };
+
+        put (fields [1].data, 10, 1);
+        put (fields [1].data, 1, 4);
+        fields [1].data += std::string ("2") + UT + "0" + UT + FT;
+        addRecord (fields);
+
+        fields = { { "0001", recordIdField () }, { "DSPM", "" } };
+        put (fields [1].data, 20, 1);
+        put (fields [1].data, 1, 4);
+        put (fields [1].data, 10000000, 4);
+        put (fields [1].data, 10, 4);
+        fields [1].data += FT;
+        addRecord (fields);
+    }
+
+    // Isolated (110) or connected (120) node, coords closed by FT
+    void addNode (uint8_t recName, uint32_t id, const std::vector<SyntheticAttr>& attrs, const std::string& coords, bool sounding) {
+        std::vector<SyntheticField> fields = { { "0001", recordIdField () }, { "VRID", "" } };
+
+        put (fields [1].data, recName, 1);
+        put (fields [1].data, id, 4);
+        put (fields [1].data, 1, 2);
+        put (fields [1].data, 1, 1);
+        fields [1].data += FT;
+
+        if (!attrs.empty ()) fields.push_back ({ "ATTV", attrField (attrs) });
+
+        fields.push_back ({ sounding ? "SG3D" : "SG2D", coords });
+        addRecord (fields);
+    }
+
+    // Edge between two connected nodes, coords of the internal points closed by FT
+    void addEdge (uint32_t id, uint32_t beginNode, uint32_t endNode, const std::vector<SyntheticAttr>& attrs, const std::string& coords) {
+        std::vector<SyntheticField> fields = { { "0001", recordIdField () }, { "VRID", "" } };
+        std::string pointers;
+
+        put (fields [1].data, 130, 1);
+        put (fields [1].data, id, 4);
+        put (fields [1].data, 1, 2);
+        put (fields [1].data, 1, 1);
+        fields [1].data += FT;
+
+        if (!attrs.empty ()) fields.push_back ({ "ATTV", attrField (attrs) });
+
+        for (int topology = 1; topology <= 2; ++ topology) {
+            put (pointers, 120, 1);
+            put (pointers, topology == 1 ? beginNode : endNode, 4);
+            pointers += { (char) 255, (char) 255, (char) topology, (char) 255 };
+        }
+
+        fields.push_back ({ "VRPT", pointers + FT });
+        fields.push_back ({ "SG2D", coords });
+        addRecord (fields);
+    }
+
+    // Spatial pointers are FSPT instances without the closing FT
+    void addFeature (uint32_t id, uint8_t primitive, uint8_t group, uint16_t classCode, const std::vector<SyntheticAttr>& attrs, const std::string& pointers) {
+        std::vector<SyntheticField> fields = { { "0001", recordIdField () }, { "FRID", "" }, { "FOID", "" }, { "ATTF", attrField (attrs) }, { "FSPT", pointers + FT } };
+
+        put (fields [1].data, 100, 1);
+        put (fields [1].data, id, 4);
+        put (fields [1].data, primitive, 1);
+        put (fields [1].data, group, 1);
+        put (fields [1].data, classCode, 2);
+        put (fields [1].data, 1, 2);
+        put (fields [1].data, 1, 1);
+        fields [1].data += FT;
+        put (fields [2].data, 550, 2);
+        put (fields [2].data, id, 4);
+        put (fields [2].data, 1, 2);
+        fields [2].data += FT;
+        addRecord (fields);
+    }
+
+    // Random records of the real layouts: class codes, attribute codes and references are arbitrary
+    void generate (size_t numOfEdges) {
+        size_t numOfNodes = numOfEdges / 4 + 1;
+
+        content.clear ();
+        recordId = 0;
+
+        addDescriptiveRecord ();
+        addDatasetRecords ();
+
+        for (size_t i = 0; i < numOfNodes; ++ i) {
+            bool sounding = i % 2 == 1;
+            std::string coords;
+
+            addCoords (coords, sounding ? uniform (1, 40) : 1, sounding);
+            addNode (110, (uint32_t) i + 1, { { 5, "x" } }, coords, sounding);
+        }
+
+        for (size_t i = 0; i < numOfEdges; ++ i) {
+            uint32_t beginNode = uniform (1, (uint32_t) numOfNodes);
+            uint32_t endNode = uniform (1, (uint32_t) numOfNodes);
+            std::string coords;
+
+            addCoords (coords, uniform (2, 60), false);
+            addEdge ((uint32_t) i + 1, beginNode, endNode, {}, coords);
+        }
+
+        for (size_t i = 0; i < numOfEdges; ++ i) {
+            uint16_t classCode = (uint16_t) uniform (1, 300);
+            std::vector<SyntheticAttr> attrs;
+            std::string pointers;
+
+            for (uint32_t j = uniform (2, 8); j > 0; -- j) {
+                uint16_t code = (uint16_t) uniform (1, 190);
+
+                attrs.push_back ({ code, std::to_string (uniform (0, 999)) });
+            }
+
+            for (uint32_t j = uniform (1, 6); j > 0; -- j) addSpatialPointer (pointers, 130, uniform (1, (uint32_t) numOfEdges));
+
+            addFeature ((uint32_t) i + 1, 2, 2, classCode, attrs, pointers);
+        }
+    }
+
+    // Harbour approach of about 11 x 11 km: a grid of depth areas (the first row is land) whose cell borders are
+    // shared edges carrying depth contours, coastline and piers, with restricted areas laid over some cells, and
+    // point features scattered over the water: soundings, lights (some sharing a node, with sectors), wrecks,
+    // obstructions, rocks, lateral buoys with topmarks. Attribute sets follow what ENCs of harbours carry, including
+    // the names, sources and scale minimums no CSP asks for.
+    void generateHarbour (size_t gridSize, size_t numOfPoints) {
+        static const int32_t SOUTH = 599000000, WEST = 106000000, LAT_SPAN = 1000000, LON_SPAN = 2000000;
+        static const uint32_t DEPTHS [] = { 0, 2, 5, 10, 15, 20, 30, 50, 100 };
+        static const size_t NUM_OF_DEPTHS = sizeof (DEPTHS) / sizeof (*DEPTHS) - 1;
+        static const uint16_t OBJNAM = 116, NOBJNM = 301, INFORM = 102, SCAMIN = 133, SORDAT = 147, SORIND = 148;
+        static const uint16_t BOYSHP = 4, CATLAM = 36, COLPAT = 76, RESARE = 112, TOPMAR = 144;
+        uint32_t numOfCorners = (uint32_t) ((gridSize + 1) * (gridSize + 1));
+        uint32_t numOfHorEdges = (uint32_t) ((gridSize + 1) * gridSize);
+        uint32_t featureId = 0;
+
+        content.clear ();
+        recordId = 0;
+
+        auto cornerId = [gridSize] (size_t row, size_t col) { return (uint32_t) (row * (gridSize + 1) + col + 1); };
+        auto horEdgeId = [gridSize] (size_t row, size_t col) { return (uint32_t) (row * gridSize + col + 1); };
+        auto verEdgeId = [gridSize, numOfHorEdges] (size_t row, size_t col) { return numOfHorEdges + (uint32_t) (row * (gridSize + 1) + col + 1); };
+        auto cornerLat = [gridSize] (size_t row) { return SOUTH + LAT_SPAN - (int32_t) (row * LAT_SPAN / gridSize); };
+        auto cornerLon = [gridSize] (size_t col) { return WEST + (int32_t) (col * LON_SPAN / gridSize); };
+        auto depthBand = [gridSize] (size_t row) { return row == 0 ? 0 : (row - 1) * NUM_OF_DEPTHS / gridSize; };
+        auto number = [this] (uint32_t first, uint32_t last) { return std::to_string (uniform (first, last)); };
+        auto addCommonAttrs = [&] (std::vector<SyntheticAttr>& attrs) {
+            if (uniform (0, 2) == 0) attrs.push_back ({ OBJNAM, "Harbour " + number (1, 9999) });
+            if (uniform (0, 4) == 0) attrs.push_back ({ NOBJNM, "Havn " + number (1, 9999) });
+            if (uniform (0, 3) == 0) attrs.push_back ({ INFORM, "Surveyed by multibeam echo sounder" });
+            attrs.push_back ({ SCAMIN, uniform (0, 1) ? "22000" : "45000" });
+            attrs.push_back ({ SORDAT, "20" + number (10, 24) + "0" + number (1, 9) + "15" });
+            attrs.push_back ({ SORIND, "NO,NO,graph,Harbour survey " + number (1, 99) });
+        };
+
+        addDescriptiveRecord ();
+        addDatasetRecords ();
+
+        // Point nodes are placed first, points sharing a node (sector lights, buoy and topmark) reuse the last one
+        struct PointFeature {
+            uint16_t classCode;
+            uint32_t nodeId;
+            std::vector<SyntheticAttr> attrs;
+        };
+        std::vector<PointFeature> points;
+        uint32_t nodeId = 0;
+
+        for (size_t i = 0; i < numOfPoints; ++ i) {
+            uint32_t kind = uniform (0, 99);
+            bool sharesNode = !points.empty () && (
+                (kind < 8 && points.back ().classCode == LIGHTS) ||
+                (kind >= 90 && points.back ().classCode == BOYLAT)
+            );
+
+            if (!sharesNode) {
+                size_t row = uniform (1, (uint32_t) gridSize - 1);
+                int32_t lat = cornerLat (row) - (int32_t) uniform (0, LAT_SPAN / (uint32_t) gridSize);
+                int32_t lon = WEST + (int32_t) uniform (0, LON_SPAN);
+                bool sounding = kind >= 8 && kind < 43;
+                std::string coords;
+
+                if (sounding) {
+                    for (uint32_t j = uniform (5, 30); j > 0; -- j) {
+                        putPosition (coords, lat + (int32_t) uniform (0, 2000) - 1000, lon + (int32_t) uniform (0, 4000) - 2000);
+                        put (coords, uniform (DEPTHS [depthBand (row)] * 10, DEPTHS [depthBand (row) + 1] * 10), 4);
+                    }
+                } else {
+                    putPosition (coords, lat, lon);
+                }
+
+                addNode (110, ++ nodeId, {}, coords + FT, sounding);
+            }
+
+            auto& point = points.emplace_back ();
+            auto& attrs = point.attrs;
+
+            point.nodeId = nodeId;
+
+            if (kind < 18) {
+                static const char *COLOURS [] = { "1", "3", "4", "1,3", "1,4" };
+
+                point.classCode = LIGHTS;
+                attrs.push_back ({ CATLIT, kind < 4 ? "1" : (kind < 8 ? "6" : "") });
+                attrs.push_back ({ COLOUR, COLOURS [uniform (0, 4)] });
+                attrs.push_back ({ LITCHR, number (1, 7) });
+                attrs.push_back ({ SIGGRP, "(" + number (1, 3) + ")" });
+                attrs.push_back ({ SIGPER, number (2, 10) });
+                attrs.push_back ({ HEIGHT, number (3, 40) });
+                attrs.push_back ({ VALNMR, number (2, 15) });
+
+                if (sharesNode || uniform (0, 2) == 0) {
+                    uint32_t start = uniform (0, 300);
+
+                    attrs.push_back ({ SECTR1, std::to_string (start) + ".0" });
+                    attrs.push_back ({ SECTR2, std::to_string (start + uniform (10, 60)) + ".0" });
+                }
+
+                if (kind < 4) attrs.push_back ({ ORIENT, number (0, 359) + ".5" });
+                if (uniform (0, 9) == 0) attrs.push_back ({ STATUS, "8" });
+            } else if (kind < 43) {
+                point.classCode = SOUNDG;
+
+                if (uniform (0, 3) == 0) attrs.push_back ({ TECSOU, number (1, 3) });
+                if (uniform (0, 5) == 0) attrs.push_back ({ QUASOU, number (1, 9) });
+            } else if (kind < 53) {
+                point.classCode = WRECKS;
+                attrs.push_back ({ CATWRK, number (1, 5) });
+                attrs.push_back ({ WATLEV, number (1, 5) });
+
+                if (uniform (0, 2) > 0) attrs.push_back ({ VALSOU, number (1, 30) + ".4" });
+                if (uniform (0, 3) == 0) attrs.push_back ({ EXPSOU, number (1, 3) });
+                if (uniform (0, 3) == 0) attrs.push_back ({ QUASOU, number (1, 9) });
+            } else if (kind < 65) {
+                point.classCode = OBSTRN;
+                attrs.push_back ({ CATOBS, number (1, 10) });
+                attrs.push_back ({ WATLEV, number (1, 7) });
+
+                if (uniform (0, 2) > 0) attrs.push_back ({ VALSOU, number (1, 20) + ".8" });
+                if (uniform (0, 3) == 0) attrs.push_back ({ EXPSOU, number (1, 3) });
+            } else if (kind < 75) {
+                point.classCode = UWTROC;
+                attrs.push_back ({ WATLEV, number (3, 5) });
+
+                if (uniform (0, 2) > 0) attrs.push_back ({ VALSOU, number (0, 9) + ".2" });
+            } else if (kind < 90 || !sharesNode) {
+                point.classCode = BOYLAT;
+                attrs.push_back ({ BOYSHP, number (1, 5) });
+                attrs.push_back ({ CATLAM, number (1, 2) });
+                attrs.push_back ({ COLOUR, uniform (0, 1) ? "3" : "4" });
+
+                if (uniform (0, 3) == 0) attrs.push_back ({ COLPAT, "1" });
+            } else {
+                point.classCode = TOPMAR;
+                attrs.push_back ({ TOPSHP, number (1, 33) });
+                attrs.push_back ({ COLOUR, uniform (0, 1) ? "3" : "4" });
+            }
+
+            addCommonAttrs (attrs);
+        }
+
+        for (size_t row = 0; row <= gridSize; ++ row) {
+            for (size_t col = 0; col <= gridSize; ++ col) {
+                std::string coords;
+
+                putPosition (coords, cornerLat (row), cornerLon (col));
+                addNode (120, cornerId (row, col), {}, coords + FT, false);
+            }
+        }
+
+        // Internal points wiggle across the straight cell border, both neighbours refer to the same edge anyway
+        auto addGridEdge = [&] (uint32_t id, size_t row, size_t col, size_t endRow, size_t endCol) {
+            std::vector<SyntheticAttr> attrs;
+            std::string coords;
+            uint32_t numOfInternal = uniform (0, 6);
+
+            for (uint32_t i = 1; i <= numOfInternal; ++ i) {
+                int32_t lat = cornerLat (row) + (cornerLat (endRow) - cornerLat (row)) * (int32_t) i / (int32_t) (numOfInternal + 1);
+                int32_t lon = cornerLon (col) + (cornerLon (endCol) - cornerLon (col)) * (int32_t) i / (int32_t) (numOfInternal + 1);
+
+                putPosition (coords, lat + (int32_t) uniform (0, 200) - 100, lon + (int32_t) uniform (0, 200) - 100);
+            }
+
+            if (uniform (0, 9) == 0) attrs.push_back ({ QUAPOS, number (1, 10) });
+
+            addEdge (id, cornerId (row, col), cornerId (endRow, endCol), attrs, coords + FT);
+        };
+
+        for (size_t row = 0; row <= gridSize; ++ row) {
+            for (size_t col = 0; col < gridSize; ++ col) addGridEdge (horEdgeId (row, col), row, col, row, col + 1);
+        }
+
+        for (size_t row = 0; row < gridSize; ++ row) {
+            for (size_t col = 0; col <= gridSize; ++ col) addGridEdge (verEdgeId (row, col), row, col, row + 1, col);
+        }
+
+        for (size_t row = 0; row < gridSize; ++ row) {
+            for (size_t col = 0; col < gridSize; ++ col) {
+                std::vector<SyntheticAttr> attrs;
+                std::string ring;
+
+                addSpatialPointer (ring, 130, horEdgeId (row, col), 1);
+                addSpatialPointer (ring, 130, verEdgeId (row, col + 1), 1);
+                addSpatialPointer (ring, 130, horEdgeId (row + 1, col), 2);
+                addSpatialPointer (ring, 130, verEdgeId (row, col), 2);
+
+                if (row == 0) {
+                    addCommonAttrs (attrs);
+                    addFeature (++ featureId, 3, 1, LNDARE, attrs, ring);
+                    continue;
+                }
+
+                size_t band = depthBand (row);
+
+                attrs.push_back ({ DRVAL1, std::to_string (DEPTHS [band]) });
+                attrs.push_back ({ DRVAL2, std::to_string (DEPTHS [band + 1]) });
+
+                if (uniform (0, 4) == 0) attrs.push_back ({ QUASOU, number (1, 9) });
+
+                addCommonAttrs (attrs);
+                addFeature (++ featureId, 3, 1, DEPARE, attrs, ring);
+
+                if (uniform (0, 6) == 0) {
+                    attrs.clear ();
+                    attrs.push_back ({ CATREA, uniform (0, 1) ? "4" : "1,9" });
+                    attrs.push_back ({ RESTRN, uniform (0, 1) ? "7" : "1,14" });
+                    addCommonAttrs (attrs);
+                    addFeature (++ featureId, 3, 2, RESARE, attrs, ring);
+                }
+            }
+        }
+
+        // Coastline along the land row, contours where the depth band changes, piers sticking out of the coast
+        for (size_t col = 0; col < gridSize; ++ col) {
+            std::vector<SyntheticAttr> attrs;
+            std::string pointers;
+
+            addSpatialPointer (pointers, 130, horEdgeId (1, col));
+            addCommonAttrs (attrs);
+            addFeature (++ featureId, 2, 2, COALNE, attrs, pointers);
+        }
+
+        for (size_t row = 2; row < gridSize; ++ row) {
+            if (depthBand (row) == depthBand (row - 1)) continue;
+
+            for (size_t col = 0; col < gridSize; ++ col) {
+                std::vector<SyntheticAttr> attrs = { { VALDCO, std::to_string (DEPTHS [depthBand (row)]) } };
+                std::string pointers;
+
+                addSpatialPointer (pointers, 130, horEdgeId (row, col));
+                addCommonAttrs (attrs);
+                addFeature (++ featureId, 2, 2, DEPCNT, attrs, pointers);
+            }
+        }
+
+        for (size_t col = 1; col < gridSize; col += 3) {
+            std::vector<SyntheticAttr> attrs = { { CATSLC, number (1, 10) }, { WATLEV, number (1, 4) } };
+            std::string pointers;
+
+            if (uniform (0, 3) == 0) attrs.push_back ({ CONDTN, number (1, 5) });
+
+            addSpatialPointer (pointers, 130, verEdgeId (1, col));
+            addCommonAttrs (attrs);
+            addFeature (++ featureId, 2, 2, SLCONS, attrs, pointers);
+        }
+
+        for (auto& point: points) {
+            std::string pointers;
+
+            addSpatialPointer (pointers, 110, point.nodeId, 255, 255);
+            addFeature (++ featureId, 1, 2, point.classCode, point.attrs, pointers);
+        }
+    }
+
+    bool save (const char *path) {
+        FILE *file = fopen (path, "wb");
+
+        if (!file) return false;
+
+        bool saved = fwrite (content.data (), 1, content.size (), file) == content.size ();
+
+        return fclose (file) == 0 && saved;
+    }
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+// Just enough of the Win32 API to build the parser and the chart structures outside Windows for the benchmarks.
+// Files are mapped with POSIX calls, drawing calls do nothing.
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
+#include <strings.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+typedef void *HANDLE;
+typedef HANDLE HPEN, HBRUSH, HDC, HWND, HBITMAP, HFONT, HGDIOBJ, HINSTANCE;
+typedef unsigned long DWORD;
+typedef int BOOL;
+typedef unsigned int UINT;
+typedef uint32_t COLORREF;
+typedef unsigned char BYTE;
+typedef unsigned short WORD;
+typedef long LONG;
+typedef void *LPVOID;
+typedef const char *LPCSTR;
+
+struct POINT { LONG x, y; };
+struct RECT { LONG left, top, right, bottom; };
+struct SIZE { LONG cx, cy; };
+union LARGE_INTEGER { struct { DWORD LowPart; LONG HighPart; }; long long QuadPart; };
+struct FILETIME { DWORD dwLowDateTime, dwHighDateTime; };
+struct LOGBRUSH { UINT lbStyle; COLORREF lbColor; uintptr_t lbHatch; };
+
+#define INVALID_HANDLE_VALUE ((HANDLE) (intptr_t) -1)
+#define GENERIC_READ 0x80000000
+#define GENERIC_WRITE 0x40000000
+#define FILE_SHARE_READ 1
+#define OPEN_EXISTING 3
+#define CREATE_ALWAYS 2
+#define FILE_ATTRIBUTE_NORMAL 0x80
+#define FILE_FLAG_SEQUENTIAL_SCAN 0x08000000
+#define PAGE_READONLY 2
+#define FILE_MAP_READ 4
+#define MOVEFILE_REPLACE_EXISTING 1
+#define PS_SOLID 0
+#define PS_DASH 1
+#define PS_DOT 2
+#define PS_NULL 5
+#define PS_GEOMETRIC 0x10000
+#define PS_USERSTYLE 7
+#define BS_SOLID 0
+#define LOGPIXELSX 88
+#define LOGPIXELSY 90
+#define HORZSIZE 4
+#define VERTSIZE 6
+#define HORZRES 8
+#define VERTRES 10
+#define RGB(r, g, b) ((COLORREF) (((BYTE) (r) | ((WORD) ((BYTE) (g)) << 8)) | (((DWORD) (BYTE) (b)) << 16)))
+#define GetRValue(c) ((BYTE) (c))
+#define GetGValue(c) ((BYTE) ((c) >> 8))
+#define GetBValue(c) ((BYTE) ((c) >> 16))
+#define DT_LEFT 0
+#define DT_TOP 0
+#define DT_CENTER 1
+#define DT_RIGHT 2
+#define DT_VCENTER 4
+#define DT_BOTTOM 8
+#define HWND_DESKTOP ((HWND) 0)
+#define WINAPI
+#define CALLBACK
+
+template<class A, class B> inline auto min (A a, B b) { return a < b ? a : (A) b; }
+template<class A, class B> inline auto max (A a, B b) { return a > b ? a : (A) b; }
+
+inline int _stricmp (const char *first, const char *second) { return strcasecmp (first, second); }
+
+// File handles are descriptors; the mapping handle is the file handle itself
+inline HANDLE CreateFileA (LPCSTR path, DWORD access, DWORD, void *, DWORD disposition, DWORD, HANDLE) {
+    int flags = (access & GENERIC_WRITE) ? (O_WRONLY | (disposition == CREATE_ALWAYS ? O_CREAT | O_TRUNC : 0)) : O_RDONLY;
+    int fd = open (path, flags, 0644);
+
+    return fd < 0 ? INVALID_HANDLE_VALUE : (HANDLE) (intptr_t) (fd + 1);
+}
+inline int toDescriptor (HANDLE handle) { return (int) (intptr_t) handle - 1; }
+inline BOOL GetFileSizeEx (HANDLE file, LARGE_INTEGER *size) {
+    struct stat info;
+
+    if (fstat (toDescriptor (file), & info) != 0) return 0;
+
+    size->QuadPart = info.st_size;
+
+    return 1;
+}
+inline BOOL GetFileTime (HANDLE file, FILETIME *, FILETIME *, FILETIME *lastWrite) {
+    struct stat info;
+
+    if (fstat (toDescriptor (file), & info) != 0) return 0;
+
+    lastWrite->dwLowDateTime = (DWORD) (uint32_t) info.st_mtime;
+    lastWrite->dwHighDateTime = (DWORD) (uint32_t) ((uint64_t) info.st_mtime >> 32);
+
+    return 1;
+}
+inline HANDLE CreateFileMappingA (HANDLE file, void *, DWORD, DWORD, DWORD, LPCSTR) {
+    return (HANDLE) (intptr_t) (dup (toDescriptor (file)) + 1);
+}
+// The view is not unmapped as its size is not known there; benchmarks map a few files only
+inline void *MapViewOfFile (HANDLE mapping, DWORD, DWORD, DWORD, size_t) {
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx (mapping, & size)) return 0;
+
+    void *view = mmap (0, (size_t) size.QuadPart, PROT_READ, MAP_PRIVATE, toDescriptor (mapping), 0);
+
+    return view == MAP_FAILED ? 0 : view;
+}
+inline BOOL UnmapViewOfFile (const void *) { return 1; }
+inline BOOL CloseHandle (HANDLE handle) { return close (toDescriptor (handle)) == 0; }
+inline BOOL WriteFile (HANDLE file, const void *data, DWORD size, DWORD *written, void *) {
+    ssize_t result = write (toDescriptor (file), data, size);
+
+    if (written) *written = result < 0 ? 0 : (DWORD) result;
+
+    return result == (ssize_t) size;
+}
+inline BOOL DeleteFileA (LPCSTR path) { return unlink (path) == 0; }
+inline BOOL MoveFileExA (LPCSTR from, LPCSTR to, DWORD) { return rename (from, to) == 0; }
+inline DWORD GetCurrentThreadId () { return 1; }
+inline DWORD GetCurrentProcessId () { return (DWORD) getpid (); }
+
+inline HDC GetDC (HWND) { return 0; }
+inline int ReleaseDC (HWND, HDC) { return 1; }
+inline int GetDeviceCaps (HDC, int) { return 96; }
+inline BOOL DeleteObject (HGDIOBJ) { return 1; }
+inline HPEN CreatePen (int, int, COLORREF) { return 0; }
+inline HPEN ExtCreatePen (DWORD, DWORD, const LOGBRUSH *, DWORD, const DWORD *) { return 0; }
+inline HBRUSH CreateSolidBrush (COLORREF) { return 0; }
+inline HGDIOBJ SelectObject (HDC, HGDIOBJ) { return 0; }
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <Windows.h>
+
+// Size and last write time identify the revision of a source file a cache was built from
+inline bool queryFileStamp (const char *path, uint64_t& size, uint64_t& modified) {
+    HANDLE file = CreateFileA (path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    LARGE_INTEGER fileSize;
+    FILETIME writeTime;
+
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    bool result = GetFileSizeEx (file, & fileSize) && GetFileTime (file, 0, 0, & writeTime);
+
+    CloseHandle (file);
+
+    size = (uint64_t) fileSize.QuadPart;
+    modified = (((uint64_t) writeTime.dwHighDateTime) << 32) + writeTime.dwLowDateTime;
+
+    return result;
+}
+
+// Collects a cache image in memory. It is written to a temporary file next to the cache which then replaces the cache
+// in one step, so neither a failed save nor a concurrent reader ever sees a partial file.
+struct CacheWriter {
+    std::string buffer;
+
+    template<typename T> void put (T value) {
+        buffer.append ((const char *) & value, sizeof (value));
+    }
+    void putBytes (const void *data, size_t size) {
+        put ((uint64_t) size);
+        buffer.append ((const char *) data, size);
+    }
+    void putString (const std::string& value) {
+        putBytes (value.data (), value.length ());
+    }
+    template<typename T> void putOptional (const std::optional<T>& value) {
+        put ((uint8_t) value.has_value ());
+        if (value.has_value ()) put (value.value ());
+    }
+    void putOptional (const std::optional<std::string>& value) {
+        put ((uint8_t) value.has_value ());
+        if (value.has_value ()) putString (value.value ());
+    }
+
+    bool save (const char *path) {
+        // Unique per thread since exchange set loaders may save caches of different cells side by side
+        std::string tempPath = std::string (path) + "." + std::to_string (GetCurrentProcessId ()) + "." + std::to_string (GetCurrentThreadId ()) + ".tmp";
+        HANDLE file = CreateFileA (tempPath.c_str (), GENERIC_WRITE, 0, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+        DWORD bytesWritten = 0;
+
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        bool result = WriteFile (file, buffer.data (), (DWORD) buffer.size (), & bytesWritten, 0) && bytesWritten == buffer.size ();
+
+        CloseHandle (file);
+
+        // Fails while the old cache is still mapped by someone; the old one stays then and is replaced next time
+        result = result && MoveFileExA (tempPath.c_str (), path, MOVEFILE_REPLACE_EXISTING);
+
+        if (!result) DeleteFileA (tempPath.c_str ());
+
+        return result;
+    }
+};
+
+// Reads straight from the mapped cache file; any overrun marks the whole cache invalid
+struct CacheReader {
+    const char *pos;
+    const char *end;
+    bool valid;
+
+    CacheReader (const char *begin, const char *_end): pos (begin), end (_end), valid (true) {}
+
+    const char *take (size_t size) {
+        if (!valid || (size_t) (end - pos) < size) {
+            valid = false; return 0;
+        }
+
+        const char *result = pos;
+
+        pos += size; return result;
+    }
+    template<typename T> T get () {
+        T value {};
+        const char *data = take (sizeof (T));
+
+        if (data) memcpy (& value, data, sizeof (T));
+
+        return value;
+    }
+    template<typename T> void get (T& value) {
+        value = get<T> ();
+    }
+    size_t getCount (size_t itemSize) {
+        uint64_t count = get<uint64_t> ();
+
+        // Every item takes at least itemSize bytes so the count can't exceed what is left
+        if (valid && count > (uint64_t) (end - pos) / itemSize) {
+            valid = false; return 0;
+        }
+
+        return (size_t) count;
+    }
+    void getString (std::string& value) {
+        size_t length = getCount (1);
+        const char *data = take (length);
+
+        if (data) value.assign (data, length); else value.clear ();
+    }
+    template<typename T> void getOptional (std::optional<T>& value) {
+        if (get<uint8_t> ()) value = get<T> (); else value.reset ();
+    }
+    void getOptional (std::optional<std::string>& value) {
+        if (get<uint8_t> ()) {
+            std::string string;
+            getString (string);
+            value = string;
+        } else {
+            value.reset ();
+        }
+    }
+};
@@ -0,0 +1,431 @@
+#include <cstdint>
+#include <string>
+#include <Windows.h>
+#include "chart_cache.h"
+#include "mapped_file.h"
+#include "cache_io.h"
+
+static const char CHART_CACHE_MAGIC [] = { 'S', '5', '7', 'C' };
+
+struct ChartCacheKey {
+    uint64_t size;
+    uint64_t modified;
+    std::string path;
+    std::string crc;
+
+    bool query (const char *_path, const char *_crc) {
+        path = _path;
+        crc = _crc ? _crc : "";
+
+        return queryFileStamp (_path, size, modified);
+    }
+};
+
+struct ChartCacheWriter: CacheWriter {
+    template<typename T> void putPositions (std::vector<T>& positions) {
+        putBytes (positions.data (), positions.size () * sizeof (T));
+    }
+    void putSpan (PositionSpan& span) {
+        put (span.offset);
+        put (span.count);
+    }
+    void putTopology (TopologyObject& object) {
+        put (object.id);
+        put (object.recordName);
+        put (object.flags);
+        put (object.updateInstruction);
+        put (object.version);
+    }
+    void putAttributes (std::vector<Attr>& attributes) {
+        put ((uint64_t) attributes.size ());
+
+        for (auto& attr: attributes) {
+            put (attr.classCode);
+            put (attr.domain);
+            put ((uint8_t) attr.noValue);
+            putBytes (attr.strValue (), attr.strLength ());
+
+            if (attr.domain == 'L') {
+                auto list = attr.listValue ();
+                putBytes (list.data, list.size ());
+            } else {
+                put (attr.value.floatValue);
+            }
+        }
+    }
+    void putUnderlyingObjects (UnderlyingObjectsList& list) {
+        put ((uint64_t) list.size ());
+
+        for (auto& [fidn, spatials]: list) {
+            put (fidn);
+            put ((uint64_t) spatials.size ());
+
+            for (auto& spatial: spatials) {
+                put ((uint64_t) spatial.areaIndex);
+                put (spatial.fidn);
+                put (spatial.classCode);
+                putOptional (spatial.depthRangeValue1);
+                putOptional (spatial.depthRangeValue2);
+            }
+        }
+    }
+};
+
+struct ChartCacheReader: CacheReader {
+    ChartCacheReader (const char *begin, const char *_end): CacheReader (begin, _end) {}
+
+    template<typename T> void getPositions (std::vector<T>& positions) {
+        size_t size = getCount (1);
+        const char *data = take (size);
+
+        if (!data || size % sizeof (T)) {
+            valid = false; return;
+        }
+
+        positions.resize (size / sizeof (T));
+        memcpy (positions.data (), data, size);
+    }
+    void getSpan (PositionSpan& span, size_t poolSize) {
+        get (span.offset);
+        get (span.count);
+
+        if ((uint64_t) span.offset + span.count > poolSize) valid = false;
+    }
+    // Index into a container of the chart, optional ones may be unset. A damaged or stale cache must not point outside
+    size_t getIndex (size_t limit, bool optional) {
+        uint64_t index = get<uint64_t> ();
+
+        if (index >= limit && !(optional && index == (uint64_t) LookupTableItem::NOT_EXIST)) valid = false;
+
+        return (size_t) index;
+    }
+    void getTopology (TopologyObject& object) {
+        get (object.id);
+        get (object.recordName);
+        get (object.flags);
+        get (object.updateInstruction);
+        get (object.version);
+    }
+    // Texts and long lists are copied into the chart string pool
+    void getAttributes (std::vector<Attr>& attributes, StringPool& pool) {
+        attributes.resize (getCount (1));
+
+        for (auto& attr: attributes) {
+            get (attr.classCode);
+            get (attr.domain);
+            attr.noValue = get<uint8_t> () != 0;
+
+            size_t textLength = getCount (1);
+            const char *text = take (textLength);
+
+            if (text) attr.setText (pool, text, textLength);
+
+            if (attr.domain == 'L') {
+                size_t listSize = getCount (1);
+                const char *list = take (listSize);
+
+                if (list) attr.setList (pool, (const uint8_t *) list, listSize);
+            } else {
+                get (attr.value.floatValue);
+            }
+        }
+    }
+    void getUnderlyingObjects (UnderlyingObjectsList& list, size_t numOfFeatures) {
+        list.clear ();
+
+        for (size_t i = 0, count = getCount (1); valid && i < count; ++ i) {
+            uint32_t fidn = get<uint32_t> ();
+            auto& spatials = list.emplace (fidn, SpatialsUnderObject ()).first->second;
+
+            spatials.resize (getCount (1));
+
+            for (auto& spatial: spatials) {
+                spatial.areaIndex = getIndex (numOfFeatures, true);
+                get (spatial.fidn);
+                get (spatial.classCode);
+                getOptional (spatial.depthRangeValue1);
+                getOptional (spatial.depthRangeValue2);
+            }
+        }
+    }
+};
+
+static std::string getCachePath (const char *path) {
+    return std::string (path) + ".cache";
+}
+
+bool saveChartCache (const char *path, const char *crc, Chart& chart) {
+    ChartCacheKey key;
+    ChartCacheWriter writer;
+
+    if (!key.query (path, crc)) return false;
+
+    writer.buffer.append (CHART_CACHE_MAGIC, sizeof (CHART_CACHE_MAGIC));
+    writer.put (CHART_CACHE_VERSION);
+    writer.put (key.size);
+    writer.put (key.modified);
+    writer.putString (key.path);
+    writer.putString (key.crc);
+
+    auto& params = chart.params;
+
+    writer.putOptional (params.coordMultiplier);
+    writer.putOptional (params.soundingMultiplier);
+    writer.putOptional (params.comment);
+    writer.putOptional (params.coordUnit);
+    writer.putOptional (params.compilationScale);
+    writer.putOptional (params.depthMeasurement);
+    writer.putOptional (params.heightMeasurement);
+    writer.putOptional (params.posMeasurement);
+    writer.putOptional (params.horDatum);
+    writer.putOptional (params.soundingDatum);
+    writer.putOptional (params.verDatum);
+    writer.putOptional (params.edition);
+    writer.putOptional (params.updateNumber);
+
+    writer.put ((uint8_t) chart.coords.fixedPoint);
+    writer.put ((uint32_t) chart.coords.coordMultiplier);
+
+    if (chart.coords.fixedPoint) {
+        writer.putPositions (chart.coords.fixedPositions);
+    } else {
+        writer.putPositions (chart.coords.positions);
+    }
+    writer.put ((uint64_t) chart.nodes.size ());
+
+    for (auto& node: chart.nodes) {
+        writer.putTopology (node);
+        writer.putSpan (node.points);
+    }
+
+    writer.put ((uint64_t) chart.edges.size ());
+
+    for (auto& edge: chart.edges) {
+        writer.putTopology (edge);
+        writer.put (edge.orientation);
+        writer.put ((uint64_t) edge.beginIndex);
+        writer.put ((uint64_t) edge.endIndex);
+        writer.putSpan (edge.internalNodes);
+        writer.put ((uint8_t) edge.hidden);
+        writer.put ((uint8_t) edge.hole);
+        writer.putAttributes (edge.attributes);
+    }
+
+    writer.put ((uint64_t) chart.features.size ());
+
+    for (auto& feature: chart.features) {
+        writer.putTopology (feature);
+        writer.put (feature.primitive);
+        writer.put (feature.group);
+        writer.put (feature.classCode);
+        writer.put (feature.agency);
+        writer.put (feature.fidn);
+        writer.put (feature.subDiv);
+        writer.put ((uint64_t) feature.nodeIndex);
+        writer.putAttributes (feature.attributes);
+        writer.put ((uint64_t) feature.edgeRefs.size ());
+
+        // Presentation part of the edge refs is filled by CSPs at render time, only topology is persistent
+        for (auto& edgeRef: feature.edgeRefs) {
+            writer.put ((uint64_t) edgeRef.index);
+            writer.put ((uint8_t) edgeRef.hidden);
+            writer.put ((uint8_t) edgeRef.hole);
+            writer.put ((uint8_t) edgeRef.unclockwise);
+        }
+    }
+
+    writer.put ((uint64_t) chart.areaTopologyMap.size ());
+
+    for (auto& [fidn, topology]: chart.areaTopologyMap) {
+        writer.put (fidn);
+        writer.put (topology.northmost);
+        writer.put (topology.southmost);
+        writer.put (topology.westmost);
+        writer.put (topology.eastmost);
+        writer.put ((uint64_t) topology.metrics.size ());
+
+        for (auto& contour: topology.metrics) {
+            writer.put ((uint64_t) contour.size ());
+
+            for (auto& vertex: contour) {
+                writer.put (vertex.lat);
+                writer.put (vertex.lon);
+            }
+        }
+
+        writer.put (topology.coordMultiplier);
+        writer.put ((uint64_t) topology.fixedMetrics.size ());
+
+        for (auto& contour: topology.fixedMetrics) {
+            writer.put ((uint64_t) contour.size ());
+
+            for (auto& vertex: contour) {
+                writer.put (vertex.lat);
+                writer.put (vertex.lon);
+            }
+        }
+    }
+
+    writer.putUnderlyingObjects (chart.objectsUnderPoints);
+    writer.putUnderlyingObjects (chart.objectsUnderSpatials);
+
+    return writer.save (getCachePath (path).c_str ());
+}
+
+bool loadChartCache (const char *path, const char *crc, Chart& chart) {
+    ChartCacheKey key;
+    MappedFile cache;
+
+    if (!key.query (path, crc) || !cache.open (getCachePath (path).c_str ())) return false;
+
+    ChartCacheReader reader (cache.begin (), cache.end ());
+    const char *magic = reader.take (sizeof (CHART_CACHE_MAGIC));
+    std::string cachedPath, cachedCrc;
+
+    if (!magic || memcmp (magic, CHART_CACHE_MAGIC, sizeof (CHART_CACHE_MAGIC)) != 0) return false;
+    if (reader.get<uint32_t> () != CHART_CACHE_VERSION) return false;
+    if (reader.get<uint64_t> () != key.size || reader.get<uint64_t> () != key.modified) return false;
+
+    reader.getString (cachedPath);
+    reader.getString (cachedCrc);
+
+    // Cells opened without the catalog have no CRC, the file stamp alone decides then
+    if (!reader.valid || _stricmp (cachedPath.c_str (), key.path.c_str ()) != 0) return false;
+    if (!cachedCrc.empty () && !key.crc.empty () && cachedCrc != key.crc) return false;
+
+    auto& params = chart.params;
+
+    reader.getOptional (params.coordMultiplier);
+    reader.getOptional (params.soundingMultiplier);
+    reader.getOptional (params.comment);
+    reader.getOptional (params.coordUnit);
+    reader.getOptional (params.compilationScale);
+    reader.getOptional (params.depthMeasurement);
+    reader.getOptional (params.heightMeasurement);
+    reader.getOptional (params.posMeasurement);
+    reader.getOptional (params.horDatum);
+    reader.getOptional (params.soundingDatum);
+    reader.getOptional (params.verDatum);
+    reader.getOptional (params.edition);
+    reader.getOptional (params.updateNumber);
+
+    bool fixedPoint = reader.get<uint8_t> () != 0;
+
+    chart.coords.setCoordMultiplier (reader.get<uint32_t> ());
+
+    // The snapshot was taken with the other storage mode, rebuild the chart from the cell instead
+    if (chart.coords.fixedPoint != fixedPoint) {
+        reader.valid = false;
+    } else if (fixedPoint) {
+        reader.getPositions (chart.coords.fixedPositions);
+    } else {
+        reader.getPositions (chart.coords.positions);
+    }
+
+    size_t poolSize = chart.coords.size ();
+
+    chart.nodes.container.resize (reader.getCount (1));
+
+    for (auto& node: chart.nodes) {
+        reader.getTopology (node);
+        reader.getSpan (node.points, poolSize);
+    }
+
+    chart.edges.container.resize (reader.getCount (1));
+
+    for (auto& edge: chart.edges) {
+        reader.getTopology (edge);
+        reader.get (edge.orientation);
+        edge.beginIndex = reader.getIndex (chart.nodes.size (), true);
+        edge.endIndex = reader.getIndex (chart.nodes.size (), true);
+        reader.getSpan (edge.internalNodes, poolSize);
+        edge.hidden = reader.get<uint8_t> () != 0;
+        edge.hole = reader.get<uint8_t> () != 0;
+        reader.getAttributes (edge.attributes, chart.strings);
+    }
+
+    chart.features.container.resize (reader.getCount (1));
+
+    for (auto& feature: chart.features) {
+        reader.getTopology (feature);
+        reader.get (feature.primitive);
+        reader.get (feature.group);
+        reader.get (feature.classCode);
+        reader.get (feature.agency);
+        reader.get (feature.fidn);
+        reader.get (feature.subDiv);
+        feature.nodeIndex = reader.getIndex (chart.nodes.size (), true);
+        reader.getAttributes (feature.attributes, chart.strings);
+        feature.buildAttrIndex ();
+        feature.edgeRefs.resize (reader.getCount (1));
+
+        for (auto& edgeRef: feature.edgeRefs) {
+            edgeRef.index = reader.getIndex (chart.edges.size (), false);
+            edgeRef.hidden = reader.get<uint8_t> () != 0;
+            edgeRef.hole = reader.get<uint8_t> () != 0;
+            edgeRef.unclockwise = reader.get<uint8_t> () != 0;
+        }
+    }
+
+    for (size_t i = 0, count = reader.getCount (1); reader.valid && i < count; ++ i) {
+        uint32_t fidn = reader.get<uint32_t> ();
+        auto& topology = chart.areaTopologyMap.emplace (fidn, AreaTopology ()).first->second;
+
+        reader.get (topology.northmost);
+        reader.get (topology.southmost);
+        reader.get (topology.westmost);
+        reader.get (topology.eastmost);
+        topology.metrics.resize (reader.getCount (1));
+
+        for (auto& contour: topology.metrics) {
+            size_t numOfVertices = reader.getCount (sizeof (double) * 2);
+
+            contour.reserve (numOfVertices);
+
+            for (size_t j = 0; j < numOfVertices; ++ j) {
+                double lat = reader.get<double> ();
+                double lon = reader.get<double> ();
+
+                contour.emplace_back (lat, lon);
+            }
+        }
+
+        reader.get (topology.coordMultiplier);
+        topology.fixedMetrics.resize (reader.getCount (1));
+
+        for (auto& contour: topology.fixedMetrics) {
+            size_t numOfVertices = reader.getCount (sizeof (int32_t) * 2);
+
+            contour.reserve (numOfVertices);
+
+            for (size_t j = 0; j < numOfVertices; ++ j) {
+                int32_t lat = reader.get<int32_t> ();
+                int32_t lon = reader.get<int32_t> ();
+
+                contour.emplace_back (lat, lon);
+            }
+        }
+    }
+
+    reader.getUnderlyingObjects (chart.objectsUnderPoints, chart.features.size ());
+    reader.getUnderlyingObjects (chart.objectsUnderSpatials, chart.features.size ());
+
+    if (!reader.valid) {
+        chart.nodes.clear ();
+        chart.edges.clear ();
+        chart.features.clear ();
+        chart.areaTopologyMap.clear ();
+        chart.objectsUnderPoints.clear ();
+        chart.objectsUnderSpatials.clear ();
+        chart.strings.clear ();
+        chart.coords.clear ();
+        chart.params = DatasetParams ();
+        return false;
+    }
+
+    chart.nodes.buildIndex ();
+    chart.edges.buildIndex ();
+    chart.features.buildIndex ();
+
+    return true;
+}
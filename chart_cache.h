@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+#include "data.h"
+
+// Binary snapshot of a fully built chart stored next to the cell as <path>.cache.
+// The snapshot is keyed by the cell path, size, modification time and the catalog CRC, so any change invalidates it.
+static const uint32_t CHART_CACHE_VERSION = 5;
+
+bool loadChartCache (const char *path, const char *crc, Chart& chart);
+bool saveChartCache (const char *path, const char *crc, Chart& chart);
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstdint>
+
 struct ChartSettings {
     bool fullSectorLength, safetyContourLabels, twoShades, shallowPattern, showIsolatedDanger, showLowAccuracy, symbolizedBoundaries, displayContourLabels;
     bool showLightDescriptions;
     double safetyContour, shallowContour, deepContour, safetyDepth;
+    uint32_t generation;        // Bumped on every change, tells cached CSP results are stale
 
     ChartSettings ();
 };
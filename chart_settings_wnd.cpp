@@ -56,6 +56,8 @@ void saveSettings (HWND wnd) {
     getFloatValue (IDC_SHALLOW_CONTOUR, settings->shallowContour);
     getFloatValue (IDC_DEEP_CONTOUR, settings->deepContour);
     getFloatValue (IDC_SAFETY_DEPTH, settings->safetyDepth);
+
+    ++ settings->generation;
 }
 
 void doChartSettingsWndCommand (HWND wnd, uint16_t cmd) {
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <stdlib.h>
+#include <string.h>
+
+// CRC-32 (IEEE 802.3, the one used for CRCS of the exchange set catalog), slice-by-8: eight bytes per step
+// through eight 256-entry tables instead of one byte per step. Byte order assumes little-endian CPU.
+struct Crc32Table {
+    uint32_t slices [8][256];
+
+    Crc32Table () {
+        for (uint32_t i = 0; i < 256; ++ i) {
+            uint32_t crc = i;
+
+            for (int bit = 0; bit < 8; ++ bit) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+
+            slices [0][i] = crc;
+        }
+
+        for (uint32_t i = 0; i < 256; ++ i) {
+            for (int slice = 1; slice < 8; ++ slice) {
+                slices [slice][i] = (slices [slice - 1][i] >> 8) ^ slices [0][slices [slice - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+// Continues crc computed for the preceding data, start with 0
+inline uint32_t updateCrc32 (uint32_t crc, const void *data, size_t size) {
+    static const Crc32Table table;
+    const uint8_t *pos = (const uint8_t *) data;
+
+    crc = ~crc;
+
+    for (; size >= 8; size -= 8, pos += 8) {
+        uint32_t low, high;
+
+        memcpy (& low, pos, sizeof (low));
+        memcpy (& high, pos + 4, sizeof (high));
+
+        low ^= crc;
+
+        crc = table.slices [7][low & 0xFF] ^ table.slices [6][(low >> 8) & 0xFF] ^ table.slices [5][(low >> 16) & 0xFF] ^ table.slices [4][low >> 24] ^
+              table.slices [3][high & 0xFF] ^ table.slices [2][(high >> 8) & 0xFF] ^ table.slices [1][(high >> 16) & 0xFF] ^ table.slices [0][high >> 24];
+    }
+
+    for (; size > 0; -- size, ++ pos) crc = (crc >> 8) ^ table.slices [0][(crc ^ *pos) & 0xFF];
+
+    return ~crc;
+}
+
+inline uint32_t calcCrc32 (const void *data, size_t size) {
+    return updateCrc32 (0, data, size);
+}
+
+// CRCS holds the checksum as 8 hex digits
+inline bool parseCrcs (const char *crcs, uint32_t& crc) {
+    char *end;
+
+    if (!crcs || !*crcs) return false;
+
+    crc = (uint32_t) strtoul (crcs, & end, 16);
+
+    return *end == '\0' || *end == ' ';
+}
@@ -36,7 +36,7 @@ bool isFloating (FeatureObject& object) {
         case OBJ_CLASSES::MORFAC: {
             auto catmor = object.getAttr (ATTRS::CATMOR);
 
-            return catmor && !catmor->noValue && catmor->intValue == 7;
+            return catmor && !catmor->noValue && catmor->intValue () == 7;
         }
         default: {
             return false;
@@ -106,7 +106,7 @@ bool isEdgeSharedWithLinerStructure (FeatureObject *thisObject, size_t edgeIndex
 
     auto watlev = features [index].getAttr (ATTRS::WATLEV);
 
-    return watlev && (watlev->noValue || watlev->intValue == 1 || watlev->intValue == 2 || watlev->intValue == 6);
+    return watlev && (watlev->noValue || watlev->intValue () == 1 || watlev->intValue () == 2 || watlev->intValue () == 6);
 }
 
 void seabed01 (double depthRangeVal1, double depthRangeVal2, LookupTableItem *item, Environment& environment) {
@@ -233,8 +233,8 @@ void depare03 (LookupTableItem *item, FeatureObject *object, Environment& enviro
     Dai& dai = environment.dai;
     auto drval1 = object->getAttr (ATTRS::DRVAL1);
     auto drval2 = object->getAttr (ATTRS::DRVAL2);
-    double depthRangeVal1 = (drval1 && !drval1->noValue) ? drval1->floatValue : -1.0;
-    double depthRangeVal2 = (drval2 && !drval2->noValue) ? drval2->floatValue : (depthRangeVal1 + 0.01);
+    double depthRangeVal1 = (drval1 && !drval1->noValue) ? drval1->floatValue () : -1.0;
+    double depthRangeVal2 = (drval2 && !drval2->noValue) ? drval2->floatValue () : (depthRangeVal1 + 0.01);
 
     seabed01 (depthRangeVal1, depthRangeVal2, item, environment);
 
@@ -264,7 +264,7 @@ void depare03 (LookupTableItem *item, FeatureObject *object, Environment& enviro
             auto valdco = features [deepContourIndex].getAttr (ATTRS::VALDCO);
 
             if (valdco && !valdco->noValue) {
-                locValdco = valdco->floatValue;
+                locValdco = valdco->floatValue ();
             } else {
                 locValdco = 0.0;
             }
@@ -276,7 +276,7 @@ void depare03 (LookupTableItem *item, FeatureObject *object, Environment& enviro
 
             if (sharedWithDrgOrDepArea) {
                 auto locDrval1 = features [areaIndex].getAttr (ATTRS::DRVAL1);
-                double locDepthRangeValue = (locDrval1 && !locDrval1->noValue) ? locDrval1->floatValue : -1.0;
+                double locDepthRangeValue = (locDrval1 && !locDrval1->noValue) ? locDrval1->floatValue () : -1.0;
 
                 if (locDepthRangeValue < settings.safetyContour) {
                     unsafe = true;
@@ -310,20 +310,22 @@ void depare03 (LookupTableItem *item, FeatureObject *object, Environment& enviro
         // Edge customization
         item->customEdgePres = true;
 
-        edgeRef.customPres = true;
-        edgeRef.displayPriority = 8;
-        //edgeRef.radarPriority = 'O';
-        edgeRef.dispCat = DisplayCat::DISPLAY_BASE;
-        edgeRef.viewingGroup = 13010;
-        edgeRef.penIndex = dai.getPenIndex ("DEPSC");
-        edgeRef.penWidth = 2;
+        auto& pres = drawQueue.edgePresentations.get (edgeRef);
+
+        pres.customPres = true;
+        pres.displayPriority = 8;
+        //pres.radarPriority = 'O';
+        pres.dispCat = DisplayCat::DISPLAY_BASE;
+        pres.viewingGroup = 13010;
+        pres.penIndex = dai.getPenIndex ("DEPSC");
+        pres.penWidth = 2;
 
         auto locQuapos = object->getEdgeAttr (edgeRef, ATTRS::VALDCO, edges);
 
-        if (!locQuapos || locQuapos->noValue || locQuapos->intValue != 1 && locQuapos->intValue != 10 && locQuapos->intValue != 11) {
-            edgeRef.penStyle = PS_DASH;
+        if (!locQuapos || locQuapos->noValue || locQuapos->intValue () != 1 && locQuapos->intValue () != 10 && locQuapos->intValue () != 11) {
+            pres.penStyle = PS_DASH;
         } else {
-            edgeRef.penStyle = PS_SOLID;
+            pres.penStyle = PS_SOLID;
         }
 
         if (settings.safetyContourLabels && locValdco.has_value ()) {
@@ -331,7 +333,7 @@ void depare03 (LookupTableItem *item, FeatureObject *object, Environment& enviro
             safcon01 (object, locValdco.value (), symbols);
 
             for (auto& symbol: symbols) {
-                edgeRef.addSymbol (environment.dai.getSymbolIndex (symbol.c_str ()));
+                pres.addSymbol (environment.dai.getSymbolIndex (symbol.c_str ()));
             }
         }
     }
@@ -344,25 +346,26 @@ void depcnt03 (LookupTableItem *item, FeatureObject *object, Environment& enviro
 
     for (auto& edgeRef: object->edgeRefs) {
         auto quapos = object->getEdgeAttr (edgeRef, ATTRS::QUAPOS, chart.edges);
+        auto& pres = drawQueue.edgePresentations.get (edgeRef);
 
-        edgeRef.customPres = true;
-        edgeRef.penWidth = 1;
-        edgeRef.penIndex = dai.getBasePenIndex ("DEPCN");
-        edgeRef.penStyle = PS_SOLID;
+        pres.customPres = true;
+        pres.penWidth = 1;
+        pres.penIndex = dai.getBasePenIndex ("DEPCN");
+        pres.penStyle = PS_SOLID;
 
         if (quapos && !quapos->noValue) {
-            if (quapos->intValue != 1 && quapos->intValue != 10 && quapos->intValue != 11) {
-                edgeRef.penStyle = PS_DASH;
+            if (quapos->intValue () != 1 && quapos->intValue () != 10 && quapos->intValue () != 11) {
+                pres.penStyle = PS_DASH;
             }
         }
 
         if (environment.settings.displayContourLabels) {
             std::vector<std::string> symbols;
 
-            safcon01 (object, (valdco && !valdco->noValue) ? valdco->floatValue : 0.0, symbols);
+            safcon01 (object, (valdco && !valdco->noValue) ? valdco->floatValue () : 0.0, symbols);
 
             for (auto& symbol: symbols) {
-                edgeRef.addSymbol (environment.dai.getSymbolIndex (symbol.c_str ()));
+                pres.addSymbol (environment.dai.getSymbolIndex (symbol.c_str ()));
             }
         }
     }
@@ -397,7 +400,7 @@ void sndfrm04 (FeatureObject *object, double depth, Chart& chart, Environment& e
             auto& area = chart.features [objectsUnder->front ().areaIndex];
             auto quapos = area.getAttr (ATTRS::QUAPOS);
 
-            if (quapos && !quapos->noValue && quapos->intValue != 1 && quapos->intValue != 10 && quapos->intValue != 11) {
+            if (quapos && !quapos->noValue && quapos->intValue () != 1 && quapos->intValue () != 10 && quapos->intValue () != 11) {
                 symbols.emplace_back (prefix + "C2");
             }
         }
@@ -523,7 +526,7 @@ UdwhazResult udwhaz05 (
         if (danger) {
             auto watlev = object->getAttr (ATTRS::WATLEV);
 
-            if (watlev && !watlev->noValue && (watlev->intValue == 1 || watlev->intValue == 2)) {
+            if (watlev && !watlev->noValue && (watlev->intValue () == 1 || watlev->intValue () == 2)) {
                 return UdwhazResult (false, DisplayCat::DISPLAY_BASE, 8, 14050);
             } else {
                 return UdwhazResult (true, DisplayCat::DISPLAY_BASE, 8, 14010);
@@ -549,7 +552,7 @@ UdwhazResult udwhaz05 (
 
             auto watlev = object->getAttr (ATTRS::WATLEV);
 
-            if (watlev && !watlev->noValue && (watlev->intValue == 1 || watlev->intValue == 2)) {
+            if (watlev && !watlev->noValue && (watlev->intValue () == 1 || watlev->intValue () == 2)) {
                 return UdwhazResult (false, DisplayCat::DISPLAY_BASE, 8, 24050);
             } else {
                 return UdwhazResult (true, DisplayCat::DISPLAY_BASE, 8, 24020);
@@ -569,7 +572,7 @@ bool quapnt02 (FeatureObject *object, Chart& chart, Environment& environment) {
         for (auto& edgeRef: object->edgeRefs) {
             auto quapos = object->getEdgeAttr (edgeRef, ATTRS::QUAPOS, chart.edges);
 
-            if (quapos && !quapos->noValue && quapos->intValue >= 2 && quapos->intValue <= 9) {
+            if (quapos && !quapos->noValue && quapos->intValue () >= 2 && quapos->intValue () <= 9) {
                 accurate = false; break;
             }
         }
@@ -584,7 +587,7 @@ void wrecks05 (LookupTableItem *item, FeatureObject *object, Environment& enviro
     std::vector<std::string> symbols;
 
     if (valsou && !valsou->noValue) {
-        depth = valsou->floatValue;
+        depth = valsou->floatValue ();
         item->viewingGroup = 34051;
 
         sndfrm04 (object, depth, chart, environment, symbols);
@@ -593,13 +596,13 @@ void wrecks05 (LookupTableItem *item, FeatureObject *object, Environment& enviro
         auto expsou = object->getAttr (ATTRS::EXPSOU);
         auto catwrk = object->getAttr (ATTRS::CATWRK);
         std::optional<int> waterLevel, soundingExposition;
-        if (watlev && !watlev->noValue) waterLevel = watlev->intValue;
-        if (expsou && !expsou->noValue) soundingExposition = expsou->intValue;
+        if (watlev && !watlev->noValue) waterLevel = watlev->intValue ();
+        if (expsou && !expsou->noValue) soundingExposition = expsou->intValue ();
         auto [leastDepth, seabedDepth] = depval02 (object, chart, waterLevel, soundingExposition);
 
         if (!leastDepth.has_value ()) {
             if (catwrk && !catwrk->noValue) {
-                if (catwrk->intValue == 1) {
+                if (catwrk->intValue () == 1) {
                     depth = 20.1;
 
                     if (seabedDepth.has_value ()) {
@@ -612,7 +615,7 @@ void wrecks05 (LookupTableItem *item, FeatureObject *object, Environment& enviro
                     depth = -15.0;
                 }
             } else if (watlev && !watlev->noValue) {
-                if (watlev->intValue == 3 || watlev->intValue == 5) {
+                if (watlev->intValue () == 3 || watlev->intValue () == 5) {
                     depth = 0.0;
                 } else {
                     depth = -15.0;
@@ -632,7 +635,7 @@ void wrecks05 (LookupTableItem *item, FeatureObject *object, Environment& enviro
     if (viewingGroup.has_value ()) item->viewingGroup = viewingGroup.value ();
 
     if (object->primitive == 1) {
-        auto& pos = chart.nodes [object->nodeIndex].points.front ();
+        auto pos = chart.nodePosition (object->nodeIndex);
         if (isolatedDanger) {
             drawQueue.addSymbol (pos.lat, pos.lon, environment.dai.getSymbolIndex ("ISODGR01"), 0.0, environment.dai);
             if (lowAccuracy) {
@@ -641,7 +644,7 @@ void wrecks05 (LookupTableItem *item, FeatureObject *object, Environment& enviro
         } else {
             // cont A
             if (valsou && !valsou->noValue) {
-                if (valsou->floatValue <= environment.settings.safetyDepth) {
+                if (valsou->floatValue () <= environment.settings.safetyDepth) {
                     drawQueue.addSymbol (pos.lat, pos.lon, environment.dai.getSymbolIndex ("DANGER01"), 0.0, environment.dai);
                 } else {
                     drawQueue.addSymbol (pos.lat, pos.lon, environment.dai.getSymbolIndex ("DANGER02"), 0.0, environment.dai);
@@ -653,13 +656,13 @@ void wrecks05 (LookupTableItem *item, FeatureObject *object, Environment& enviro
                 item->displayPriority = 4;
                 item->displayCat = DisplayCat::CUSTOM;
                 item->viewingGroup = 34050;
-                if (catwrk && !catwrk->noValue && catwrk->intValue == 1 && watlev && !watlev->noValue && watlev->intValue == 3) {
+                if (catwrk && !catwrk->noValue && catwrk->intValue () == 1 && watlev && !watlev->noValue && watlev->intValue () == 3) {
                     drawQueue.addSymbol (pos.lat, pos.lon, environment.dai.getSymbolIndex ("WRECKS04"), 0.0, environment.dai);
-                } else if (catwrk && !catwrk->noValue && catwrk->intValue == 2 && watlev && !watlev->noValue && watlev->intValue == 3) {
+                } else if (catwrk && !catwrk->noValue && catwrk->intValue () == 2 && watlev && !watlev->noValue && watlev->intValue () == 3) {
                     drawQueue.addSymbol (pos.lat, pos.lon, environment.dai.getSymbolIndex ("WRECKS05"), 0.0, environment.dai);
-                } else if (catwrk && !catwrk->noValue && (catwrk->intValue == 4 || catwrk->intValue == 5)) {
+                } else if (catwrk && !catwrk->noValue && (catwrk->intValue () == 4 || catwrk->intValue () == 5)) {
                     drawQueue.addSymbol (pos.lat, pos.lon, environment.dai.getSymbolIndex ("WRECKS01"), 0.0, environment.dai);
-                } else if (watlev && !watlev->noValue && (watlev->intValue == 1 || watlev->intValue == 2 || watlev->intValue == 5 || watlev->intValue == 4)) {
+                } else if (watlev && !watlev->noValue && (watlev->intValue () == 1 || watlev->intValue () == 2 || watlev->intValue () == 5 || watlev->intValue () == 4)) {
                     drawQueue.addSymbol (pos.lat, pos.lon, environment.dai.getSymbolIndex ("WRECKS05"), 0.0, environment.dai);
                 } else {
                     drawQueue.addSymbol (pos.lat, pos.lon, environment.dai.getSymbolIndex ("WRECKS05"), 0.0, environment.dai);
@@ -676,47 +679,48 @@ void wrecks05 (LookupTableItem *item, FeatureObject *object, Environment& enviro
 
         for (auto& edgeRef: object->edgeRefs) {
             auto edgeQuapos = object->getEdgeAttr (edgeRef, ATTRS::QUAPOS, chart.edges);
+            auto& pres = drawQueue.edgePresentations.get (edgeRef);
 
             if (edgeQuapos && !edgeQuapos->noValue) {
-                if (edgeQuapos->intValue != 1 && edgeQuapos->intValue != 10 && edgeQuapos->intValue != 11) {
-                    edgeRef.addSymbol (environment.dai.getSymbolIndex ("LOWACC41"));
+                if (edgeQuapos->intValue () != 1 && edgeQuapos->intValue () != 10 && edgeQuapos->intValue () != 11) {
+                    pres.addSymbol (environment.dai.getSymbolIndex ("LOWACC41"));
                     continue;
                 }
             }
 
             if (isolatedDanger) {
-                edgeRef.customPres = true;
-                edgeRef.penIndex = environment.dai.getBasePenIndex ("CHBLK");
-                edgeRef.penStyle = PS_DOT;
-                edgeRef.penWidth = 2;
+                pres.customPres = true;
+                pres.penIndex = environment.dai.getBasePenIndex ("CHBLK");
+                pres.penStyle = PS_DOT;
+                pres.penWidth = 2;
                 continue;
             }
 
             auto edgeValsou = object->getEdgeAttr (edgeRef, ATTRS::VALSOU, chart.edges);
 
-            edgeRef.customPres = true;
-            edgeRef.penWidth = 2;
-            edgeRef.viewingGroup = 34050;
+            pres.customPres = true;
+            pres.penWidth = 2;
+            pres.viewingGroup = 34050;
 
             if (edgeValsou && !edgeValsou->noValue) {
-                edgeRef.penIndex = environment.dai.getBasePenIndex ("CHBLK");
-                if (edgeValsou->floatValue <= environment.settings.safetyDepth) {
-                    edgeRef.penStyle = PS_DOT;
+                pres.penIndex = environment.dai.getBasePenIndex ("CHBLK");
+                if (edgeValsou->floatValue () <= environment.settings.safetyDepth) {
+                    pres.penStyle = PS_DOT;
                 } else {
-                    edgeRef.penStyle = PS_DASH;
+                    pres.penStyle = PS_DASH;
                 }
             } else {
-                edgeRef.penIndex = environment.dai.getBasePenIndex ("CSTLN");
-                edgeRef.displayPriority = 4;
-
-                if (watlev && !watlev->noValue && (watlev->intValue == 1 || watlev->intValue == 2)) {
-                    edgeRef.penStyle = PS_SOLID;
-                } else if (watlev && !watlev->noValue && watlev->intValue == 4) {
-                    edgeRef.penStyle = PS_DASH;
-                } else if (watlev && !watlev->noValue && (watlev->intValue == 5 || watlev->intValue == 3)) {
-                    edgeRef.penStyle = PS_DOT;
+                pres.penIndex = environment.dai.getBasePenIndex ("CSTLN");
+                pres.displayPriority = 4;
+
+                if (watlev && !watlev->noValue && (watlev->intValue () == 1 || watlev->intValue () == 2)) {
+                    pres.penStyle = PS_SOLID;
+                } else if (watlev && !watlev->noValue && watlev->intValue () == 4) {
+                    pres.penStyle = PS_DASH;
+                } else if (watlev && !watlev->noValue && (watlev->intValue () == 5 || watlev->intValue () == 3)) {
+                    pres.penStyle = PS_DOT;
                 } else {
-                    edgeRef.penStyle = PS_DOT;
+                    pres.penStyle = PS_DOT;
                 }
             }
         }
@@ -740,7 +744,7 @@ void wrecks05 (LookupTableItem *item, FeatureObject *object, Environment& enviro
 void soundg03 (LookupTableItem *item, FeatureObject *object, Environment& environment, Chart& chart, View& view, DrawQueue& drawQueue) {
     auto& node = chart.nodes.container [object->nodeIndex];
 
-    for (auto& pos: node.points) {
+    chart.points (node).forEach ([object, &chart, &environment, &drawQueue] (const Position& pos) {
         std::vector<std::string> symbols;
 
         sndfrm04 (object, pos.depth, chart, environment, symbols);
@@ -750,47 +754,48 @@ void soundg03 (LookupTableItem *item, FeatureObject *object, Environment& enviro
 
             drawQueue.addSymbol (pos.lat, pos.lon, symbolIndex, 0.0, environment.dai);
         }
-    }
+    });
 }
 
 void qualin02 (LookupTableItem *item, FeatureObject *object, Environment& environment, Chart& chart, View& view, DrawQueue& drawQueue) {
     for (auto& edgeRef: object->edgeRefs) {
         auto quapos = object->getEdgeAttr (edgeRef, ATTRS::QUAPOS, chart.edges);
+        auto& pres = drawQueue.edgePresentations.get (edgeRef);
 
         if (quapos && !quapos->noValue) {
-            if (quapos->intValue == 1 || quapos->intValue == 10 || quapos->intValue == 11) {
-                edgeRef.addSymbol (environment.dai.getSymbolIndex ("LOWACC21"));
+            if (quapos->intValue () == 1 || quapos->intValue () == 10 || quapos->intValue () == 11) {
+                pres.addSymbol (environment.dai.getSymbolIndex ("LOWACC21"));
                 continue;
             }
         }
         if (object->classCode == OBJ_CLASSES::COALNE) {
             auto conrad = object->getAttr (ATTRS::CONRAD);
 
-            edgeRef.customPres = true;
+            pres.customPres = true;
 
             if (conrad && !conrad->noValue) {
-                if (conrad->intValue = 1) {
-                    edgeRef.penIndex = environment.dai.getBasePenIndex ("CHMGF");
-                    edgeRef.penStyle = PS_SOLID;
-                    edgeRef.penWidth = 3;
-                    edgeRef.secondPen = true;
-                    edgeRef.secondPenIndex = environment.dai.getBasePenIndex ("CSTLN");
-                    edgeRef.secondPenStyle = PS_SOLID;
-                    edgeRef.secondPenWidth = 1;
+                if (conrad->intValue () == 1) {
+                    pres.penIndex = environment.dai.getBasePenIndex ("CHMGF");
+                    pres.penStyle = PS_SOLID;
+                    pres.penWidth = 3;
+                    pres.secondPen = true;
+                    pres.secondPenIndex = environment.dai.getBasePenIndex ("CSTLN");
+                    pres.secondPenStyle = PS_SOLID;
+                    pres.secondPenWidth = 1;
                 } else {
-                    edgeRef.penIndex = environment.dai.getBasePenIndex ("CSTLN");
-                    edgeRef.penStyle = PS_SOLID;
-                    edgeRef.penWidth = 1;
+                    pres.penIndex = environment.dai.getBasePenIndex ("CSTLN");
+                    pres.penStyle = PS_SOLID;
+                    pres.penWidth = 1;
                 }
             } else {
-                edgeRef.penIndex = environment.dai.getBasePenIndex ("CSTLN");
-                edgeRef.penStyle = PS_SOLID;
-                edgeRef.penWidth = 1;
+                pres.penIndex = environment.dai.getBasePenIndex ("CSTLN");
+                pres.penStyle = PS_SOLID;
+                pres.penWidth = 1;
             }
         } else {
-            edgeRef.penIndex = environment.dai.getBasePenIndex ("CSTLN");
-            edgeRef.penStyle = PS_SOLID;
-            edgeRef.penWidth = 1;
+            pres.penIndex = environment.dai.getBasePenIndex ("CSTLN");
+            pres.penStyle = PS_SOLID;
+            pres.penWidth = 1;
             continue;
         }
     }
@@ -800,8 +805,8 @@ void symins02 (LookupTableItem *item, FeatureObject *object, Environment& enviro
     auto symins = object->getAttr (ATTRS::SYMINS);
 
     if (symins && !symins->noValue) {
-        std::vector<std::string> instrList;
-        splitString (symins->strValue, instrList, ';');
+        std::vector<std::string_view> instrList;
+        splitString (symins->strValue (), instrList, ';');
         processInstructions (environment.dai, environment.attrDictionary, *item, instrList);
     } else if (object->primitive == 1 || object->primitive == 4) {
         item->symbols.emplace_back (environment.dai.getSymbolIndex ("NEWOBJ01"));
@@ -818,7 +823,7 @@ void symins02 (LookupTableItem *item, FeatureObject *object, Environment& enviro
 
 void topmar01 (LookupTableItem *item, FeatureObject *object, Environment& environment, Chart& chart, View& view, DrawQueue& drawQueue) {
     auto topshp = object->getAttr (ATTRS::TOPSHP);
-    auto& pos = chart.nodes [object->nodeIndex].points.front ();
+    auto pos = chart.nodePosition (object->nodeIndex);
 
     std::string symbolName;
 
@@ -831,7 +836,7 @@ void topmar01 (LookupTableItem *item, FeatureObject *object, Environment& enviro
             }
         }
 
-        switch (topshp->intValue) {
+        switch (topshp->intValue ()) {
             case 1: case 24: case 29: symbolName = floating ? "TOPMAR02" : "TOPMAR22"; break;
             case 25: case 2: symbolName = floating ? "TOPMAR04" : "TOPMAR24"; break;
             case 32: case 26: case 3: symbolName = floating ? "TOPMAR10" : "TOPMAR30"; break;
@@ -865,15 +870,15 @@ void obstrn07 (LookupTableItem *item, FeatureObject *object, Environment& enviro
     double depth;
 
     if (valsou && !valsou->noValue) {
-        depth = valsou->floatValue;
+        depth = valsou->floatValue ();
     } else {
         auto watlev = object->getAttr (ATTRS::WATLEV);
         auto expsou = object->getAttr (ATTRS::EXPSOU);
 
         std::optional<int> waterLevel, soundingExposition;
 
-        if (watlev && !watlev->noValue) waterLevel = watlev->intValue;
-        if (expsou && !expsou->noValue) soundingExposition = expsou->intValue;
+        if (watlev && !watlev->noValue) waterLevel = watlev->intValue ();
+        if (expsou && !expsou->noValue) soundingExposition = expsou->intValue ();
 
         auto [leastDepth, seabedDepth] = depval02 (object, chart, waterLevel, soundingExposition);
         
@@ -882,9 +887,9 @@ void obstrn07 (LookupTableItem *item, FeatureObject *object, Environment& enviro
         } else {
             auto catobs = object->getAttr (ATTRS::CATOBS);
 
-            if (catobs && !catobs->noValue && catobs->intValue == 6 || watlev && !watlev->noValue && watlev->intValue == 3) {
+            if (catobs && !catobs->noValue && catobs->intValue () == 6 || watlev && !watlev->noValue && watlev->intValue () == 3) {
                 depth = 0.01;
-            } else if (watlev && !watlev->noValue && watlev->intValue == 5) {
+            } else if (watlev && !watlev->noValue && watlev->intValue () == 5) {
                 depth = 0.0;
             } else {
                 depth = -15.0;
@@ -896,7 +901,7 @@ void obstrn07 (LookupTableItem *item, FeatureObject *object, Environment& enviro
         if (object->primitive == 1 || object->primitive == 4) {
             // cont a
             bool lowAccuracy = quapnt02 (object, chart, environment);
-            auto& pos = chart.nodes [object->nodeIndex].points.front ();
+            auto pos = chart.nodePosition (object->nodeIndex);
 
             if (isolatedDanger) {
                 drawQueue.addSymbol (pos.lat, pos.lon, environment.dai.getSymbolIndex ("ISODGR01"), 0.0, environment.dai);
@@ -910,9 +915,9 @@ void obstrn07 (LookupTableItem *item, FeatureObject *object, Environment& enviro
             std::string symbolName;
 
             if (valsou && !valsou->noValue) {
-                if (valsou->floatValue <= environment.settings.safetyDepth) {
+                if (valsou->floatValue () <= environment.settings.safetyDepth) {
                     if (object->classCode == OBJ_CLASSES::UWTROC) {
-                        if (watlev && !watlev->noValue && (watlev->intValue == 4 || watlev->intValue == 5)) {
+                        if (watlev && !watlev->noValue && (watlev->intValue () == 4 || watlev->intValue () == 5)) {
                             symbolName = "UWTROC04";
                             sounding = false;
                         } else {
@@ -922,13 +927,13 @@ void obstrn07 (LookupTableItem *item, FeatureObject *object, Environment& enviro
                     } else {
                         auto catobs = object->getAttr (ATTRS::CATOBS);
 
-                        if (catobs && !catobs->noValue && catobs->intValue == 6) {
+                        if (catobs && !catobs->noValue && catobs->intValue () == 6) {
                             symbolName = "DANGER01";
                             sounding = true;
-                        } else if (watlev && !watlev->noValue && (watlev->intValue == 1 || watlev->intValue == 2)) {
+                        } else if (watlev && !watlev->noValue && (watlev->intValue () == 1 || watlev->intValue () == 2)) {
                             symbolName = "OBSTRN11";
                             sounding = false;
-                        } else if (watlev && !watlev->noValue && (watlev->intValue == 4 || watlev->intValue == 5)) {
+                        } else if (watlev && !watlev->noValue && (watlev->intValue () == 4 || watlev->intValue () == 5)) {
                             symbolName = "DANGER03";
                             sounding = true;
                         } else {
@@ -959,29 +964,30 @@ void obstrn07 (LookupTableItem *item, FeatureObject *object, Environment& enviro
             // cont b
             for (auto& edgeRef: object->edgeRefs) {
                 auto quapos = object->getEdgeAttr (edgeRef, ATTRS::QUAPOS, chart.edges);
+                auto& pres = drawQueue.edgePresentations.get (edgeRef);
 
-                edgeRef.customPres = true;
+                pres.customPres = true;
 
-                if (quapos && !quapos->noValue && quapos->intValue >= 2 && quapos->intValue <= 9) {
-                    edgeRef.addSymbol (environment.dai.getSymbolIndex (isolatedDanger ? "LOWACC41" : "LOWACC31"));
+                if (quapos && !quapos->noValue && quapos->intValue () >= 2 && quapos->intValue () <= 9) {
+                    pres.addSymbol (environment.dai.getSymbolIndex (isolatedDanger ? "LOWACC41" : "LOWACC31"));
                     continue;
                 }
                 
-                edgeRef.penWidth = 2;
-                edgeRef.penIndex = environment.dai.getBasePenIndex ("CHBLK");
+                pres.penWidth = 2;
+                pres.penIndex = environment.dai.getBasePenIndex ("CHBLK");
 
                 if (isolatedDanger) {
-                    edgeRef.penStyle = PS_DOT; continue;
+                    pres.penStyle = PS_DOT; continue;
                 }
 
                 if (valsou && !valsou->noValue) {
-                    if (valsou->floatValue <= environment.settings.safetyDepth) {
-                        edgeRef.penStyle = PS_DOT;
+                    if (valsou->floatValue () <= environment.settings.safetyDepth) {
+                        pres.penStyle = PS_DOT;
                     } else {
-                        edgeRef.penStyle = PS_DASH;
+                        pres.penStyle = PS_DASH;
                     }
                 } else {
-                    edgeRef.penStyle = PS_DOT;
+                    pres.penStyle = PS_DOT;
                 }
             }
         } else {
@@ -1007,7 +1013,7 @@ void obstrn07 (LookupTableItem *item, FeatureObject *object, Environment& enviro
             }
 
             if (valsou && !valsou->noValue) {
-                if (valsou->floatValue <= environment.settings.safetyDepth) {
+                if (valsou->floatValue () <= environment.settings.safetyDepth) {
                     item->edgePenIndex = environment.dai.getBasePenIndex ("CHGRD");
                     item->edgePenStyle = PS_DASH;
                     item->edgePenWidth = 2;
@@ -1026,17 +1032,17 @@ void obstrn07 (LookupTableItem *item, FeatureObject *object, Environment& enviro
             } else {
                 auto catobs = object->getAttr (ATTRS::CATOBS);
 
-                if (catobs && !catobs->noValue && catobs->intValue == 6) {
+                if (catobs && !catobs->noValue && catobs->intValue () == 6) {
                     item->patternBrushIndex = environment.dai.getPatternIndex ("FOULAR01");
                     item->edgePenIndex = environment.dai.getBasePenIndex ("CHBLK");
                     item->edgePenStyle = PS_DOT;
                     item->edgePenWidth = 2;
-                } else if (watlev && !watlev->noValue && (watlev->intValue == 1 || watlev->intValue == 2)) {
+                } else if (watlev && !watlev->noValue && (watlev->intValue () == 1 || watlev->intValue () == 2)) {
                     item->brushIndex = environment.dai.getBasePenIndex ("CHBRN");
                     item->edgePenIndex = environment.dai.getBasePenIndex ("CSTLN");
                     item->edgePenStyle = PS_SOLID;
                     item->edgePenWidth = 2;
-                } else if (watlev && !watlev->noValue && watlev->intValue == 4) {
+                } else if (watlev && !watlev->noValue && watlev->intValue () == 4) {
                     item->brushIndex = environment.dai.getBasePenIndex ("DEPIT");
                     item->edgePenIndex = environment.dai.getBasePenIndex ("CSTLN");
                     item->edgePenStyle = PS_DASH;
@@ -1060,7 +1066,7 @@ void quapos01 (LookupTableItem *item, FeatureObject *object, Environment& enviro
     if (object->primitive == 2) {
         qualin02 (item, object, environment, chart, view, drawQueue);
     } else if (quapnt02 (object, chart, environment)) {
-        auto& pos = chart.nodes [object->nodeIndex].points.front ();
+        auto pos = chart.nodePosition (object->nodeIndex);
         drawQueue.addSymbol (pos.lat, pos.lon, environment.dai.getSymbolIndex ("LOWACC01"), 0.0, environment.dai);
     }
 }
@@ -1068,38 +1074,39 @@ void quapos01 (LookupTableItem *item, FeatureObject *object, Environment& enviro
 void slcons04 (LookupTableItem *item, FeatureObject *object, Environment& environment, Chart& chart, View& view, DrawQueue& drawQueue) {
     if (object->primitive == 1 || object->primitive == 4) {
         if (quapnt02 (object, chart, environment)) {
-            auto& pos = chart.nodes [object->nodeIndex].points.front ();
+            auto pos = chart.nodePosition (object->nodeIndex);
             drawQueue.addSymbol (pos.lat, pos.lon, environment.dai.getSymbolIndex ("LOWACC01"), 0.0, environment.dai);
         }
     } else {
         for (auto& edgeRef: object->edgeRefs) {
             auto quapos = object->getEdgeAttr (edgeRef, ATTRS::QUAPOS, chart.edges);
+            auto& pres = drawQueue.edgePresentations.get (edgeRef);
 
-            if (quapos && !quapos->noValue && (quapos->intValue == 1 || quapos->intValue == 10 || quapos->intValue == 11)) {
-                edgeRef.addSymbol (environment.dai.getSymbolIndex ("LOWACC01"));
+            if (quapos && !quapos->noValue && (quapos->intValue () == 1 || quapos->intValue () == 10 || quapos->intValue () == 11)) {
+                pres.addSymbol (environment.dai.getSymbolIndex ("LOWACC01"));
             } else {
                 auto condtn = object->getEdgeAttr (edgeRef, ATTRS::CONDTN, chart.edges);
                 auto catslc = object->getEdgeAttr (edgeRef, ATTRS::CATSLC, chart.edges);
                 auto watlev = object->getEdgeAttr (edgeRef, ATTRS::WATLEV, chart.edges);
 
-                edgeRef.customPres = true;
-                edgeRef.penIndex = environment.dai.getBasePenIndex ("CSTLN");
-
-                if (condtn && !condtn->noValue && (condtn->intValue == 1 || condtn->intValue == 2)) {
-                    edgeRef.penStyle = PS_DASH;
-                    edgeRef.penWidth = 1;
-                } else if (catslc && !catslc->noValue && (catslc->intValue == 6 || catslc->intValue == 15 || catslc->intValue == 16)) {
-                    edgeRef.penStyle = PS_SOLID;
-                    edgeRef.penWidth = 4;
-                } else if (watlev && !watlev->noValue && (watlev->intValue == 3 || watlev->intValue == 4)) {
-                    edgeRef.penStyle = PS_DASH;
-                    edgeRef.penWidth = 2;
-                } else if (watlev && !watlev->noValue && watlev->intValue == 2) {
-                    edgeRef.penStyle = PS_SOLID;
-                    edgeRef.penWidth = 2;
+                pres.customPres = true;
+                pres.penIndex = environment.dai.getBasePenIndex ("CSTLN");
+
+                if (condtn && !condtn->noValue && (condtn->intValue () == 1 || condtn->intValue () == 2)) {
+                    pres.penStyle = PS_DASH;
+                    pres.penWidth = 1;
+                } else if (catslc && !catslc->noValue && (catslc->intValue () == 6 || catslc->intValue () == 15 || catslc->intValue () == 16)) {
+                    pres.penStyle = PS_SOLID;
+                    pres.penWidth = 4;
+                } else if (watlev && !watlev->noValue && (watlev->intValue () == 3 || watlev->intValue () == 4)) {
+                    pres.penStyle = PS_DASH;
+                    pres.penWidth = 2;
+                } else if (watlev && !watlev->noValue && watlev->intValue () == 2) {
+                    pres.penStyle = PS_SOLID;
+                    pres.penWidth = 2;
                 } else {
-                    edgeRef.penStyle = PS_SOLID;
-                    edgeRef.penWidth = 2;
+                    pres.penStyle = PS_SOLID;
+                    pres.penWidth = 2;
                 }
             }
         }
@@ -1333,12 +1340,12 @@ std::string litdsn02 (FeatureObject *object, Chart& chart, Environment& environm
     std::vector<std::string> signalGroups;
     std::vector<char> colors;
 
-    if (height && !height->noValue) heightValue = std::to_string (height->floatValue) + 'm';
-    if (sigper && !sigper->noValue) signalPeriod = std::to_string ((int) sigper->floatValue) + 's';
-    if (valnmr && !valnmr->noValue) rangeValue = std::to_string ((int) valnmr->floatValue) + 'M';
+    if (height && !height->noValue) heightValue = std::to_string (height->floatValue ()) + 'm';
+    if (sigper && !sigper->noValue) signalPeriod = std::to_string ((int) sigper->floatValue ()) + 's';
+    if (valnmr && !valnmr->noValue) rangeValue = std::to_string ((int) valnmr->floatValue ()) + 'M';
     if (colour && !colour->noValue) {
         static char	COLOR_CHARS [] { "\0W\0RGBY\0\0AVO" };
-        for (uint8_t clr: colour->listValue) {
+        for (uint8_t clr: colour->listValue ()) {
             if (clr > 0 && clr < sizeof (COLOR_CHARS)) {
                 colors.emplace_back (COLOR_CHARS [clr]);
             }
@@ -1349,11 +1356,11 @@ std::string litdsn02 (FeatureObject *object, Chart& chart, Environment& environm
         auto checkAddGroup = [&group, &signalGroups] () {
             if (!group.empty ()) signalGroups.emplace_back (group.c_str ());
         };
-        for (char chr: siggrp->strValue) {
-            if (chr == '(') {
-                checkAddGroup (); group = chr;
+        for (const char *chr = siggrp->strValue (); *chr; ++ chr) {
+            if (*chr == '(') {
+                checkAddGroup (); group = *chr;
             } else {
-                group += chr;
+                group += *chr;
             }
         }
         checkAddGroup ();
@@ -1394,8 +1401,8 @@ std::string litdsn02 (FeatureObject *object, Chart& chart, Environment& environm
     }
     std::string desc;
     if (litchr && !litchr->noValue) {
-        desc = getSignalCode (litchr->intValue) + ' ';
-        switch (litchr->intValue) {
+        desc = getSignalCode (litchr->intValue ()) + ' ';
+        switch (litchr->intValue ()) {
             case 1: /*Fixed*/ {
                 if (!colors.empty ()) desc += colors.front ();
                 break;
@@ -1615,14 +1622,14 @@ void lights06 (LookupTableItem *item, FeatureObject *object, Environment& enviro
     ChartSettings& settings = environment.settings;
     auto valnmr = object->getAttr (ATTRS::VALNMR);
     Attr *orient = 0;
-    auto position = nodes [object->nodeIndex].points.front ();
+    auto position = chart.nodePosition (object->nodeIndex);
 
-    double nominalRange = (valnmr && !valnmr->noValue) ? valnmr->floatValue : 9.0;
+    double nominalRange = (valnmr && !valnmr->noValue) ? valnmr->floatValue () : 9.0;
 
     auto catlit = object->getAttr (ATTRS::CATLIT);
 
     if (catlit && !catlit->noValue) {
-        switch (catlit->intValue) {
+        switch (catlit->intValue ()) {
             case 11:
             case 8: {
                 item->symbols.clear ();
@@ -1661,14 +1668,14 @@ void lights06 (LookupTableItem *item, FeatureObject *object, Environment& enviro
         sectr1->noValue ||
         !sectr2 ||
         sectr2->noValue ||
-        sectr1->floatValue == sectr2->floatValue ||
-        sectr1->floatValue == 0.0 && sectr2->floatValue == 360.0
+        sectr1->floatValue () == sectr2->floatValue () ||
+        sectr1->floatValue () == 0.0 && sectr2->floatValue () == 360.0
     );
     if (noSector) {
         if (
             nominalRange >= 10.0 &&
             (!catlit || catlit->noValue || !catlit->listIncludes (5) && !catlit->listIncludes (6)) &&
-            (!litchr || litchr->noValue || litchr->intValue != 12)
+            (!litchr || litchr->noValue || litchr->intValue () != 12)
         ) {
             std::string arcColorName = "CHMGD";
             if (colour && !colour->noValue) {
@@ -1690,7 +1697,7 @@ void lights06 (LookupTableItem *item, FeatureObject *object, Environment& enviro
                     arcColorName = "LITYW";
                 }
             }
-            auto& pos = nodes [object->nodeIndex].points.front ();
+            auto pos = chart.nodePosition (object->nodeIndex);
 
             drawQueue.addCompoundLightArc (dai.getBasePenIndex (arcColorName.c_str ()), PS_SOLID, 2, pos.lat, pos.lon, 26, 0.0, 360.0);
         } else {
@@ -1709,8 +1716,8 @@ void lights06 (LookupTableItem *item, FeatureObject *object, Environment& enviro
                         curSectr1->noValue ||
                         !curSectr2 ||
                         curSectr2->noValue ||
-                        curSectr1->floatValue == curSectr2->floatValue ||
-                        curSectr1->floatValue == 0.0 && curSectr2->floatValue == 360.0
+                        curSectr1->floatValue () == curSectr2->floatValue () ||
+                        curSectr1->floatValue () == 0.0 && curSectr2->floatValue () == 360.0
                     ) {
                         noSectorLightsPlus = true; break;
                     }
@@ -1745,7 +1752,7 @@ void lights06 (LookupTableItem *item, FeatureObject *object, Environment& enviro
             }
             item->symbols.clear ();
 
-            if (catlit && !catlit->noValue && (catlit->intValue == 1 || catlit->intValue == 16)) {
+            if (catlit && !catlit->noValue && (catlit->intValue () == 1 || catlit->intValue () == 16)) {
                 if (orient && !orient->noValue) {
                     // +/- 180
                     item->symbols.emplace_back (dai.getSymbolIndex (symbolName.c_str ()), 180.0);
@@ -1779,8 +1786,8 @@ void lights06 (LookupTableItem *item, FeatureObject *object, Environment& enviro
         }
     } else {
         // Continuation
-        double sector1Value = sectr1->floatValue;
-        double sector2Value = sectr2->floatValue;
+        double sector1Value = sectr1->floatValue ();
+        double sector2Value = sectr2->floatValue ();
  
         if (sector2Value <= sector1Value) sector2Value += 360.0;
 
@@ -1801,8 +1808,8 @@ void lights06 (LookupTableItem *item, FeatureObject *object, Environment& enviro
             if (curObject.fidn != object->fidn && curObject.classCode == OBJ_CLASSES::LIGHTS) {
                 bool colocated = curObject.nodeIndex == object->nodeIndex;
                 if (!colocated) {
-                    auto pos1 = nodes [object->nodeIndex].points.front ();
-                    auto pos2 = nodes [curObject.nodeIndex].points.front ();
+                    auto pos1 = chart.nodePosition (object->nodeIndex);
+                    auto pos2 = chart.nodePosition (curObject.nodeIndex);
 
                     if (pos1.lat == pos2.lat && pos1.lon == pos2.lon) colocated = true;
                 }
@@ -1812,8 +1819,8 @@ void lights06 (LookupTableItem *item, FeatureObject *object, Environment& enviro
                     auto curValnmr = curObject.getAttr (ATTRS::VALNMR);
 
                     if (curSectr1 && curSectr2 && !curSectr1->noValue && !curSectr2->noValue) {
-                        double curSector1Value = curSectr1->floatValue;
-                        double curSector2Value = curSectr2->floatValue;
+                        double curSector1Value = curSectr1->floatValue ();
+                        double curSector2Value = curSectr2->floatValue ();
 
                         //if (curSector2Value <= curSector1Value) curSector2Value += 360.0;
 
@@ -1824,7 +1831,7 @@ void lights06 (LookupTableItem *item, FeatureObject *object, Environment& enviro
                             isAngleBetween (curSector1Value, sector1Value, sector2Value) ||
                             isAngleBetween (curSector2Value, sector1Value, sector2Value)
                         ) {
-                            double curNominalRangeValue = (curValnmr && !curValnmr->noValue) ? curValnmr->floatValue : 9.0f;
+                            double curNominalRangeValue = (curValnmr && !curValnmr->noValue) ? curValnmr->floatValue () : 9.0f;
                             if (curNominalRangeValue > nominalRange) {
                                 extendedArcRadius = true; break;
                             }
@@ -1842,7 +1849,7 @@ void lights06 (LookupTableItem *item, FeatureObject *object, Environment& enviro
 
         int lineStyle, lineWidth;
         std::string arcColorName;
-        if (litvis && !litvis->noValue && (litvis->intValue == 3 || litvis->intValue == 7 || litvis->intValue == 8)) {
+        if (litvis && !litvis->noValue && (litvis->intValue () == 3 || litvis->intValue () == 7 || litvis->intValue () == 8)) {
             lineStyle = PS_DASH;
             lineWidth = 1;
             arcColorName = "CHBLK";
@@ -1886,7 +1893,7 @@ void lights06 (LookupTableItem *item, FeatureObject *object, Environment& enviro
 }
 
 void initCSPs (Environment& environment) {
-    environment.dai.addCSP ("LIGHTS06", lights06);
+    environment.dai.addCSP ("LIGHTS06", lights06, true);
     environment.dai.addCSP ("DEPCNT03", depcnt03);
     environment.dai.addCSP ("DEPARE03", depare03);
     environment.dai.addCSP ("SOUNDG02", soundg03);
@@ -0,0 +1,527 @@
+#include <cstdint>
+#include <string>
+#include <Windows.h>
+#include "dai_cache.h"
+#include "mapped_file.h"
+#include "cache_io.h"
+#include "crc32.h"
+
+static const char DAI_CACHE_MAGIC [] = { 'S', '5', '7', 'D' };
+
+// Indexes stored in the cache point into these tables, so any change of them makes the cache useless
+static uint32_t getEnvironmentStamp (Environment& environment) {
+    Dai& dai = environment.dai;
+    uint32_t crc = 0;
+
+    auto addValue = [&crc] (uint64_t value) {
+        crc = updateCrc32 (crc, & value, sizeof (value));
+    };
+    auto addIndex = [&crc, &addValue] (StringIndex& index) {
+        addValue (index.size ());
+
+        for (auto& [name, value]: index) {
+            crc = updateCrc32 (crc, name.c_str (), name.length () + 1);
+            addValue (value);
+        }
+    };
+
+    addIndex (environment.objectDictionary.indexByAcronym);
+    addIndex (environment.attrDictionary.indexByAcronym);
+
+    for (auto& item: environment.objectDictionary.items) addValue (item.code);
+    for (auto& item: environment.attrDictionary.items) addValue (((uint64_t) item.code << 8) + (uint8_t) item.domain);
+
+    addIndex (dai.colorTable.index);
+    addIndex (dai.palette.brushIndex);
+    addIndex (dai.procIndex);
+
+    return crc;
+}
+
+struct DaiCacheWriter: CacheWriter {
+    void putStringIndex (StringIndex& index) {
+        put ((uint64_t) index.size ());
+
+        for (auto& [name, value]: index) {
+            putString (name);
+            put ((uint64_t) value);
+        }
+    }
+    void putStrings (std::vector<std::string>& strings) {
+        put ((uint64_t) strings.size ());
+
+        for (auto& string: strings) putString (string);
+    }
+    void putDrawable (DrawableObjDesc& desc) {
+        putString (desc.name);
+        put (desc.pivotPtCol);
+        put (desc.pivotPtRow);
+        putString (desc.exposition);
+        putString (desc.color);
+        put (desc.bBoxWidth);
+        put (desc.bBoxHeight);
+        put (desc.bBoxCol);
+        put (desc.bBoxRow);
+        put ((uint64_t) desc.svgs.size ());
+
+        for (auto& svg: desc.svgs) putStrings (svg);
+
+        put ((uint64_t) desc.drawProc.instructions.size ());
+
+        for (auto& oper: desc.drawProc.instructions) {
+            put ((int32_t) oper.oper);
+            putBytes (oper.args.data (), oper.args.size () * sizeof (uint64_t));
+        }
+
+        put ((uint64_t) desc.drawProc.penColors.size ());
+
+        for (auto& [code, colorIndex]: desc.drawProc.penColors) {
+            put (code);
+            put ((uint64_t) colorIndex);
+        }
+    }
+    void putTextDesc (TextDesc& desc) {
+        put ((int32_t) desc.horJust);
+        put ((int32_t) desc.verJust);
+        put ((int32_t) desc.spacing);
+        put ((int32_t) desc.fontType);
+        put ((int32_t) desc.fontWeight);
+        put ((int32_t) desc.fontStyle);
+        put (desc.fontSize);
+        put (desc.horOffset);
+        put (desc.verOffset);
+        put ((uint64_t) desc.colorIndex);
+        put ((uint64_t) desc.paramDescs.size ());
+
+        for (auto& param: desc.paramDescs) {
+            put ((int32_t) param.type);
+            putString (param.format);
+            put ((uint64_t) param.classCode);
+            putString (param.plainText);
+        }
+
+        putStrings (desc.plainTextParts);
+    }
+    void putItem (LookupTableItem& item) {
+        put (item.objectType);
+        put (item.radarPriority);
+        putBytes (item.acronym, sizeof (item.acronym));
+        put (item.drawFlags);
+        put (item.classCode);
+        put (item.displayPriority);
+        put ((int32_t) item.tableSet);
+        put ((uint64_t) item.attrCombination.size ());
+
+        for (auto& instance: item.attrCombination) {
+            put (instance.domain);
+            put (instance.classCode);
+            putString (instance.acronym);
+            put ((uint8_t) instance.noValue);
+            put ((uint8_t) instance.missing);
+            put (instance.intValue);
+            put (instance.floatValue);
+            putString (instance.strValue);
+            putBytes (instance.listValue.data (), instance.listValue.size ());
+        }
+
+        putString (item.instruction);
+        put ((int32_t) item.displayCat);
+        putString (item.comment);
+        put ((uint64_t) item.penIndex);
+        put ((uint64_t) item.brushIndex);
+        put ((uint64_t) item.patternBrushIndex);
+        put ((uint64_t) item.centralSymbolIndex);
+        put ((uint64_t) item.procIndex);
+        put ((uint64_t) item.edgePenIndex);
+        put ((uint64_t) item.lineCharIndex);
+        put ((uint64_t) item.edgeSymbolIndex);
+        put (item.edgePenStyle);
+        put (item.edgePenWidth);
+        put (item.viewingGroup);
+        put ((uint64_t) item.symbols.size ());
+
+        for (auto& symbol: item.symbols) {
+            put ((uint64_t) symbol.symbolIndex);
+            put (symbol.rotAngle);
+        }
+
+        put ((uint64_t) item.lines.size ());
+
+        for (auto& line: item.lines) {
+            put ((uint64_t) line.penIndex);
+            put ((int32_t) line.mode);
+            put (line.lat1);
+            put (line.lon1);
+            put (line.lat2);
+            put (line.lon2);
+            put (line.brg);
+            put (line.endBrg);
+            put (line.lengthMm);
+        }
+
+        putStrings (item.textInstructions);
+        put ((uint64_t) item.textDescriptions.size ());
+
+        for (auto& desc: item.textDescriptions) putTextDesc (desc);
+
+        put ((uint8_t) item.customEdgePres);
+        put (item.arcDef.radius);
+        put (item.arcDef.start);
+        put (item.arcDef.end);
+        put ((uint64_t) item.arcDef.nodeIndex);
+        put ((uint64_t) item.arcDef.internalColor);
+        put ((uint8_t) item.drawArc);
+    }
+};
+
+struct DaiCacheReader: CacheReader {
+    DaiCacheReader (const char *begin, const char *_end): CacheReader (begin, _end) {}
+
+    size_t getSize () {
+        return (size_t) get<uint64_t> ();
+    }
+    void getStringIndex (StringIndex& index) {
+        index.clear ();
+
+        for (size_t i = 0, count = getCount (9); valid && i < count; ++ i) {
+            std::string name;
+
+            getString (name);
+            index.emplace (name, getSize ());
+        }
+    }
+    void getStrings (std::vector<std::string>& strings) {
+        strings.resize (getCount (8));
+
+        for (auto& string: strings) getString (string);
+    }
+    void getDrawable (DrawableObjDesc& desc) {
+        getString (desc.name);
+        get (desc.pivotPtCol);
+        get (desc.pivotPtRow);
+        getString (desc.exposition);
+        getString (desc.color);
+        get (desc.bBoxWidth);
+        get (desc.bBoxHeight);
+        get (desc.bBoxCol);
+        get (desc.bBoxRow);
+        desc.svgs.resize (getCount (8));
+
+        for (auto& svg: desc.svgs) getStrings (svg);
+
+        desc.drawProc.instructions.resize (getCount (12));
+
+        for (auto& oper: desc.drawProc.instructions) {
+            oper.oper = (DrawOperCode) get<int32_t> ();
+
+            size_t size = getCount (1);
+            const char *args = take (size);
+
+            if (!args || size % sizeof (uint64_t)) {
+                valid = false; return;
+            }
+
+            oper.args.resize (size / sizeof (uint64_t));
+            memcpy (oper.args.data (), args, size);
+        }
+
+        desc.drawProc.penColors.clear ();
+
+        for (size_t i = 0, count = getCount (9); valid && i < count; ++ i) {
+            char code = get<char> ();
+
+            desc.drawProc.penColors.emplace (code, getSize ());
+        }
+    }
+    void getTextDesc (TextDesc& desc) {
+        desc.horJust = (TextDesc::HorJust) get<int32_t> ();
+        desc.verJust = (TextDesc::VerJust) get<int32_t> ();
+        desc.spacing = (TextDesc::Spacing) get<int32_t> ();
+        desc.fontType = (TextDesc::FontType) get<int32_t> ();
+        desc.fontWeight = (TextDesc::FontWeight) get<int32_t> ();
+        desc.fontStyle = (TextDesc::FontStyle) get<int32_t> ();
+        get (desc.fontSize);
+        get (desc.horOffset);
+        get (desc.verOffset);
+        desc.colorIndex = getSize ();
+        desc.paramDescs.resize (getCount (28));
+
+        for (auto& param: desc.paramDescs) {
+            param.type = (TextDesc::ParamType) get<int32_t> ();
+            getString (param.format);
+            param.classCode = getSize ();
+            getString (param.plainText);
+        }
+
+        getStrings (desc.plainTextParts);
+    }
+    void getItem (LookupTableItem& item) {
+        get (item.objectType);
+        get (item.radarPriority);
+
+        const char *acronym = getCount (1) == sizeof (item.acronym) ? take (sizeof (item.acronym)) : 0;
+
+        if (acronym) memcpy (item.acronym, acronym, sizeof (item.acronym)); else valid = false;
+
+        get (item.drawFlags);
+        get (item.classCode);
+        get (item.displayPriority);
+        item.tableSet = (TableSet) get<int32_t> ();
+        item.attrCombination.resize (getCount (8));
+
+        for (auto& instance: item.attrCombination) {
+            get (instance.domain);
+            get (instance.classCode);
+            getString (instance.acronym);
+            instance.noValue = get<uint8_t> () != 0;
+            instance.missing = get<uint8_t> () != 0;
+            get (instance.intValue);
+            get (instance.floatValue);
+            getString (instance.strValue);
+
+            size_t listSize = getCount (1);
+            const char *list = take (listSize);
+
+            if (list) instance.listValue.assign ((const uint8_t *) list, (const uint8_t *) list + listSize);
+        }
+
+        getString (item.instruction);
+        item.displayCat = (DisplayCat) get<int32_t> ();
+        getString (item.comment);
+        item.penIndex = getSize ();
+        item.brushIndex = getSize ();
+        item.patternBrushIndex = getSize ();
+        item.centralSymbolIndex = getSize ();
+        item.procIndex = getSize ();
+        item.edgePenIndex = getSize ();
+        item.lineCharIndex = getSize ();
+        item.edgeSymbolIndex = getSize ();
+        get (item.edgePenStyle);
+        get (item.edgePenWidth);
+        get (item.viewingGroup);
+
+        for (size_t i = 0, count = getCount (16); valid && i < count; ++ i) {
+            size_t symbolIndex = getSize ();
+
+            item.addSymbol (symbolIndex, get<double> ());
+        }
+
+        for (size_t i = 0, count = getCount (68); valid && i < count; ++ i) {
+            size_t penIndex = getSize ();
+            LineDrawMode mode = (LineDrawMode) get<int32_t> ();
+            double lat1 = get<double> (), lon1 = get<double> (), lat2 = get<double> (), lon2 = get<double> ();
+            auto& line = item.lines.emplace_back (penIndex, LineDrawMode::BETWEEN_TWO_POINTS, lat1, lon1, lat2, lon2);
+
+            line.mode = mode;
+            get (line.brg);
+            get (line.endBrg);
+            get (line.lengthMm);
+        }
+
+        getStrings (item.textInstructions);
+        item.textDescriptions.resize (getCount (60));
+
+        for (auto& desc: item.textDescriptions) getTextDesc (desc);
+
+        item.customEdgePres = get<uint8_t> () != 0;
+        get (item.arcDef.radius);
+        get (item.arcDef.start);
+        get (item.arcDef.end);
+        item.arcDef.nodeIndex = getSize ();
+        item.arcDef.internalColor = getSize ();
+        item.drawArc = get<uint8_t> () != 0;
+    }
+};
+
+static std::string getCachePath (const char *path) {
+    return std::string (path) + ".cache";
+}
+
+bool saveDaiCache (const char *path, Environment& environment) {
+    Dai& dai = environment.dai;
+    DaiCacheWriter writer;
+    uint64_t size, modified;
+
+    if (!queryFileStamp (path, size, modified)) return false;
+
+    writer.buffer.append (DAI_CACHE_MAGIC, sizeof (DAI_CACHE_MAGIC));
+    writer.put (DAI_CACHE_VERSION);
+    writer.put (size);
+    writer.put (modified);
+    writer.put (getEnvironmentStamp (environment));
+
+    auto& libraryId = dai.libraryId;
+
+    writer.putString (libraryId.moduleName);
+    writer.put (libraryId.rcid);
+    writer.putString (libraryId.exchangePurpose);
+    writer.putString (libraryId.productType);
+    writer.putString (libraryId.exchangeSetSerialNo);
+    writer.putString (libraryId.editionNo);
+    writer.putString (libraryId.compilationDate);
+    writer.putString (libraryId.compilationTime);
+    writer.putString (libraryId.libraryProfileVersionsDate);
+    writer.putString (libraryId.libaryAppProfile);
+    writer.putString (libraryId.objectCatVersionDate);
+    writer.putString (libraryId.comment);
+
+    // Pens created by LS instructions, in creation order so that they get the same indexes when created again
+    std::vector<std::string> penInstructions (dai.palette.penIndex.size ());
+
+    for (auto& [instruction, index]: dai.palette.penIndex) {
+        if (index < penInstructions.size ()) penInstructions [index] = instruction;
+    }
+
+    writer.putStrings (penInstructions);
+
+    writer.put ((uint64_t) dai.patterns.size ());
+
+    for (auto& pattern: dai.patterns) {
+        writer.putDrawable (pattern);
+        writer.put (pattern.type);
+        writer.put ((int32_t) pattern.fillType);
+        writer.put ((int32_t) pattern.spacing);
+        writer.put (pattern.minDistance);
+        writer.put (pattern.maxDistance);
+        writer.putString (pattern.bitmap);
+    }
+
+    writer.put ((uint64_t) dai.symbols.size ());
+
+    for (auto& symbol: dai.symbols) {
+        writer.putDrawable (symbol);
+        writer.put (symbol.type);
+        writer.putString (symbol.bitmap);
+    }
+
+    writer.put ((uint64_t) dai.lines.size ());
+
+    for (auto& line: dai.lines) writer.putDrawable (line);
+
+    writer.putStringIndex (dai.patternIndex);
+    writer.putStringIndex (dai.symbolIndex);
+    writer.putStringIndex (dai.lineIndex);
+    writer.put ((uint64_t) dai.lookupTables.size ());
+
+    for (auto& lookupTable: dai.lookupTables) {
+        writer.put ((uint64_t) lookupTable.size ());
+
+        for (auto& item: lookupTable) writer.putItem (item);
+    }
+
+    writer.put ((uint64_t) dai.lookupTableIndex.size ());
+
+    for (auto& [key, index]: dai.lookupTableIndex) {
+        writer.put (key);
+        writer.put ((uint64_t) index);
+    }
+
+    return writer.save (getCachePath (path).c_str ());
+}
+
+// Everything is read aside first and moved into the Dai only once the whole cache turned out to be valid,
+// so a failed load leaves the Dai ready for parsing the .dai file
+bool loadDaiCache (const char *path, Environment& environment) {
+    Dai& dai = environment.dai;
+    MappedFile cache;
+    uint64_t size, modified;
+
+    if (!queryFileStamp (path, size, modified) || !cache.open (getCachePath (path).c_str ())) return false;
+
+    DaiCacheReader reader (cache.begin (), cache.end ());
+    const char *magic = reader.take (sizeof (DAI_CACHE_MAGIC));
+
+    if (!magic || memcmp (magic, DAI_CACHE_MAGIC, sizeof (DAI_CACHE_MAGIC)) != 0) return false;
+    if (reader.get<uint32_t> () != DAI_CACHE_VERSION) return false;
+    if (reader.get<uint64_t> () != size || reader.get<uint64_t> () != modified) return false;
+    if (reader.get<uint32_t> () != getEnvironmentStamp (environment)) return false;
+
+    LibraryIdentification libraryId;
+    std::vector<std::string> penInstructions;
+    std::vector<PatternDesc> patterns;
+    std::vector<SymbolDesc> symbols;
+    std::vector<LineDesc> lines;
+    StringIndex patternIndex, symbolIndex, lineIndex;
+    std::vector<LookupTable> lookupTables;
+    std::map<uint32_t, size_t> lookupTableIndex;
+
+    reader.getString (libraryId.moduleName);
+    reader.get (libraryId.rcid);
+    reader.getString (libraryId.exchangePurpose);
+    reader.getString (libraryId.productType);
+    reader.getString (libraryId.exchangeSetSerialNo);
+    reader.getString (libraryId.editionNo);
+    reader.getString (libraryId.compilationDate);
+    reader.getString (libraryId.compilationTime);
+    reader.getString (libraryId.libraryProfileVersionsDate);
+    reader.getString (libraryId.libaryAppProfile);
+    reader.getString (libraryId.objectCatVersionDate);
+    reader.getString (libraryId.comment);
+    reader.getStrings (penInstructions);
+
+    patterns.resize (reader.getCount (1));
+
+    for (auto& pattern: patterns) {
+        reader.getDrawable (pattern);
+        reader.get (pattern.type);
+        pattern.fillType = (FillType) reader.get<int32_t> ();
+        pattern.spacing = (Spacing) reader.get<int32_t> ();
+        reader.get (pattern.minDistance);
+        reader.get (pattern.maxDistance);
+        reader.getString (pattern.bitmap);
+    }
+
+    symbols.resize (reader.getCount (1));
+
+    for (auto& symbol: symbols) {
+        reader.getDrawable (symbol);
+        reader.get (symbol.type);
+        reader.getString (symbol.bitmap);
+    }
+
+    lines.resize (reader.getCount (1));
+
+    for (auto& line: lines) reader.getDrawable (line);
+
+    reader.getStringIndex (patternIndex);
+    reader.getStringIndex (symbolIndex);
+    reader.getStringIndex (lineIndex);
+
+    lookupTables.resize (reader.getCount (8));
+
+    for (auto& lookupTable: lookupTables) {
+        for (size_t i = 0, count = reader.getCount (1); reader.valid && i < count; ++ i) {
+            reader.getItem (lookupTable.emplace_back ());
+        }
+    }
+
+    for (size_t i = 0, count = reader.getCount (12); reader.valid && i < count; ++ i) {
+        uint32_t key = reader.get<uint32_t> ();
+        size_t index = reader.getSize ();
+
+        if (index >= lookupTables.size ()) reader.valid = false;
+
+        lookupTableIndex.emplace (key, index);
+    }
+
+    if (!reader.valid) return false;
+
+    dai.libraryId = std::move (libraryId);
+    dai.patterns = std::move (patterns);
+    dai.symbols = std::move (symbols);
+    dai.lines = std::move (lines);
+    dai.patternIndex = std::move (patternIndex);
+    dai.symbolIndex = std::move (symbolIndex);
+    dai.lineIndex = std::move (lineIndex);
+    dai.lookupTables = std::move (lookupTables);
+    dai.lookupTableIndex = std::move (lookupTableIndex);
+
+    // GDI objects in the order the .dai loader creates them, which reproduces the stored brush and pen indexes
+    dai.composePatternBrushes ();
+
+    for (auto& instruction: penInstructions) {
+        if (!instruction.empty ()) dai.palette.checkPen (instruction.data (), dai.colorTable);
+    }
+
+    return true;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include "data.h"
+
+// Compiled presentation library stored next to the .dai file as <path>.cache: lookup tables with their processed
+// instructions, symbols, patterns and line styles. It is keyed by the size and modification time of the .dai file and
+// by a stamp of the dictionaries, colors and CSPs the indexes inside refer to. GDI objects are never stored, loading
+// the cache creates them again.
+static const uint32_t DAI_CACHE_VERSION = 2;
+
+bool loadDaiCache (const char *path, Environment& environment);
+bool saveDaiCache (const char *path, Environment& environment);
@@ -3,10 +3,17 @@
 #include <stdlib.h>
 #include <cstdint>
 #include <vector>
+#include <deque>
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <tuple>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <cmath>
 #include "s57defs.h"
+#include "scan.h"
 #include "geo.h"
 #include "chart_settings.h"
 
@@ -15,6 +22,10 @@ enum NodeFlags {
     SOUNDING_ARRAY = 2,
 };
 
+enum TopologyFlags {
+    DELETED = 0x80,             // Removed by an update, kept in place so indices stay valid
+};
+
 struct TopologyObject {
     uint32_t id;
     uint8_t recordName;
@@ -23,10 +34,195 @@ struct TopologyObject {
     uint32_t version;
 
     TopologyObject (): id (0), recordName (0), flags (0), updateInstruction (0), version (0) {}
+
+    bool isDeleted () { return (flags & TopologyFlags::DELETED) != 0; }
+};
+
+// Part of the chart coordinate pool owned by a node or an edge
+struct PositionSpan {
+    uint32_t offset;
+    uint32_t count;
+
+    PositionSpan (): offset (0), count (0) {}
+
+    size_t size () const { return count; }
+    bool empty () const { return count == 0; }
+};
+
+// Coordinates as they come from the cell, in units of the cell COMF
+struct FixedPosition {
+    int32_t lat;
+    int32_t lon;
+    float depth;
 };
 
+struct PositionRange;
+
+// All vertices of a chart in one block; nodes and edges refer to it by spans. In fixed point mode the pool keeps
+// the integer coordinates of the cell (12 bytes a vertex instead of 24) and positions are decoded on access.
+struct CoordPool {
+    // Larger multipliers could overflow the 64 bit products of the fixed point geometry
+    static const uint32_t MAX_FIXED_POINT_MULTIPLIER = 10000000;
+
+    bool preferFixedPoint;      // Requested by the loader, kept over clear ()
+    bool fixedPoint;
+    double coordMultiplier;
+    std::vector<Position> positions;
+    std::vector<FixedPosition> fixedPositions;
+
+    CoordPool (): preferFixedPoint (false), fixedPoint (false), coordMultiplier (0.0) {}
+
+    // Called once COMF of the cell is known, before any vertex is added
+    void setCoordMultiplier (uint32_t multiplier) {
+        if (size () > 0) return;
+
+        coordMultiplier = (double) multiplier;
+        fixedPoint = preferFixedPoint && multiplier > 0 && multiplier <= MAX_FIXED_POINT_MULTIPLIER;
+    }
+
+    size_t size () const { return fixedPoint ? fixedPositions.size () : positions.size (); }
+
+    Position decode (const FixedPosition& fixed) const {
+        return { (double) fixed.lat / coordMultiplier, (double) fixed.lon / coordMultiplier, (double) fixed.depth };
+    }
+    Position get (size_t index) const {
+        return fixedPoint ? decode (fixedPositions [index]) : positions [index];
+    }
+
+    // Calls fn for the positions [first, last), last to first if reversed. The storage mode is checked once per call
+    // so the loops over the vertices do not branch on it.
+    template<typename Fn> void forEach (size_t first, size_t last, bool reversed, Fn& fn) const {
+        if (fixedPoint) {
+            auto decodeAndCall = [this, &fn] (const FixedPosition& fixed) { fn (decode (fixed)); };
+
+            visit (fixedPositions.data (), first, last, reversed, decodeAndCall);
+        } else {
+            visit (positions.data (), first, last, reversed, fn);
+        }
+    }
+    void set (size_t index, const Position& pos) {
+        if (fixedPoint) {
+            auto& fixed = fixedPositions [index];
+            fixed.lat = (int32_t) lround (pos.lat * coordMultiplier);
+            fixed.lon = (int32_t) lround (pos.lon * coordMultiplier);
+            fixed.depth = (float) pos.depth;
+        } else {
+            positions [index] = pos;
+        }
+    }
+
+    PositionRange operator [] (PositionSpan span);
+
+    std::vector<Position> copy (PositionSpan span) {
+        std::vector<Position> result (span.count);
+
+        for (size_t i = 0; i < span.count; ++ i) result [i] = get (span.offset + i);
+
+        return result;
+    }
+
+    // Extends the span by count positions and returns the pool index of the first new one. The span is moved to the
+    // end of the pool unless it is there already, so spans filled one after another stay in place.
+    size_t grow (PositionSpan& span, size_t count) {
+        if (fixedPoint) return grow (fixedPositions, span, count);
+
+        return grow (positions, span, count);
+    }
+    void append (PositionSpan& span, const Position *data, size_t count) {
+        size_t first = grow (span, count);
+
+        for (size_t i = 0; i < count; ++ i) set (first + i, data [i]);
+    }
+
+    // Replaces the content of the span; a longer content is placed at the end, the old place is left unused
+    void assign (PositionSpan& span, const Position *data, size_t count) {
+        if (count > span.count) {
+            span.count = 0;
+            grow (span, count);
+        } else {
+            span.count = (uint32_t) count;
+        }
+
+        for (size_t i = 0; i < count; ++ i) set (span.offset + i, data [i]);
+    }
+
+    // Appends all vertices of a pool in the same mode and returns the offset to rebase its spans by
+    size_t absorb (const CoordPool& other) {
+        size_t base = size ();
+
+        if (fixedPoint) {
+            fixedPositions.insert (fixedPositions.end (), other.fixedPositions.begin (), other.fixedPositions.end ());
+        } else {
+            positions.insert (positions.end (), other.positions.begin (), other.positions.end ());
+        }
+
+        return base;
+    }
+
+    void insert (PositionSpan& span, size_t at, const Position *data, size_t count) {
+        std::vector<Position> merged = copy (span);
+
+        merged.insert (merged.begin () + at, data, data + count);
+        assign (span, merged.data (), merged.size ());
+    }
+
+    void clear () {
+        positions.clear ();
+        fixedPositions.clear ();
+        fixedPoint = false;
+        coordMultiplier = 0.0;
+    }
+
+private:
+    template<typename T, typename Fn> static void visit (const T *items, size_t first, size_t last, bool reversed, Fn& fn) {
+        if (reversed) {
+            for (size_t i = last; i > first; -- i) fn (items [i - 1]);
+        } else {
+            for (size_t i = first; i < last; ++ i) fn (items [i]);
+        }
+    }
+
+    template<typename T> size_t grow (std::vector<T>& items, PositionSpan& span, size_t count) {
+        if (span.count == 0) {
+            span.offset = (uint32_t) items.size ();
+        } else if (span.offset + span.count != items.size ()) {
+            size_t oldOffset = span.offset;
+
+            span.offset = (uint32_t) items.size ();
+            items.resize (items.size () + span.count);
+            memcpy (items.data () + span.offset, items.data () + oldOffset, span.count * sizeof (T));
+        }
+
+        items.resize (items.size () + count);
+        span.count += (uint32_t) count;
+
+        return span.offset + span.count - count;
+    }
+};
+
+// Resolved span; valid until the pool grows
+struct PositionRange {
+    const CoordPool *pool;
+    size_t first, last;
+
+    PositionRange (const CoordPool *_pool, size_t _first, size_t _last): pool (_pool), first (_first), last (_last) {}
+
+    template<typename Fn> void forEach (Fn fn) const { pool->forEach (first, last, false, fn); }
+    template<typename Fn> void forEachReversed (Fn fn) const { pool->forEach (first, last, true, fn); }
+
+    size_t size () const { return last - first; }
+    bool empty () const { return first == last; }
+    Position front () const { return pool->get (first); }
+    Position back () const { return pool->get (last - 1); }
+    Position operator [] (size_t index) const { return pool->get (first + index); }
+};
+
+inline PositionRange CoordPool::operator [] (PositionSpan span) {
+    return PositionRange (this, span.offset, span.offset + span.count);
+}
+
 struct GeoNode: TopologyObject {
-    std::vector<Position> points;
+    PositionSpan points;
 
     GeoNode (): TopologyObject () {}
 };
@@ -44,28 +240,137 @@ struct EdgeNode: Position {
     EdgeNode (): Position (), hidden (false), hole (false) {}
 };
 
+// Chart-wide storage for attribute texts and long lists. Chunks never move, so handed out pointers
+// stay valid until clear ().
+struct StringPool {
+    static const size_t CHUNK_SIZE = 0x10000;
+
+    std::vector<std::unique_ptr<char []>> chunks;
+    size_t used;
+
+    StringPool (): used (0) {}
+
+    // Copies data into the pool and appends the terminating zero
+    const char *add (const char *data, size_t size) {
+        size_t required = size + 1;
+
+        if (chunks.empty () || used + required > CHUNK_SIZE) {
+            chunks.emplace_back (new char [required > CHUNK_SIZE ? required : CHUNK_SIZE]);
+            used = 0;
+        }
+
+        char *result = chunks.back ().get () + used;
+
+        memcpy (result, data, size);
+        result [size] = '\0';
+
+        // Oversized chunk is taken by one string only
+        used = required > CHUNK_SIZE ? CHUNK_SIZE : used + required;
+
+        return result;
+    }
+
+    // Takes over the chunks of another pool, strings handed out by it stay valid
+    void absorb (StringPool& other) {
+        if (other.chunks.empty ()) return;
+
+        for (auto& chunk: other.chunks) chunks.push_back (std::move (chunk));
+
+        used = other.used;
+        other.clear ();
+    }
+
+    void clear () {
+        chunks.clear ();
+        used = 0;
+    }
+};
+
+struct ByteSpan {
+    const uint8_t *data;
+    size_t length;
+
+    ByteSpan (const uint8_t *_data, size_t _length): data (_data), length (_length) {}
+
+    const uint8_t *begin () const { return data; }
+    const uint8_t *end () const { return data + length; }
+    size_t size () const { return length; }
+    bool empty () const { return length == 0; }
+    uint8_t operator [] (size_t index) const { return data [index]; }
+};
+
+// 32 bytes per attribute. Domain comes from the dictionary when values are deformatted, numeric values and lists
+// up to 8 items are kept inline, texts and longer lists live in the chart string pool.
 struct Attr {
+    static const size_t INLINE_LIST_SIZE = 8;
+    static const size_t MAX_LIST_SIZE = 0xFFFF;
+
     uint16_t classCode;
-    std::string acronym;
+    char domain;
     bool noValue;
-    uint32_t intValue;
-    double floatValue;
-    std::string strValue;
-    std::vector<uint8_t> listValue;
+    uint16_t listSize;
+    uint32_t textLength;
+    const char *text;               // ATVL as it comes from the cell, zero terminated
+    union {
+        uint32_t intValue;
+        double floatValue;
+        uint8_t inlineList [INLINE_LIST_SIZE];
+        const uint8_t *pooledList;
+    } value;
+
+    Attr (): classCode (0), domain (0), noValue (true), listSize (0), textLength (0), text (0) {
+        value.floatValue = 0.0;
+    }
+
+    uint32_t intValue () { return (domain == 'I' || domain == 'E') ? value.intValue : 0; }
+    double floatValue () { return domain == 'F' ? value.floatValue : 0.0; }
+    const char *strValue () { return text ? text : ""; }
+    size_t strLength () { return textLength; }
+    ByteSpan listValue () {
+        if (domain != 'L') return ByteSpan (0, 0);
+
+        return ByteSpan (listSize > INLINE_LIST_SIZE ? value.pooledList : value.inlineList, listSize);
+    }
+
+    void setText (StringPool& pool, const char *data, size_t size) {
+        text = pool.add (data, size);
+        textLength = (uint32_t) size;
+    }
+    void setInt (char _domain, uint32_t intValue) {
+        domain = _domain;
+        value.intValue = intValue;
+    }
+    void setFloat (double floatValue) {
+        domain = 'F';
+        value.floatValue = floatValue;
+    }
+    // Lists longer than MAX_LIST_SIZE are rejected rather than cut, the attribute is left with an empty list then
+    bool setList (StringPool& pool, const uint8_t *items, size_t numOfItems) {
+        domain = 'L';
+        listSize = 0;
+
+        if (numOfItems > MAX_LIST_SIZE) return false;
+
+        listSize = (uint16_t) numOfItems;
+
+        if (listSize > INLINE_LIST_SIZE) {
+            value.pooledList = (const uint8_t *) pool.add ((const char *) items, listSize);
+        } else if (listSize > 0) {
+            memcpy (value.inlineList, items, listSize);
+        }
 
-    Attr (): classCode (0), noValue (true), intValue (0), floatValue (0.0f) {}
+        return true;
+    }
 
-    bool listIncludes (uint8_t value) {
-        for (uint8_t byte: listValue) {
-            if (byte == value) return true;
+    bool listIncludes (uint8_t item) {
+        for (uint8_t byte: listValue ()) {
+            if (byte == item) return true;
         }
         return false;
     }
-    bool listIncludes (uint8_t *values) {
-        for (uint8_t *value = values; *value; ++ value) {
-            for (uint8_t byte: listValue) {
-                if (byte == *value) return true;
-            }
+    bool listIncludes (uint8_t *items) {
+        for (uint8_t *item = items; *item; ++ item) {
+            if (listIncludes (*item)) return true;
         }
         return false;
     }
@@ -75,7 +380,7 @@ struct GeoEdge: TopologyObject {
     Orient orientation;
     size_t beginIndex;
     size_t endIndex;
-    std::vector<Position> internalNodes;
+    PositionSpan internalNodes;
     bool hidden;
     bool hole;
     std::vector<Attr> attributes;
@@ -83,11 +388,18 @@ struct GeoEdge: TopologyObject {
     GeoEdge (): TopologyObject (), orientation (Orient::UNKNOWN), beginIndex (-1), endIndex (-1), hidden (false), hole (false) {}
 };
 
+// Reference from a line or area feature to one of its edges
 struct EdgeRef {
     size_t index;
-    bool hidden;
-    bool hole;
-    bool unclockwise;
+    bool hidden: 1;
+    bool hole: 1;
+    bool unclockwise: 1;
+
+    EdgeRef (): index (LookupTableItem::NOT_EXIST), hidden (false), hole (false), unclockwise (false) {}
+};
+
+// Presentation of an edge reference assigned by a CSP, overrides the pen of the lookup table item
+struct EdgePresentation {
     bool customPres;
     bool secondPen;
     size_t penIndex, secondPenIndex;
@@ -98,30 +410,8 @@ struct EdgeRef {
     int displayPriority;
     DisplayCat dispCat;
 
-    EdgeRef (EdgeRef& src):
-        index (src.index),
-        hidden (src.hidden),
-        hole (src.hole),
-        unclockwise (src.unclockwise),
-        customPres (src.customPres),
-        secondPen (src.secondPen),
-        penIndex (src.penIndex),
-        secondPenIndex (src.secondPenIndex),
-        penStyle (src.penStyle),
-        secondPenStyle (src.secondPenStyle),
-        penWidth (src.penWidth),
-        secondPenWidth (src.secondPenWidth),
-        viewingGroup (src.viewingGroup),
-        displayPriority (src.displayPriority),
-        dispCat (src.dispCat) {
-        symbols.insert (symbols.begin (), src.symbols.begin (), src.symbols.end ());
-    }
-
-    EdgeRef ():
+    EdgePresentation ():
         customPres (false),
-        hidden (false),
-        hole (false),
-        unclockwise (false),
         secondPen (false),
         penIndex (-1),
         secondPenIndex (-1),
@@ -130,10 +420,8 @@ struct EdgeRef {
         penWidth (0),
         secondPenWidth (0),
         viewingGroup (0),
-        dispCat (DisplayCat::DISPLAY_BASE),
-        displayPriority (0) {
-        symbols.clear ();
-    }
+        displayPriority (0),
+        dispCat (DisplayCat::DISPLAY_BASE) {}
 
     void addSymbol (size_t index) {
         for (size_t curIndex: symbols) {
@@ -143,6 +431,65 @@ struct EdgeRef {
     }
 };
 
+// Sparse table of the presentations assigned during one render, keyed by the edge reference within its feature
+struct EdgePresentations {
+    std::unordered_map<const EdgeRef *, EdgePresentation> items;
+
+    size_t size () { return items.size (); }
+    void clear () { items.clear (); }
+
+    EdgePresentation& get (const EdgeRef& edgeRef) { return items [& edgeRef]; }
+    EdgePresentation *find (const EdgeRef& edgeRef) {
+        auto pos = items.find (& edgeRef);
+
+        return pos == items.end () ? 0 : & pos->second;
+    }
+};
+
+// Lookup index kept beside an attribute list, which itself keeps the cell order and any repeated codes; a code resolves
+// to the position of its first occurrence. The index is one block of 16 bit words sized for the codes present: the
+// header, presence masks for the mask words in use, their ranks, the positions of the masked codes in code order
+// followed by those of the higher codes, and at last the sorted higher codes.
+struct AttrIndex {
+    enum Header { NUM_OF_WORDS, NUM_OF_MASKED, NUM_OF_HIGH, HEADER_SIZE = 4 };
+
+    static const size_t MAX_MASK_WORDS = 8;         // Presence bits cover the attribute codes below 512
+
+    // Gives no index for an empty list or one too long to address with 16 bits
+    static std::unique_ptr<uint16_t []> build (const std::vector<Attr>& attributes);
+
+    static size_t find (const uint16_t *index, size_t classCode) {
+        size_t numOfWords = index [NUM_OF_WORDS];
+        size_t numOfMasked = index [NUM_OF_MASKED];
+        size_t numOfHigh = index [NUM_OF_HIGH];
+        const uint16_t *ranks = index + HEADER_SIZE + numOfWords * 4;
+        const uint16_t *positions = ranks + numOfWords;
+        size_t word = classCode >> 6;
+
+        if (word < numOfWords) {
+            uint64_t mask;
+            uint64_t bit = 1ull << (classCode & 63);
+
+            memcpy (& mask, index + HEADER_SIZE + word * 4, sizeof (mask));
+
+            if ((mask & bit) == 0) return LookupTableItem::NOT_EXIST;
+
+            return positions [ranks [word] + countSetBits (mask & (bit - 1))];
+        }
+
+        const uint16_t *highCodes = positions + numOfMasked + numOfHigh;
+        size_t first = 0, last = numOfHigh;
+
+        while (first < last) {
+            size_t middle = (first + last) >> 1;
+
+            if (highCodes [middle] < classCode) first = middle + 1; else last = middle;
+        }
+
+        return (first < numOfHigh && highCodes [first] == classCode) ? positions [numOfMasked + first] : LookupTableItem::NOT_EXIST;
+    }
+};
+
 struct FeatureObject: TopologyObject {
     uint8_t primitive;
     uint8_t group;
@@ -153,30 +500,41 @@ struct FeatureObject: TopologyObject {
     std::vector<Attr> attributes;
     std::vector<EdgeRef> edgeRefs;    // Lines and areas
     size_t nodeIndex;                 // Point and sounding array
+    std::unique_ptr<uint16_t []> attrIndex;          // See AttrIndex; lookups scan the attributes while there is none
 
     FeatureObject (): TopologyObject (), primitive (PRIM::None), group (1), classCode (0), agency (0), fidn (0), subDiv (0), nodeIndex (-1) {}
 
+    void buildAttrIndex () {
+        attrIndex = AttrIndex::build (attributes);
+    }
+    // Whoever changes the attribute list drops the index first and builds it again when done
+    void dropAttrIndex () {
+        attrIndex.reset ();
+    }
+
     Attr *getAttr (const char *acronym, struct AttrDictionary& dic);
     Attr *getAttr (size_t classCode) {
-        for (auto& attr: attributes) {
-            if (attr.classCode == classCode) return &attr;
+        if (!attrIndex) {
+            for (auto& attr: attributes) {
+                if (attr.classCode == classCode) return &attr;
+            }
+            return 0;
         }
-        return 0;
+
+        size_t position = AttrIndex::find (attrIndex.get (), classCode);
+
+        return position == LookupTableItem::NOT_EXIST ? 0 : & attributes [position];
+    }
+    bool hasAttr (size_t classCode) {
+        return getAttr (classCode) != 0;
     }
 
     Attr *getEdgeAttr (EdgeRef& edgeRef, const char *acronym, struct AttrDictionary& dic, struct Edges& edges);
     Attr *getEdgeAttr (EdgeRef& edgeRef, size_t classCode, struct Edges& edges);
 
     bool fitsInAttrsRequired (std::vector<AttrInstance>& attrsRequired) {
-        auto findActualAttr = [this] (uint16_t classCode) {
-            for (auto& attr: attributes) {
-                if (attr.classCode == classCode) return & attr;
-            }
-            return (Attr *) 0;
-        };
-
         for (auto& requiredAttr: attrsRequired) {
-            auto actualAttr = findActualAttr (requiredAttr.classCode);
+            auto actualAttr = getAttr (requiredAttr.classCode);
             
             if (!actualAttr) return false;
 
@@ -185,16 +543,18 @@ struct FeatureObject: TopologyObject {
             switch (requiredAttr.domain) {
                 case 'E':
                 case 'I': {
-                    if (requiredAttr.intValue != actualAttr->intValue) return false;
+                    if (requiredAttr.intValue != actualAttr->intValue ()) return false;
                     break;
                 }
                 case 'F': {
-                    if (requiredAttr.floatValue != actualAttr->floatValue) return false;
+                    if (requiredAttr.floatValue != actualAttr->floatValue ()) return false;
                     break;
                 }
                 case 'L': {
-                    if (requiredAttr.listValue.size () != actualAttr->listValue.size ()) return false;
-                    if (memcmp (requiredAttr.listValue.data (), actualAttr->listValue.data (), requiredAttr.listValue.size ()) != 0) return false;
+                    auto actualList = actualAttr->listValue ();
+
+                    if (requiredAttr.listValue.size () != actualList.size ()) return false;
+                    if (memcmp (requiredAttr.listValue.data (), actualList.begin (), actualList.size ()) != 0) return false;
                     break;
                 }
             }
@@ -202,7 +562,63 @@ struct FeatureObject: TopologyObject {
         return true;
     }
 
-    LookupTableItem *findBestItem (DisplayCat displayCat, TableSet tableSet, Dai& dai, int priority = -1) {
+    bool fitsInRule (LookupTableMatcher& matcher, LookupTableMatcher::Rule& rule) {
+        for (uint32_t i = 0; i < rule.numOfConditions; ++ i) {
+            auto& condition = matcher.conditions [rule.firstCondition + i];
+            auto actualAttr = getAttr (condition.classCode);
+
+            if (!actualAttr) return false;
+
+            switch (condition.kind) {
+                case LookupTableMatcher::NO_VALUE:
+                    return actualAttr->noValue;
+                case LookupTableMatcher::INT_VALUE:
+                    if (condition.intValue != actualAttr->intValue ()) return false;
+                    break;
+                case LookupTableMatcher::FLOAT_VALUE:
+                    if (condition.floatValue != actualAttr->floatValue ()) return false;
+                    break;
+                case LookupTableMatcher::LIST_VALUE: {
+                    auto actualList = actualAttr->listValue ();
+
+                    if (condition.listSize != actualList.size ()) return false;
+                    if (memcmp (matcher.listValues.data () + condition.listOffset, actualList.begin (), actualList.size ()) != 0) return false;
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Same result as trying the items in table order, but only rules branching from the feature attributes are checked
+    LookupTableItem *matchItem (LookupTable& table, LookupTableMatcher& matcher) {
+        size_t bestItem = matcher.unconditionalItem;
+
+        for (auto& attr: attributes) {
+            if (!matcher.mayHaveBranches (attr.classCode)) continue;
+
+            auto [branch, lastBranch] = matcher.findBranches (attr.classCode);
+
+            for (; branch != lastBranch; ++ branch) {
+                if (!branch->anyValue && branch->value != attr.intValue ()) continue;
+
+                for (uint32_t i = 0; i < branch->numOfRules; ++ i) {
+                    auto& rule = matcher.rules [branch->firstRule + i];
+
+                    if (rule.itemIndex >= bestItem) break;
+
+                    if (fitsInRule (matcher, rule)) {
+                        bestItem = rule.itemIndex; break;
+                    }
+                }
+            }
+        }
+
+        return & table [bestItem < table.size () ? bestItem : 0];
+    }
+
+    // Entry of the lookup table fitting the feature best; it belongs to the Dai so CSPs have to work on a copy
+    LookupTableItem *findBestItem (DisplayCat displayCat, TableSet tableSet, Dai& dai) {
         char objectType;
         
         if (primitive == PRIM::Area) {
@@ -215,76 +631,21 @@ struct FeatureObject: TopologyObject {
             return 0;
         }
         
-        LookupTable *table = dai.findLookupTable (classCode, displayCat, tableSet, objectType);
-        
-        if (!table) return 0;
+        size_t tableIndex = dai.findLookupTableIndex (classCode, displayCat, tableSet, objectType);
         
-        LookupTableItem *result = & table->at (0);
+        if (tableIndex == LookupTableItem::NOT_EXIST) return 0;
 
+        LookupTable *table = & dai.lookupTables [tableIndex];
+
+        if (tableIndex < dai.lookupTableMatchers.size ()) return matchItem (*table, dai.lookupTableMatchers [tableIndex]);
+        
         for (size_t i = 1; i < table->size (); ++ i) {
             LookupTableItem *item = & table->at (i);
 
-            if (fitsInAttrsRequired (item->attrCombination)) {
-                result = item; break;
-            }
-            continue;
-            bool itemOk = true;
-            for (size_t j = 0; j < item->attrCombination.size (); ++ j) {
-                auto& attrRequired = item->attrCombination [j];
-                bool attrFound = true;
-
-                if (attrRequired.noValue && !attrRequired.strValue.empty ()) {
-                    attrRequired.noValue = false;
-                }
-
-                if (attrRequired.missing) {
-                    for (auto& attr: attributes) {
-                        if (attr.classCode == attrRequired.classCode) {
-                            // The attribute should be missing but it exists
-                            // Skip this item
-                            attrFound = false; break;
-                        }
-                    }
-                } else {
-                    for (auto& attr: attributes) {
-                        if (attr.classCode == attrRequired.classCode) {
-                            // The attribute found, just check value (if it is needed)
-                            if (attrRequired.noValue) {
-                                attrFound = true;
-                            } else if (attr.noValue) {
-                                attrFound = false;
-                            } else {
-                                switch (attrRequired.domain) {
-                                    case 'I':
-                                    case 'E':
-                                        attrFound = attr.intValue == attrRequired.intValue; break;
-                                    case 'F':
-                                        attrFound = attr.floatValue == attrRequired.floatValue; break;
-                                    case 'L':
-                                        attrFound = false;
-                                        for (uint8_t byte: attr.listValue) {
-                                            if (byte == std::atoi (attrRequired.strValue.c_str ())) {
-                                                attrFound = true; break;
-                                            }
-                                        }
-                                        break;
-                                    default:
-                                        attrFound = true; break; // TO BE DONE!!!!!
-                                }
-                            }
-                            break;
-                        }
-                    }
-                }
-                if (!attrFound) {
-                    itemOk = false; break;
-                }
-            }
-            if (itemOk) {
-                return (priority > 0 && result->displayPriority != priority) ? 0 : new LookupTableItem (item);
-            }
+            if (fitsInAttrsRequired (item->attrCombination)) return item;
         }
-        return (priority > 0 && result->displayPriority != priority) ? 0 : new LookupTableItem (result);
+
+        return & table->at (0);
     }
 };
 
@@ -303,8 +664,66 @@ inline uint64_t constructForeignKey (uint8_t *byteArray) {
     return key;
 }
 
+// Foreign key -> container index. RCIDs of a record name are usually dense, so each record name whose keys fill
+// enough of their range gets a directly indexed table; the remaining keys go to a sorted vector.
+struct ForeignKeyIndex {
+    static const uint32_t EMPTY_SLOT = 0xFFFFFFFF;
+
+    struct DirectTable {
+        uint8_t recName;
+        uint32_t firstRcid;
+        std::vector<uint32_t> slots;
+    };
+
+    std::vector<DirectTable> directTables;
+    std::vector<std::pair<uint64_t, size_t>> sparseKeys;
+
+    // keys [i] is the key of the i-th container item; the first of duplicated keys wins
+    void build (std::vector<uint64_t>& keys);
+    void set (uint64_t key, size_t index);
+    void erase (uint64_t key);
+    void clear () {
+        directTables.clear ();
+        sparseKeys.clear ();
+    }
+
+    size_t find (uint64_t key) {
+        uint32_t *slot = getDirectSlot (key);
+
+        if (slot) return *slot == EMPTY_SLOT ? LookupTableItem::NOT_EXIST : *slot;
+
+        return findSparse (key);
+    }
+
+private:
+    // Keys within the range of a direct table never go to the sparse part, so the table alone answers for them
+    uint32_t *getDirectSlot (uint64_t key) {
+        uint8_t recName = (uint8_t) (key >> 32);
+        uint32_t rcid = (uint32_t) key;
+
+        for (auto& table: directTables) {
+            if (table.recName == recName && rcid >= table.firstRcid && rcid - table.firstRcid < table.slots.size ()) {
+                return & table.slots [rcid - table.firstRcid];
+            }
+        }
+
+        return 0;
+    }
+    size_t findSparse (uint64_t key) {
+        size_t first = 0, last = sparseKeys.size ();
+
+        while (first < last) {
+            size_t middle = (first + last) >> 1;
+
+            if (sparseKeys [middle].first < key) first = middle + 1; else last = middle;
+        }
+
+        return (first < sparseKeys.size () && sparseKeys [first].first == key) ? sparseKeys [first].second : LookupTableItem::NOT_EXIST;
+    }
+};
+
 struct TopologyCollection {
-    std::map<uint64_t, size_t> index;
+    ForeignKeyIndex index;
 };
 
 template<typename ObjType>
@@ -312,11 +731,16 @@ struct GeoCollection: TopologyCollection {
     std::vector<ObjType> container;
 
     void buildIndex () {
+        std::vector<uint64_t> keys (container.size ());
+
         for (size_t i = 0; i < container.size (); ++ i) {
             auto& node = container [i];
-            uint64_t key = constructForeignKey (node.recordName, node.id);
-            index.emplace (std::pair<uint64_t, size_t> (key, i));
+
+            // Tombstones left by updates are not reachable by their keys
+            keys [i] = node.isDeleted () ? (uint64_t) LookupTableItem::NOT_EXIST : constructForeignKey (node.recordName, node.id);
         }
+
+        index.build (keys);
     }
 
     size_t size () { return container.size (); }
@@ -335,14 +759,12 @@ struct GeoCollection: TopologyCollection {
         return getByForgeignKey (constructForeignKey (recName, rcid));
     }
     ObjType *getByForgeignKey (uint64_t key) {
-        auto pos = index.find (key);
+        size_t pos = index.find (key);
 
-        return (pos == index.end ()) ? 0 : & container [pos->second];
+        return (pos == LookupTableItem::NOT_EXIST) ? 0 : & container [pos];
     }
     size_t getIndexByForgeignKey (uint64_t key) {
-        auto pos = index.find (key);
-
-        return (pos == index.end ()) ? -1 : pos->second;
+        return index.find (key);
     }
 };
 
@@ -350,33 +772,133 @@ struct GeoCollection: TopologyCollection {
 struct Nodes: GeoCollection<GeoNode> {};
 struct Edges: GeoCollection<GeoEdge> {};
 struct Features: GeoCollection<FeatureObject> {};
+// Columns the render passes scan for every feature, kept apart from the attribute and edge vectors of FeatureObject.
+// Deleted features have no primitive, features without geometry get an empty (inverted) box.
+struct FeatureTable {
+    std::vector<uint8_t> primitive;
+    std::vector<uint8_t> group;
+    std::vector<uint16_t> classCode;
+    std::vector<float> north, south, west, east;
+
+    size_t size () { return primitive.size (); }
+    void clear () {
+        primitive.clear ();
+        group.clear ();
+        classCode.clear ();
+        north.clear ();
+        south.clear ();
+        west.clear ();
+        east.clear ();
+    }
+    bool intersects (size_t index, double viewNorth, double viewWest, double viewSouth, double viewEast) {
+        return north [index] >= viewSouth && south [index] <= viewNorth && east [index] >= viewWest && west [index] <= viewEast;
+    }
+};
+
+// Outcome of the CSP of one feature: the adjusted lookup table item, clones of the drawers it queued and presentations
+// of the feature edges. It is replayed instead of running the procedure until the settings generation changes (or the
+// zoom, for procedures depending on the scale).
+struct CspResult {
+    bool recorded;
+    uint32_t settingsGeneration;
+    int zoom;
+    bool purgesSymbols;             // The procedure removed the symbols queued before it
+    LookupTableItem item;
+    std::vector<struct Drawer *> drawers;
+    std::vector<std::pair<const EdgeRef *, EdgePresentation>> edgePresentations;
+
+    CspResult (): recorded (false), settingsGeneration (0), zoom (0), purgesSymbols (false) {}
+    CspResult (const CspResult&) = delete;
+    CspResult& operator = (const CspResult&) = delete;
+
+    // Both in drawers.cpp where Drawer is complete
+    ~CspResult ();
+    void clear ();
+
+    bool isValid (uint32_t generation, int _zoom, bool zoomDependent) {
+        return recorded && settingsGeneration == generation && (!zoomDependent || zoom == _zoom);
+    }
+};
+
+// Lookup table entries resolved once per feature for a display category and the table sets of point and spatial
+// objects. Entries belong to Dai::lookupTables, so a CSP gets a copy. Spatial features are bucketed by the display
+// priority (1..9) of their entry, points are kept in feature order.
+struct Symbolization {
+    DisplayCat displayCat;
+    TableSet spatialTableSet;
+    TableSet pointTableSet;
+    std::vector<LookupTableItem *> items;
+    std::vector<size_t> spatialsByPriority [10];
+    std::vector<size_t> points;
+    std::unordered_map<size_t, CspResult> cspResults;   // By feature index, for entries with a CSP only
+};
+
+struct SymbolizationCache {
+    std::deque<Symbolization> sets;     // Never relocated, CSP results can't be copied
+
+    void clear () { sets.clear (); }
+    Symbolization *find (DisplayCat displayCat, TableSet spatialTableSet, TableSet pointTableSet) {
+        for (auto& set: sets) {
+            if (set.displayCat == displayCat && set.spatialTableSet == spatialTableSet && set.pointTableSet == pointTableSet) return & set;
+        }
+
+        return 0;
+    }
+};
+
 struct Chart {
     Nodes nodes;
     Edges edges;
     Features features;
+    FeatureTable featureTable;       // Rebuilt by the painter once it goes out of sync, cleared when features change
+    SymbolizationCache symbolization; // Same as above, one set per display category and table sets in use
     UnderlyingObjectsList objectsUnderPoints, objectsUnderSpatials;
     AreaTopologyMap areaTopologyMap;
     DatasetParams params;
+    StringPool strings;
+    CoordPool coords;
+
+    // First (usually the only) position of the node
+    Position nodePosition (size_t nodeIndex) {
+        return coords.get (nodes [nodeIndex].points.offset);
+    }
+    PositionRange points (GeoNode& node) { return coords [node.points]; }
+    PositionRange internalNodes (GeoEdge& edge) { return coords [edge.internalNodes]; }
 
     SpatialsUnderObject *getListOfSpatialsUnderPoint (FeatureObject& point) {
-        auto& pos = objectsUnderPoints.find (point.fidn);
+        auto pos = objectsUnderPoints.find (point.fidn);
 
         return pos == objectsUnderPoints.end () ? 0 : & pos->second;
     }
     SpatialsUnderObject *getListOfSpatialsUnderSpatial (FeatureObject& spatialObj) {
-        auto& pos = objectsUnderSpatials.find (spatialObj.fidn);
+        auto pos = objectsUnderSpatials.find (spatialObj.fidn);
 
         return pos == objectsUnderSpatials.end () ? 0 : & pos->second;
     }
 };
+// Owns the charts; several cells often share the same compilation scale
 struct ChartCollection {
-    std::map<uint32_t, Chart *> charts;
+    std::multimap<uint32_t, Chart *> charts;
+
+    ChartCollection () {}
+    ChartCollection (const ChartCollection&) = delete;
+    ChartCollection& operator = (const ChartCollection&) = delete;
+
+    virtual ~ChartCollection () {
+        clear ();
+    }
 
     void addChart (Chart *chart) {
         uint32_t compilationScale = chart->params.compilationScale.value_or (0x7FFFFFFF);
 
         charts.emplace (std::pair<uint32_t, Chart *> (compilationScale, chart));
     }
+
+    void clear () {
+        for (auto& item: charts) delete item.second;
+
+        charts.clear ();
+    }
 };
 
 struct Environment {
@@ -384,8 +906,9 @@ struct Environment {
     AttrDictionary attrDictionary;
     Dai dai;
     ChartSettings settings;
+    bool fixedPointCoords;          // Load charts into fixed point coordinate pools
 
-    Environment () {
+    Environment (): fixedPointCoords (false) {
         initCSPs (*this);
     }
 
@@ -8,6 +8,18 @@
 
 PenTool Drawer::penTool;
 
+CspResult::~CspResult () {
+    clear ();
+}
+
+void CspResult::clear () {
+    for (auto drawer: drawers) delete drawer;
+
+    drawers.clear ();
+    edgePresentations.clear ();
+    recorded = false;
+}
+
 void LineDrawer::run (RECT& client, HDC paintDC, PaletteIndex paletteIndex, Palette& palette) {
     if (penIndex != LookupTableItem::NOT_EXIST) {
         paintLine (client, paintDC, penStyle, penWidth, penIndex, lat, lon, brg, rangeMm, view, paletteIndex, palette);
@@ -27,7 +39,7 @@ void PolyPolylineDrawer::run (RECT& client, HDC paintDC, PaletteIndex paletteInd
 }
 
 void PolyPolylineDrawer::addNode (size_t nodeIndex) {
-    auto& pos = chart.nodes [nodeIndex].points [0];
+    auto pos = chart.nodePosition (nodeIndex);
     addVertex (pos.lat, pos.lon);
 }
 
@@ -39,15 +51,15 @@ void PolyPolylineDrawer::addEdge (EdgeRef& edgeRef) {
     addContour ();
     if (edgeRef.unclockwise) {
         addNode (edge.endIndex);
-        for (auto pos = edge.internalNodes.rbegin (); pos != edge.internalNodes.rend (); ++ pos) {
-            addVertex (pos->lat, pos->lon);
-        }
+        chart.coords [edge.internalNodes].forEachReversed ([this] (const Position& pos) {
+            addVertex (pos.lat, pos.lon);
+        });
         addNode (edge.beginIndex);
     } else {
         addNode (edge.beginIndex);
-        for (auto pos: edge.internalNodes) {
+        chart.coords [edge.internalNodes].forEach ([this] (const Position& pos) {
             addVertex (pos.lat, pos.lon);
-        }
+        });
         addNode (edge.endIndex);
     }
 }
@@ -71,15 +83,15 @@ void PolyPolygonDrawer::addEdge (EdgeRef& edgeRef) {
     }
     if (edgeRef.unclockwise) {
         addNode (edge.endIndex);
-        for (auto pos = edge.internalNodes.rbegin (); pos != edge.internalNodes.rend (); ++ pos) {
-            addVertex (pos->lat, pos->lon);
-        }
+        chart.coords [edge.internalNodes].forEachReversed ([this] (const Position& pos) {
+            addVertex (pos.lat, pos.lon);
+        });
         addNode (edge.beginIndex);
     } else {
         addNode (edge.beginIndex);
-        for (auto pos: edge.internalNodes) {
+        chart.coords [edge.internalNodes].forEach ([this] (const Position& pos) {
             addVertex (pos.lat, pos.lon);
-        }
+        });
         addNode (edge.endIndex);
     }
 }
@@ -109,9 +121,9 @@ TextDrawer::TextDrawer (
             if (attr && !attr->noValue) {
                 char value [500];
                 switch (paramDesc.type) {
-                    case TextDesc::ParamType::INT_VAL: sprintf (value, paramDesc.format.c_str (), attr->intValue); break;
-                    case TextDesc::ParamType::FLOAT_VAL: sprintf (value, paramDesc.format.c_str (), attr->floatValue); break;
-                    case TextDesc::ParamType::STRING_VAL: strcpy (value, attr->strValue.c_str ()); break;
+                    case TextDesc::ParamType::INT_VAL: sprintf (value, paramDesc.format.c_str (), attr->intValue ()); break;
+                    case TextDesc::ParamType::FLOAT_VAL: sprintf (value, paramDesc.format.c_str (), attr->floatValue ()); break;
+                    case TextDesc::ParamType::STRING_VAL: strcpy (value, attr->strValue ()); break;
                     default: *value = '\0';
                 }
                 text += value;
@@ -227,9 +239,9 @@ std::string s57format (const char *format, std::vector<std::string>& args, Featu
                     auto attr = object->getAttr (args [argNum++].c_str (), attrDic);
                     if (attr && !attr->noValue) {
                         switch (argType) {
-                            case ArgType::Integral: sprintf (value, argFmt.c_str (), attr->intValue); break;
-                            case ArgType::Float: sprintf (value, argFmt.c_str (), attr->floatValue); break;
-                            case ArgType::String: sprintf (value, argFmt.c_str (), attr->strValue); break;
+                            case ArgType::Integral: sprintf (value, argFmt.c_str (), attr->intValue ()); break;
+                            case ArgType::Float: sprintf (value, argFmt.c_str (), attr->floatValue ()); break;
+                            case ArgType::String: sprintf (value, argFmt.c_str (), attr->strValue ()); break;
                             default: value [0] = '\0';
                         }
                     } else {
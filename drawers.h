@@ -5,6 +5,7 @@
 #include <Windows.h>
 #include "abstract_tools.h"
 #include "s57defs.h"
+#include "data.h"
 
 struct Drawer {
     size_t penIndex;
@@ -16,6 +17,9 @@ struct Drawer {
     
     virtual bool isSymbol () { return false; }
 
+    // Copy drawing on another view; drawers a CSP may queue must support it, 0 means the CSP result can't be reused
+    virtual Drawer *clone (View& _view) { return 0; }
+
     Drawer (
         size_t _penIndex,
         int _penStyle,
@@ -25,6 +29,7 @@ struct Drawer {
         double _lon,
         double _rangeMm
     ): penIndex (_penIndex), penStyle (_penStyle), penWidth (_penWidth), view (_view), lat (_lat), lon (_lon), rangeMm (_rangeMm) {}
+    virtual ~Drawer () {}
 
     virtual void run (RECT& client, HDC paintDC, PaletteIndex paletteIndex, Palette& palette) {}
 };
@@ -45,6 +50,10 @@ struct SymbolDrawer: Drawer {
         Dai& _dai
     ): Drawer (0, 0, 0, _view, _lat, _lon, 0.0), symbolIndex (_symbolIndex), dai (_dai), rotAngle (_rotAngle) {}
 
+    virtual Drawer *clone (View& _view) {
+        return new SymbolDrawer (_view, lat, lon, symbolIndex, rotAngle, dai);
+    }
+
     virtual void run (RECT& client, HDC paintDC, PaletteIndex paletteIndex, Palette& palette);
 };
 
@@ -64,6 +73,10 @@ struct CentralEdgeSymbolDrawer: Drawer {
         Dai& _dai
     ): Drawer (0, 0, 0, _view, 0.0, 0.0, 0.0), edgeIndex (_edgeIndex), symbolIndex (_symbolIndex), dai (_dai), chart (_chart) {}
 
+    virtual Drawer *clone (View& _view) {
+        return new CentralEdgeSymbolDrawer (chart, _view, symbolIndex, edgeIndex, dai);
+    }
+
     virtual void run (RECT& client, HDC paintDC, PaletteIndex paletteIndex, Palette& palette);
 };
 
@@ -100,6 +113,10 @@ struct LineDrawer: Drawer {
         double _rangeMm
     ): Drawer (_penIndex, _penStyle, _penWidth, _view, _lat, _lon, _rangeMm), brg (_brg) {}
 
+    virtual Drawer *clone (View& _view) {
+        return new LineDrawer (penIndex, penStyle, penWidth, _view, lat, lon, brg, rangeMm);
+    }
+
     virtual void run (RECT& client, HDC paintDC, PaletteIndex paletteIndex, Palette& palette);
 };
 
@@ -118,6 +135,10 @@ struct ArcDrawer: Drawer {
         double _end
     ): Drawer (_penIndex, _penStyle, _penWidth, _view, _centerLat, _centerLon, _radiusMm), start (_start), end (_end) {}
 
+    virtual Drawer *clone (View& _view) {
+        return new ArcDrawer (penIndex, penStyle, penWidth, _view, lat, lon, rangeMm, start, end);
+    }
+
     virtual void run (RECT& client, HDC paintDC, PaletteIndex paletteIndex, Palette& palette);
 };
 
@@ -180,6 +201,9 @@ struct DrawQueue {
     Dai& dai;
     RECT& client;
     AttrDictionary& attrDic;
+    EdgePresentations edgePresentations;    // Assigned by CSPs, kept for the whole render unlike the drawers
+    size_t recordStart;                     // First drawer queued by the CSP being recorded
+    bool symbolsPurged;                     // The CSP being recorded removed the symbols queued before
 
     DrawQueue (
         RECT& _client, 
@@ -188,7 +212,7 @@ struct DrawQueue {
         Dai& _dai,
         AttrDictionary& _attrDic,
         View& _view
-    ): paintDC (_paintDC), paletteIndex (_paletteIndex), dai (_dai), view (_view), client (_client), attrDic (_attrDic) {}
+    ): paintDC (_paintDC), paletteIndex (_paletteIndex), dai (_dai), view (_view), client (_client), attrDic (_attrDic), recordStart (0), symbolsPurged (false) {}
 
     virtual ~DrawQueue () {
         clear ();
@@ -234,12 +258,19 @@ struct DrawQueue {
     void addEdgeChain (int penIndex, int penStyle, int penWidth, Chart& chart);
     void addEdge (struct EdgeRef& edgeRef);
     void addArea (size_t fillBrushIndex, size_t patternBrushIndex, Chart& chart);
+    void startRecording () {
+        recordStart = container.size ();
+        symbolsPurged = false;
+    }
     void removeAllSymbols () {
+        symbolsPurged = true;
+
         for (int i = container.size () - 1; i >= 0; --i) {
             auto drawer = container [i];
             if (drawer->isSymbol ()) {
                 container.erase (container.begin () + i);
                 delete drawer;
+                if ((size_t) i < recordStart) -- recordStart;
             }
         }
     }
@@ -0,0 +1,309 @@
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <Windows.h>
+#include "chart_cache.h"
+#include "crc32.h"
+#include "exchange_set.h"
+#include "parser.h"
+#include "work_pool.h"
+
+static bool isBaseCell (const std::string& fileName) {
+    return fileName.length () > 4 && fileName.compare (fileName.length () - 4, 4, ".000") == 0;
+}
+
+static uint64_t getFileSize (const char *path) {
+    HANDLE file = CreateFileA (path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    LARGE_INTEGER fileSize;
+
+    if (file == INVALID_HANDLE_VALUE) return 0;
+
+    if (!GetFileSizeEx (file, & fileSize)) fileSize.QuadPart = 0;
+
+    CloseHandle (file);
+
+    return (uint64_t) fileSize.QuadPart;
+}
+
+// Limits amount of cell data being decoded at the same time. A single cell bigger than the limit is still let through
+// when nothing else is in flight, otherwise it would never be loaded.
+struct InFlightLimit {
+    std::mutex lock;
+    std::condition_variable released;
+    uint64_t limit;
+    uint64_t bytesInFlight;
+
+    InFlightLimit (uint64_t _limit): limit (_limit), bytesInFlight (0) {}
+
+    void acquire (uint64_t size) {
+        std::unique_lock<std::mutex> guard (lock);
+
+        if (limit) released.wait (guard, [this, size] () { return bytesInFlight == 0 || bytesInFlight + size <= limit; });
+
+        bytesInFlight += size;
+    }
+    void release (uint64_t size) {
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            bytesInFlight -= size;
+        }
+        released.notify_all ();
+    }
+};
+
+// Catalog file names are relative to the directory of the catalog
+static std::string getCatalogDirectory (const char *catalogPath) {
+    std::string basePath (catalogPath);
+    size_t separator = basePath.find_last_of ("\\/");
+
+    basePath.resize (separator == std::string::npos ? 0 : separator + 1);
+
+    return basePath;
+}
+
+// Fills the list of base cells referenced by the catalog and returns directory of the catalog
+static bool collectBaseCells (const char *catalogPath, std::vector<CatalogItem>& catalog, std::vector<CatalogItem *>& cells, std::string& basePath) {
+    if (!parseCatalog (catalogPath, catalog)) return false;
+
+    basePath = getCatalogDirectory (catalogPath);
+
+    for (auto& item: catalog) {
+        if (isBaseCell (item.fileName)) cells.push_back (& item);
+    }
+
+    return true;
+}
+
+size_t loadExchangeSet (
+    const char *catalogPath,
+    ChartCollection& collection,
+    Environment& env,
+    std::vector<CellLoadReport>& reports,
+    size_t numOfThreads,
+    uint64_t maxBytesInFlight,
+    bool verifyCrc
+) {
+    std::vector<CatalogItem> catalog;
+    std::vector<CatalogItem *> cells;
+    std::vector<PoolTask> tasks;
+    std::mutex collectionLock;
+    InFlightLimit inFlight (maxBytesInFlight);
+    std::string basePath;
+    size_t numOfLoaded = 0;
+
+    reports.clear ();
+
+    if (!collectBaseCells (catalogPath, catalog, cells, basePath)) return 0;
+
+    reports.resize (cells.size ());
+    tasks.reserve (cells.size ());
+
+    for (size_t i = 0; i < cells.size (); ++ i) {
+        tasks.emplace_back ([&, i] () {
+            auto& report = reports [i];
+            auto cell = cells [i];
+            auto startedAt = std::chrono::steady_clock::now ();
+            std::string path = basePath + cell->fileName;
+            uint64_t size = getFileSize (path.c_str ());
+            Chart *chart = new Chart;
+
+            report.fileName = cell->fileName;
+
+            inFlight.acquire (size);
+
+            report.loaded = size > 0 && loadChart (path.c_str (), *chart, env, 0, cell->crc.has_value () ? cell->crc.value ().c_str () : 0, verifyCrc);
+
+            inFlight.release (size);
+
+            if (report.loaded) {
+                std::lock_guard<std::mutex> guard (collectionLock);
+
+                collection.addChart (chart);
+                ++ numOfLoaded;
+            } else {
+                report.error = size > 0 ? (verifyCrc ? "Unable to decode the cell or CRC mismatch" : "Unable to decode the cell") : "Unable to open the cell";
+                delete chart;
+            }
+
+            report.milliseconds = std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - startedAt).count ();
+        });
+    }
+
+    runWorkStealing (tasks, numOfThreads);
+
+    return numOfLoaded;
+}
+
+typedef std::chrono::steady_clock Clock;
+
+static double msSince (Clock::time_point& startedAt) {
+    auto now = Clock::now ();
+    double result = std::chrono::duration<double, std::milli> (now - startedAt).count ();
+
+    startedAt = now;
+
+    return result;
+}
+
+// Touches every page of the mapping so the decode stage doesn't stall on page faults
+static void prefetchPages (MappedFile& file) {
+    static const size_t PAGE_SIZE = 4096;
+    volatile char sink = 0;
+
+    for (size_t offset = 0; offset < file.size; offset += PAGE_SIZE) sink += file.data [offset];
+}
+
+struct CellJob {
+    size_t index;
+    std::string path;
+    const char *crc;
+    Chart *chart;
+    bool fromCache;
+    std::unique_ptr<MappedS57File> file;
+    std::vector<RecordView> records;
+    std::string error;
+    Clock::time_point startedAt;
+
+    CellJob (): index (0), crc (0), chart (0), fromCache (false) {}
+};
+
+typedef BoundedQueue<std::unique_ptr<CellJob>> CellQueue;
+
+// Passes cells from the input to the output queue through process (), accounting where the stage thread spends time
+template<typename Process> static void runStage (CellQueue& input, CellQueue& output, PipelineStageStats& stageStats, Process process) {
+    Clock::time_point stamp = Clock::now ();
+    std::unique_ptr<CellJob> job;
+
+    while (input.pop (job)) {
+        stageStats.starvedMs += msSince (stamp);
+
+        process (*job);
+
+        stageStats.busyMs += msSince (stamp);
+        output.push (std::move (job));
+        stageStats.blockedMs += msSince (stamp);
+        ++ stageStats.numOfItems;
+    }
+
+    stageStats.starvedMs += msSince (stamp);
+    stageStats.avgQueueLength = input.averageLength ();
+    stageStats.maxQueueLength = input.maxLength;
+    output.close ();
+}
+
+size_t loadExchangeSetPipelined (
+    const char *catalogPath,
+    ChartCollection& collection,
+    Environment& env,
+    std::vector<CellLoadReport>& reports,
+    PipelineStats& stats,
+    size_t queueCapacity,
+    bool verifyCrc
+) {
+    std::vector<CatalogItem> catalog;
+    std::vector<CatalogItem *> cells;
+    std::string basePath;
+    CellQueue decodeQueue (queueCapacity), extractQueue (queueCapacity), updateQueue (queueCapacity), doneQueue (queueCapacity);
+    size_t numOfLoaded = 0;
+    Clock::time_point startedAt = Clock::now ();
+
+    reports.clear ();
+    stats = PipelineStats ();
+
+    if (!collectBaseCells (catalogPath, catalog, cells, basePath)) return 0;
+
+    reports.resize (cells.size ());
+
+    std::thread ioStage ([&] () {
+        Clock::time_point stamp = Clock::now ();
+
+        for (size_t i = 0; i < cells.size (); ++ i) {
+            auto job = std::make_unique<CellJob> ();
+
+            job->index = i;
+            job->path = basePath + cells [i]->fileName;
+            job->crc = cells [i]->crc.has_value () ? cells [i]->crc.value ().c_str () : 0;
+            job->chart = new Chart;
+            job->chart->coords.preferFixedPoint = env.fixedPointCoords;
+            job->startedAt = Clock::now ();
+
+            if (!verifyCrc && loadChartCache (job->path.c_str (), job->crc, *job->chart)) {
+                job->fromCache = true;
+            } else {
+                job->file = std::make_unique<MappedS57File> ();
+
+                if (!job->file->open (job->path.c_str ())) {
+                    job->error = "Unable to open the cell";
+                } else if (!verifyCrc) {
+                    prefetchPages (job->file->file);
+                } else if (!isCrcValid (job->file->file, job->crc)) {
+                    job->error = "CRC mismatch";
+                }
+            }
+
+            stats.io.busyMs += msSince (stamp);
+            decodeQueue.push (std::move (job));
+            stats.io.blockedMs += msSince (stamp);
+            ++ stats.io.numOfItems;
+        }
+
+        decodeQueue.close ();
+    });
+
+    // Record directories and field views into the per-cell record buffer, no chart objects yet
+    std::thread decodeStage ([&] () {
+        runStage (decodeQueue, extractQueue, stats.decode, [] (CellJob& job) {
+            if (!job.fromCache && job.error.empty () && decodeRecords (*job.file, job.records) == 0) job.error = "Unable to decode the cell";
+        });
+    });
+
+    // Chart objects from the decoded records and derived data
+    std::thread extractStage ([&] () {
+        runStage (extractQueue, updateQueue, stats.extract, [&env] (CellJob& job) {
+            if (!job.fromCache && job.error.empty ()) {
+                extractChart (job.file->program, job.records, *job.chart);
+                completeChart (job.path.c_str (), job.crc, *job.chart, env);
+            }
+
+            // Record views point into the mapping, release both as soon as the chart is built
+            job.records.clear ();
+            job.file.reset ();
+        });
+    });
+
+    std::thread updateStage ([&] () {
+        runStage (updateQueue, doneQueue, stats.update, [&env] (CellJob& job) {
+            if (job.error.empty ()) applyChartUpdates (job.path.c_str (), *job.chart, env);
+        });
+    });
+
+    // The calling thread only takes the finished charts over
+    std::unique_ptr<CellJob> job;
+
+    while (doneQueue.pop (job)) {
+        auto& report = reports [job->index];
+
+        report.fileName = cells [job->index]->fileName;
+        report.loaded = job->error.empty ();
+
+        if (report.loaded) {
+            collection.addChart (job->chart);
+            ++ numOfLoaded;
+        } else {
+            report.error = job->error;
+            delete job->chart;
+        }
+
+        report.milliseconds = std::chrono::duration<double, std::milli> (Clock::now () - job->startedAt).count ();
+    }
+
+    ioStage.join ();
+    decodeStage.join ();
+    extractStage.join ();
+    updateStage.join ();
+
+    stats.totalMs = msSince (startedAt);
+
+    return numOfLoaded;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "data.h"
+
+struct CellLoadReport {
+    std::string fileName;
+    bool loaded;
+    std::string error;
+    double milliseconds;
+
+    CellLoadReport (): loaded (false), milliseconds (0.0) {}
+};
+
+struct CellCheckReport {
+    std::string fileName;
+    bool valid;
+    std::string error;
+    uint32_t expectedCrc;
+    uint32_t actualCrc;
+    double milliseconds;
+
+    CellCheckReport (): valid (false), expectedCrc (0), actualCrc (0), milliseconds (0.0) {}
+};
+
+// Loads every base cell (.000) of the exchange set referenced by the catalog into the collection.
+// Cells are spread over a work stealing pool; a worker waits before mapping the next cell while more than
+// maxBytesInFlight of cell files are being decoded (0 means no limit). With verifyCrc cells are checked against
+// CRCS while loading and rejected on mismatch. Returns number of cells loaded.
+size_t loadExchangeSet (
+    const char *catalogPath,
+    ChartCollection& collection,
+    Environment& env,
+    std::vector<CellLoadReport>& reports,
+    size_t numOfThreads = 0,
+    uint64_t maxBytesInFlight = 0,
+    bool verifyCrc = false
+);
+
+// Checks every file having CRCS in the catalog, files are processed concurrently. Returns number of valid files.
+size_t verifyExchangeSet (const char *catalogPath, std::vector<CellCheckReport>& reports, size_t numOfThreads = 0);
+
+struct PipelineStageStats {
+    size_t numOfItems;
+    double busyMs;              // Processing items
+    double starvedMs;           // Waiting for the previous stage
+    double blockedMs;           // Waiting for room in the next stage queue
+    double avgQueueLength;      // Input queue length sampled at every push
+    size_t maxQueueLength;
+
+    PipelineStageStats (): numOfItems (0), busyMs (0.0), starvedMs (0.0), blockedMs (0.0), avgQueueLength (0.0), maxQueueLength (0) {}
+};
+
+struct PipelineStats {
+    PipelineStageStats io, decode, extract, update;
+    double totalMs;
+
+    PipelineStats (): totalMs (0.0) {}
+};
+
+// Same as loadExchangeSet but each cell goes through four stages running concurrently on own threads:
+// I/O (cache lookup, mapping and page prefetch), decode (record directories and field views), extraction (chart objects
+// and derived data) and update (update files). The calling thread only adds finished charts to the collection.
+// Stages are connected by queues holding at most queueCapacity cells, stats show which stage is the bottleneck. With
+// verifyCrc the I/O stage computes the cell CRC instead of plain page prefetch, so verification costs no extra read.
+size_t loadExchangeSetPipelined (
+    const char *catalogPath,
+    ChartCollection& collection,
+    Environment& env,
+    std::vector<CellLoadReport>& reports,
+    PipelineStats& stats,
+    size_t queueCapacity = 4,
+    bool verifyCrc = false
+);
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <ctype.h>
+#include <charconv>
+
+// Text values of ISO 8211 fields and subfields; no Windows dependency so the parsers can be tested standalone
+
+inline uint32_t parseField (char *field, size_t size) {
+    uint32_t result = 0;
+
+    for (size_t i = 0; i < size; ++ i) {
+        result *= 10;
+        result += field [i] - '0';
+    }
+
+    return result;
+}
+
+// atoi-like parsing bounded by size, the text doesn't need to be zero terminated. Values out of the int32_t range
+// saturate like strtol does, fields come from files and may hold any number of digits
+inline int32_t parseSignedField (const char *field, size_t size) {
+    size_t i = 0;
+    bool negative = false;
+    int64_t result = 0;
+
+    while (i < size && field [i] == ' ') ++ i;
+
+    if (i < size && (field [i] == '-' || field [i] == '+')) negative = field [i++] == '-';
+
+    int64_t limit = negative ? - (int64_t) INT32_MIN : INT32_MAX;
+
+    for (; i < size && isdigit ((uint8_t) field [i]); ++ i) {
+        result = result * 10 + (field [i] - '0');
+
+        if (result > limit) {
+            result = limit; break;
+        }
+    }
+
+    return (int32_t) (negative ? - result : result);
+}
+
+// atof-like parsing bounded by size and independent of the current locale. Up to 15 significant digits with a short
+// decimal exponent are converted exactly by a single multiplication/division, anything longer goes to std::from_chars
+inline double parseFloatField (const char *field, size_t size) {
+    static const double powersOf10 [] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    size_t i = 0;
+    bool negative = false;
+    uint64_t mantissa = 0;
+    int numOfDigits = 0;
+    int exponent = 0;
+
+    while (i < size && field [i] == ' ') ++ i;
+
+    if (i < size && (field [i] == '-' || field [i] == '+')) negative = field [i++] == '-';
+
+    size_t numberStart = i;
+
+    for (; i < size && isdigit ((uint8_t) field [i]); ++ i) {
+        if (numOfDigits < 19) {
+            mantissa = mantissa * 10 + (field [i] - '0');
+            if (mantissa) ++ numOfDigits;
+        } else {
+            ++ exponent;
+        }
+    }
+
+    if (i < size && field [i] == '.') {
+        for (++ i; i < size && isdigit ((uint8_t) field [i]); ++ i) {
+            if (numOfDigits < 19) {
+                mantissa = mantissa * 10 + (field [i] - '0');
+                if (mantissa) ++ numOfDigits;
+                -- exponent;
+            }
+        }
+    }
+
+    // Any number of zeros is zero whatever the exponent; inf and nan have no digits and go to from_chars
+    if (mantissa == 0 && i > numberStart) return negative ? -0.0 : 0.0;
+
+    bool hasExponent = i < size && (field [i] == 'e' || field [i] == 'E');
+
+    if (mantissa != 0 && !hasExponent && numOfDigits <= 15 && exponent >= -22 && exponent <= 22) {
+        double result = (double) mantissa;
+
+        result = exponent < 0 ? result / powersOf10 [- exponent] : result * powersOf10 [exponent];
+
+        return negative ? - result : result;
+    }
+
+    double result = 0.0;
+
+    std::from_chars (field + numberStart, field + size, result);
+
+    return negative ? - result : result;
+}
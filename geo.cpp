@@ -134,8 +134,8 @@ void calcSphericalPos (double lat, double lon, double bearing, double range, dou
 }
 
 void composeAreaMetrics (FeatureObject *object, Chart& chart, Contours& metrics) {
-    Nodes& nodes = chart.nodes;
     Edges& edges = chart.edges;
+    CoordPool& coords = chart.coords;
     bool hole = false;
 
     auto isLastContourClosed = [&metrics] () {
@@ -149,11 +149,11 @@ void composeAreaMetrics (FeatureObject *object, Chart& chart, Contours& metrics)
     auto addVertex = [&metrics] (double lat, double lon) {
         metrics.back ().emplace_back (lat, lon);
     };
-    auto addNode = [&nodes, &addVertex] (size_t nodeIndex) {
-        auto& pos = nodes [nodeIndex].points [0];
+    auto addNode = [&chart, &addVertex] (size_t nodeIndex) {
+        auto pos = chart.nodePosition (nodeIndex);
         addVertex (pos.lat, pos.lon);
     };
-    auto addEdge = [&edges, &metrics, &hole, &isLastContourClosed, &addNode, &addVertex] (EdgeRef& edgeRef) {
+    auto addEdge = [&edges, &coords, &metrics, &hole, &isLastContourClosed, &addNode, &addVertex] (EdgeRef& edgeRef) {
         if (edgeRef.hidden) return;
 
         auto& edge = edges.container [edgeRef.index];
@@ -168,15 +168,15 @@ void composeAreaMetrics (FeatureObject *object, Chart& chart, Contours& metrics)
         }
         if (edgeRef.unclockwise) {
             addNode (edge.endIndex);
-            for (auto pos = edge.internalNodes.rbegin (); pos != edge.internalNodes.rend (); ++ pos) {
-                addVertex (pos->lat, pos->lon);
-            }
+            coords [edge.internalNodes].forEachReversed ([&addVertex] (const Position& pos) {
+                addVertex (pos.lat, pos.lon);
+            });
             addNode (edge.beginIndex);
         } else {
             addNode (edge.beginIndex);
-            for (auto pos: edge.internalNodes) {
+            coords [edge.internalNodes].forEach ([&addVertex] (const Position& pos) {
                 addVertex (pos.lat, pos.lon);
-            }
+            });
             addNode (edge.endIndex);
         }
     };
@@ -200,15 +200,15 @@ void composeAreaMetrics (FeatureObject *object, Chart& chart, Contours& metrics)
         }
         if (edgeRef.unclockwise) {
             addNode (edge.endIndex);
-            for (auto pos = edge.internalNodes.rbegin (); pos != edge.internalNodes.rend (); ++ pos) {
-                addVertex (pos->lat, pos->lon);
-            }
+            coords [edge.internalNodes].forEachReversed ([&addVertex] (const Position& pos) {
+                addVertex (pos.lat, pos.lon);
+            });
             addNode (edge.beginIndex);
         } else {
             addNode (edge.beginIndex);
-            for (auto pos: edge.internalNodes) {
+            coords [edge.internalNodes].forEach ([&addVertex] (const Position& pos) {
                 addVertex (pos.lat, pos.lon);
-            }
+            });
             addNode (edge.endIndex);
         }
     }
@@ -227,6 +227,22 @@ void getBoundingRect (Contour& contour, double& northmost, double& southmost, do
     }
 }
 
+void getBoundingRect (FixedContour& contour, double coordMultiplier, double& northmost, double& southmost, double& westmost, double& eastmost) {
+    int32_t north = INT32_MIN, south = INT32_MAX, west = INT32_MAX, east = INT32_MIN;
+
+    for (auto& pt: contour) {
+        north = max (north, pt.lat);
+        south = min (south, pt.lat);
+        west = min (west, pt.lon);
+        east = max (east, pt.lon);
+    }
+
+    northmost = (double) north / coordMultiplier;
+    southmost = (double) south / coordMultiplier;
+    westmost = (double) west / coordMultiplier;
+    eastmost = (double) east / coordMultiplier;
+}
+
 std::tuple<double, double> crossTwoLines (double x11, double y11, double x12, double y12, double x21, double y21, double x22, double y22) {
     double c1 = (y12 - y11) / (x12 - x11);
     double c2 = (y22 - y21) / (x22 - x21);
@@ -260,14 +276,56 @@ bool isPointInsideContour (double lat, double lon, Contour& contour) {
     return crossCount & 1;
 }
 
+// Crossing number test against a ray going west. Coordinate differences are limited by 360 degrees at the largest
+// allowed COMF so the products fit into 64 bits.
+bool isPointInsideContour (int32_t lat, int32_t lon, FixedContour& contour) {
+    bool inside = false;
+
+    for (size_t i = 0, j = contour.size () - 1; i < contour.size (); j = i ++) {
+        int64_t lat1 = contour [j].lat, lon1 = contour [j].lon;
+        int64_t lat2 = contour [i].lat, lon2 = contour [i].lon;
+
+        if ((lat1 > lat) == (lat2 > lat)) continue;
+
+        // Crossing longitude is west of the point when (lon - lon1) * dLat > (lat - lat1) * dLon, sign adjusted by dLat
+        int64_t left = (lon - lon1) * (lat2 - lat1);
+        int64_t right = (lat - lat1) * (lon2 - lon1);
+
+        if (lat2 > lat1 ? left > right : left < right) inside = !inside;
+    }
+
+    return inside;
+}
+
 AreaTopology& checkAddAreaTopology (FeatureObject& area, Chart& chart) {
     auto pos = chart.areaTopologyMap.find (area.fidn);
 
     if (pos == chart.areaTopologyMap.end ()) {
         pos = chart.areaTopologyMap.emplace (area.fidn, AreaTopology ()).first;
-        composeAreaMetrics (& area, chart, pos->second.metrics);
-        if (!pos->second.metrics.empty ()) {
-            getBoundingRect (pos->second.metrics.front (), pos->second.northmost, pos->second.southmost, pos->second.westmost, pos->second.eastmost);
+        auto& topology = pos->second;
+
+        composeAreaMetrics (& area, chart, topology.metrics);
+
+        if (chart.coords.fixedPoint && !topology.metrics.empty ()) {
+            double multiplier = chart.coords.coordMultiplier;
+
+            topology.coordMultiplier = multiplier;
+            topology.fixedMetrics.reserve (topology.metrics.size ());
+
+            for (auto& contour: topology.metrics) {
+                auto& fixedContour = topology.fixedMetrics.emplace_back ();
+
+                fixedContour.reserve (contour.size ());
+
+                for (auto& vertex: contour) {
+                    fixedContour.emplace_back ((int32_t) lround (vertex.lat * multiplier), (int32_t) lround (vertex.lon * multiplier));
+                }
+            }
+
+            Contours ().swap (topology.metrics);
+            getBoundingRect (topology.fixedMetrics.front (), multiplier, topology.northmost, topology.southmost, topology.westmost, topology.eastmost);
+        } else if (!topology.metrics.empty ()) {
+            getBoundingRect (topology.metrics.front (), topology.northmost, topology.southmost, topology.westmost, topology.eastmost);
         }
     }
     return pos->second;
@@ -276,7 +334,7 @@ AreaTopology& checkAddAreaTopology (FeatureObject& area, Chart& chart) {
 void addSpatialsUnderPoint (FeatureObject& point, Chart& chart, SpatialsUnderObject& areasUnderPoint) {
     for (size_t i = 0; i < chart.features.container.size (); ++ i) {
         auto& object = chart.features.container [i];
-        if (object.primitive != 3 && object.group != 2) continue;
+        if (object.isDeleted () || (object.primitive != 3 && object.group != 2)) continue;
         /*switch (object.classCode) {
             case OBJ_CLASSES::DEPARE:
             case OBJ_CLASSES::UNSARE:
@@ -287,7 +345,7 @@ void addSpatialsUnderPoint (FeatureObject& point, Chart& chart, SpatialsUnderObj
         }*/
 
         auto& areaTopology = checkAddAreaTopology (object, chart);
-        auto& pos = chart.nodes [point.nodeIndex].points.front ();
+        auto pos = chart.nodePosition (point.nodeIndex);
 
         if (areaTopology.isPointInside (pos.lat, pos.lon)) {
             auto& info = areasUnderPoint.emplace_back ();
@@ -298,8 +356,8 @@ void addSpatialsUnderPoint (FeatureObject& point, Chart& chart, SpatialsUnderObj
             auto drval1 = object.getAttr (ATTRS::DRVAL1);
             auto drval2 = object.getAttr (ATTRS::DRVAL2);
 
-            if (drval1 && !drval1->noValue) info.depthRangeValue1 = drval1->floatValue;
-            if (drval2 && !drval2->noValue) info.depthRangeValue2 = drval2->floatValue;
+            if (drval1 && !drval1->noValue) info.depthRangeValue1 = drval1->floatValue ();
+            if (drval2 && !drval2->noValue) info.depthRangeValue2 = drval2->floatValue ();
         }
     }
 }
@@ -307,7 +365,7 @@ void addSpatialsUnderPoint (FeatureObject& point, Chart& chart, SpatialsUnderObj
 void addSpatialsUnderSpatial (FeatureObject& spatialObj, Chart& chart, SpatialsUnderObject& areasUnderObject) {
     for (size_t i = 0; i < chart.features.container.size (); ++ i) {
         auto& object = chart.features.container [i];
-        if (object.primitive == 1 || object.primitive == 4 || object.group != 1) continue;
+        if (object.isDeleted () || object.primitive == 1 || object.primitive == 4 || object.group != 1) continue;
 
         auto& objectTopology = checkAddAreaTopology (spatialObj, chart);
         auto& areaTopology = checkAddAreaTopology (object, chart);
@@ -321,12 +379,24 @@ void addSpatialsUnderSpatial (FeatureObject& spatialObj, Chart& chart, SpatialsU
             auto drval1 = object.getAttr (ATTRS::DRVAL1);
             auto drval2 = object.getAttr (ATTRS::DRVAL2);
 
-            if (drval1 && !drval1->noValue) info.depthRangeValue1 = drval1->floatValue;
-            if (drval2 && !drval2->noValue) info.depthRangeValue2 = drval2->floatValue;
+            if (drval1 && !drval1->noValue) info.depthRangeValue1 = drval1->floatValue ();
+            if (drval2 && !drval2->noValue) info.depthRangeValue2 = drval2->floatValue ();
         }
     }
 }
 
+static bool isUnproperObject (FeatureObject& object) {
+    switch (object.classCode) {
+        case OBJ_CLASSES::SOUNDG:
+        case OBJ_CLASSES::UWTROC:
+        case OBJ_CLASSES::WRECKS:
+        case OBJ_CLASSES::OBSTRN:
+            return false;
+        default:
+            return true;
+    }
+}
+
 void buildPointLocationInfo (Chart& chart) {
     Features& features = chart.features;
     Edges& edges = chart.edges;
@@ -336,20 +406,8 @@ void buildPointLocationInfo (Chart& chart) {
     chart.objectsUnderPoints.clear ();
     chart.objectsUnderSpatials.clear ();
 
-    auto isUnproperObject = [] (FeatureObject& object) {
-        switch (object.classCode) {
-            case OBJ_CLASSES::SOUNDG:
-            case OBJ_CLASSES::UWTROC:
-            case OBJ_CLASSES::WRECKS:
-            case OBJ_CLASSES::OBSTRN:
-                return false;
-            default:
-                return true;
-        }
-    };
-
     for (auto& object: features.container) {
-        if (isUnproperObject (object)) continue;
+        if (object.isDeleted () || isUnproperObject (object)) continue;
 
         if (object.primitive == 1 || object.primitive == 4) {
             auto& item = chart.objectsUnderPoints.emplace (object.fidn, SpatialsUnderObject ()).first->second;
@@ -363,11 +421,116 @@ void buildPointLocationInfo (Chart& chart) {
     }
 }
 
-void getCenterPos (FeatureObject& object, Chart& chart, double& lat, double& lon) {
+// Incremental version of buildPointLocationInfo () used after applying an update.
+// Area topology is dropped for the changed features only and rebuilt lazily; a point list is rebuilt if the point itself
+// has changed, it referred to a changed area or it falls into a changed area now.
+void updatePointLocationInfo (Chart& chart, std::set<size_t>& changedFeatures) {
+    Features& features = chart.features;
+    std::set<size_t> changedAreas;
+
+    for (size_t index: changedFeatures) {
+        auto& object = features [index];
+
+        chart.areaTopologyMap.erase (object.fidn);
+
+        if (object.isDeleted () || object.primitive == 3 || object.group == 2) changedAreas.insert (index);
+    }
+
+    for (size_t i = 0; i < features.size (); ++ i) {
+        auto& object = features [i];
+        bool pointChanged = changedFeatures.find (i) != changedFeatures.end ();
+
+        if (object.primitive != 1 && object.primitive != 4) continue;
+
+        if (object.isDeleted () || isUnproperObject (object) || object.nodeIndex >= chart.nodes.size () || chart.nodes [object.nodeIndex].points.empty ()) {
+            if (pointChanged) chart.objectsUnderPoints.erase (object.fidn);
+            continue;
+        }
+
+        auto& item = chart.objectsUnderPoints.emplace (object.fidn, SpatialsUnderObject ()).first->second;
+        bool rebuild = pointChanged;
+
+        for (size_t j = 0; !rebuild && j < item.size (); ++ j) {
+            rebuild = changedAreas.find (item [j].areaIndex) != changedAreas.end ();
+        }
+
+        if (!rebuild) {
+            auto pos = chart.nodePosition (object.nodeIndex);
+
+            for (size_t areaIndex: changedAreas) {
+                auto& area = features [areaIndex];
+
+                if (area.isDeleted () || (area.primitive != 3 && area.group != 2)) continue;
+
+                if (checkAddAreaTopology (area, chart).isPointInside (pos.lat, pos.lon)) {
+                    rebuild = true; break;
+                }
+            }
+        }
+
+        if (rebuild) {
+            item.clear ();
+            addSpatialsUnderPoint (object, chart, item);
+        }
+    }
+}
+
+void buildFeatureTable (Chart& chart) {
+    Features& features = chart.features;
     Nodes& nodes = chart.nodes;
+    FeatureTable& table = chart.featureTable;
+    size_t numOfFeatures = features.size ();
+
+    table.primitive.resize (numOfFeatures);
+    table.group.resize (numOfFeatures);
+    table.classCode.resize (numOfFeatures);
+    table.north.resize (numOfFeatures);
+    table.south.resize (numOfFeatures);
+    table.west.resize (numOfFeatures);
+    table.east.resize (numOfFeatures);
+
+    for (size_t i = 0; i < numOfFeatures; ++ i) {
+        auto& feature = features [i];
+        double north = -1000.0, south = 1000.0, west = 1000.0, east = -1000.0;
+
+        auto addPos = [&north, &south, &west, &east] (Position pos) {
+            if (pos.lat > north) north = pos.lat;
+            if (pos.lat < south) south = pos.lat;
+            if (pos.lon < west) west = pos.lon;
+            if (pos.lon > east) east = pos.lon;
+        };
+        auto addNode = [&chart, &nodes, &addPos] (size_t nodeIndex) {
+            if (nodeIndex >= nodes.size ()) return;
+
+            chart.points (nodes [nodeIndex]).forEach (addPos);
+        };
+
+        if (feature.primitive == 1 || feature.primitive == 4) {
+            addNode (feature.nodeIndex);
+        } else if (feature.primitive == 2 || feature.primitive == 3) {
+            for (auto& edgeRef: feature.edgeRefs) {
+                auto& edge = chart.edges [edgeRef.index];
+
+                addNode (edge.beginIndex);
+                addNode (edge.endIndex);
+
+                chart.internalNodes (edge).forEach (addPos);
+            }
+        }
+
+        table.primitive [i] = feature.isDeleted () ? PRIM::None : feature.primitive;
+        table.group [i] = feature.group;
+        table.classCode [i] = feature.classCode;
+        table.north [i] = (float) north;
+        table.south [i] = (float) south;
+        table.west [i] = (float) west;
+        table.east [i] = (float) east;
+    }
+}
 
+void getCenterPos (FeatureObject& object, Chart& chart, double& lat, double& lon) {
     if (object.primitive == 1 || object.primitive == 4) {
-        auto& pos = nodes [object.nodeIndex].points.front ();
+        auto pos = chart.nodePosition (object.nodeIndex);
         lat = pos.lat;
         lon = pos.lon;
     } else {
@@ -377,15 +540,15 @@ void getCenterPos (FeatureObject& object, Chart& chart, double& lat, double& lon
         size_t count = 0;
         for (auto& edgeRef: object.edgeRefs) {
             auto& edge = edges.container [edgeRef.index];
-            auto& begin = nodes.container [edge.beginIndex].points [0];
-            auto& end = nodes.container [edge.endIndex].points [0];
+            auto begin = chart.nodePosition (edge.beginIndex);
+            auto end = chart.nodePosition (edge.endIndex);
             sumLat += begin.lat + end.lat;
             sumLon += begin.lon + end.lon;
 
-            for (auto& pos: edge.internalNodes) {
+            chart.internalNodes (edge).forEach ([&sumLat, &sumLon] (const Position& pos) {
                 sumLat += pos.lat;
                 sumLon += pos.lon;
-            }
+            });
 
             count += 2 + edge.internalNodes.size ();
         }
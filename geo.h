@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
+#include <cmath>
 #include <vector>
 #include <map>
+#include <set>
 #include <tuple>
 #include <optional>
 
@@ -35,6 +38,15 @@ struct Vertex {
 typedef std::vector<Vertex> Contour;
 typedef std::vector<Contour> Contours;
 
+// Vertex in units of the cell COMF
+struct FixedVertex {
+    int32_t lat, lon;
+    FixedVertex (int32_t _lat, int32_t _lon): lat (_lat), lon (_lon) {}
+};
+
+typedef std::vector<FixedVertex> FixedContour;
+typedef std::vector<FixedContour> FixedContours;
+
 void geoToXY (double lat, double lon, int zoom, int& x, int& y);
 void xyToGeo (int x, int y, int zoom, double& lat, double& lon);
 
@@ -64,13 +76,34 @@ inline bool isAngleBetween (double angle, double a, double b) {
 }
 
 bool isPointInsideContour (double lat, double lon, Contour& contour);
+bool isPointInsideContour (int32_t lat, int32_t lon, FixedContour& contour);
 
 struct AreaTopology {
     Contours metrics;
+    FixedContours fixedMetrics;     // Used instead of metrics for charts kept in fixed point
+    double coordMultiplier;         // Scale of fixedMetrics
     double northmost, southmost, westmost, eastmost;
 
+    AreaTopology (): coordMultiplier (0.0), northmost (0.0), southmost (0.0), westmost (0.0), eastmost (0.0) {}
+
+    bool isFixedPoint () { return !fixedMetrics.empty (); }
+
     bool isPointInside (double lat, double lon) {
         if (lat > northmost || lat < southmost || lon < westmost || lon > eastmost) return false;
+
+        if (isFixedPoint ()) {
+            int32_t fixedLat = (int32_t) lround (lat * coordMultiplier);
+            int32_t fixedLon = (int32_t) lround (lon * coordMultiplier);
+
+            if (!isPointInsideContour (fixedLat, fixedLon, fixedMetrics.front ())) return false;
+
+            for (size_t i = 1; i < fixedMetrics.size (); ++ i) {
+                if (isPointInsideContour (fixedLat, fixedLon, fixedMetrics [i])) return false;
+            }
+
+            return true;
+        }
+
         if (!isPointInsideContour (lat, lon, metrics.front ())) return false;
 
         for (size_t i = 1; i < metrics.size (); ++ i) {
@@ -86,7 +119,23 @@ struct AreaTopology {
             bool insideHole = false;
 
             for (size_t i = 1; i < metrics.size (); ++ i) {
-                if (isPointInsideContour (pt.lat, pt.lon, metrics.front ())) {
+                if (isPointInsideContour (pt.lat, pt.lon, metrics [i])) {
+                    insideHole = true; break;
+                }
+            }
+
+            if (!insideHole) return true;
+        }
+        return false;
+    }
+    bool isCrossedBy (FixedContour& contour) {
+        for (auto& pt: contour) {
+            if (!isPointInsideContour (pt.lat, pt.lon, fixedMetrics.front ())) continue;
+
+            bool insideHole = false;
+
+            for (size_t i = 1; i < fixedMetrics.size (); ++ i) {
+                if (isPointInsideContour (pt.lat, pt.lon, fixedMetrics [i])) {
                     insideHole = true; break;
                 }
             }
@@ -101,6 +150,9 @@ struct AreaTopology {
         if (westmost > another.eastmost) return false;
         if (eastmost < another.westmost) return false;
 
+        // Both areas come from the same chart so they share the representation
+        if (isFixedPoint () && another.isFixedPoint ()) return isCrossedBy (another.fixedMetrics.front ());
+
         return isCrossedBy (another.metrics.front ());
     }
 };
@@ -124,5 +176,8 @@ double calcSphericalBrg (const double lat1, const double lon1, const double lat2
 void calcSphericalPos (double lat, double lon, double bearing, double rangeNm, double& destLat, double& destLon);
 void composeAreaMetrics (struct FeatureObject *object, struct Chart& chart, Contours& metrics);
 void getBoundingRect (Contour& contour, double& northmost, double& southmost, double& westmost, double& eastmost);
+void getBoundingRect (FixedContour& contour, double coordMultiplier, double& northmost, double& southmost, double& westmost, double& eastmost);
 void buildPointLocationInfo (struct Chart& chart);
+void buildFeatureTable (struct Chart& chart);
+void updatePointLocationInfo (struct Chart& chart, std::set<size_t>& changedFeatures);
 void getCenterPos (FeatureObject& object, Chart& chart, double& lat, double& lon);
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <Windows.h>
+
+// Read-only memory mapping of the whole file; content stays valid until close () or destruction
+struct MappedFile {
+    HANDLE file;
+    HANDLE mapping;
+    const char *data;
+    size_t size;
+
+    MappedFile (): file (INVALID_HANDLE_VALUE), mapping (0), data (0), size (0) {}
+    MappedFile (const char *path): MappedFile () {
+        open (path);
+    }
+    MappedFile (const MappedFile&) = delete;
+    MappedFile& operator = (const MappedFile&) = delete;
+
+    virtual ~MappedFile () {
+        close ();
+    }
+
+    bool open (const char *path) {
+        LARGE_INTEGER fileSize;
+
+        close ();
+
+        file = CreateFileA (path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        if (!GetFileSizeEx (file, & fileSize) || fileSize.QuadPart == 0) {
+            close (); return false;
+        }
+
+        mapping = CreateFileMappingA (file, 0, PAGE_READONLY, 0, 0, 0);
+
+        if (!mapping) {
+            close (); return false;
+        }
+
+        data = (const char *) MapViewOfFile (mapping, FILE_MAP_READ, 0, 0, 0);
+
+        if (!data) {
+            close (); return false;
+        }
+
+        size = (size_t) fileSize.QuadPart;
+
+        return true;
+    }
+
+    void close () {
+        if (data) UnmapViewOfFile (data);
+        if (mapping) CloseHandle (mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle (file);
+
+        file = INVALID_HANDLE_VALUE;
+        mapping = 0;
+        data = 0;
+        size = 0;
+    }
+
+    bool isOpen () { return data != 0; }
+    const char *begin () { return data; }
+    const char *end () { return data + size; }
+};
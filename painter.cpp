@@ -206,6 +206,7 @@ void paintArea (
     HDC paintDC,
     Nodes& nodes,
     Edges& edges,
+    CoordPool& coords,
     std::vector<EdgeRef>& edgeRefs,
     Dai& dai,
     View& view,
@@ -233,8 +234,8 @@ void paintArea (
             vertex.y = y;
         }
     };
-    auto addNode = [addVertex, &nodes] (size_t nodeIndex) {
-        auto& pos = nodes [nodeIndex].points [0];
+    auto addNode = [addVertex, &nodes, &coords] (size_t nodeIndex) {
+        auto pos = coords.get (nodes [nodeIndex].points.offset);
         addVertex (pos.lat, pos.lon);
     };
 
@@ -261,15 +262,15 @@ void paintArea (
         }
         if (edgeRef.unclockwise) {
             addNode (edge.endIndex);
-            for (auto pos = edge.internalNodes.rbegin (); pos != edge.internalNodes.rend (); ++ pos) {
-                addVertex (pos->lat, pos->lon);
-            }
+            coords [edge.internalNodes].forEachReversed ([&addVertex] (const Position& pos) {
+                addVertex (pos.lat, pos.lon);
+            });
             addNode (edge.beginIndex);
         } else {
             addNode (edge.beginIndex);
-            for (auto pos: edge.internalNodes) {
+            coords [edge.internalNodes].forEach ([&addVertex] (const Position& pos) {
                 addVertex (pos.lat, pos.lon);
-            }
+            });
             addNode (edge.endIndex);
         }
     }
@@ -522,6 +523,7 @@ void paintSymbol (
     RECT& client,
     HDC paintDC,
     GeoNode& node,
+    CoordPool& coords,
     Dai& dai,
     View& view,
     int& offset,
@@ -533,14 +535,14 @@ void paintSymbol (
     int westX, northY;
     geoToXY (view.north, view.west, view.zoom, westX, northY);
 
-    for (size_t i = 0; i < node.points.size (); ++ i) {
-        geoToXY (node.points [i].lat, node.points [i].lon, view.zoom, symbolX, symbolY);
+    coords [node.points].forEach ([&] (const Position& pos) {
+        geoToXY (pos.lat, pos.lon, view.zoom, symbolX, symbolY);
         symbolX -= westX;
         symbolY -= northY;
         if (symbolX >= 0 && symbolX <= client.right && symbolY >= 0 && symbolY <= client.bottom) {
             completeDrawProc (paintDC, symbol.drawProc, symbolX, symbolY, paletteIndex, dai, symbol.pivotPtCol, symbol.pivotPtRow, symbol.bBoxCol, symbol.bBoxRow, symbolDraw.rotAngle);
         }
-    }
+    });
 }
 
 void paintSymbol (
@@ -586,6 +588,7 @@ void paintEdge (
     RECT& client,
     HDC paintDC,
     Nodes& nodes,
+    CoordPool& coords,
     GeoEdge& edge,
     Dai& dai,
     View& view,
@@ -603,15 +606,15 @@ void paintEdge (
         point.x = x - westX;
         point.y = y - northY;
     };
-    auto addNode = [addVertex, &nodes] (size_t nodeIndex) {
-        auto& pos = nodes [nodeIndex].points [0];
+    auto addNode = [addVertex, &nodes, &coords] (size_t nodeIndex) {
+        auto pos = coords.get (nodes [nodeIndex].points.offset);
         addVertex (pos.lat, pos.lon);
     };
 
     addNode (edge.beginIndex);
-    for (auto pos: edge.internalNodes) {
+    coords [edge.internalNodes].forEach ([&addVertex] (const Position& pos) {
         addVertex (pos.lat, pos.lon);
-    }
+    });
     addNode (edge.endIndex);
 
     SelectObject (paintDC, pen);
@@ -626,6 +629,115 @@ void addAllTextDraws (FeatureObject& feature, LookupTableItem *lookupTableItem,
     }
 }
 
+// Resolves the lookup table entries of all features once; the set is kept until the chart changes
+static Symbolization& getSymbolization (Chart& chart, Dai& dai, DisplayCat displayCat, TableSet spatialTableSet, TableSet pointTableSet) {
+    Features& features = chart.features;
+    FeatureTable& featureTable = chart.featureTable;
+    Symbolization *symbolization = chart.symbolization.find (displayCat, spatialTableSet, pointTableSet);
+
+    if (symbolization && symbolization->items.size () == features.size ()) return *symbolization;
+
+    if (!symbolization) {
+        symbolization = & chart.symbolization.sets.emplace_back ();
+        symbolization->displayCat = displayCat;
+        symbolization->spatialTableSet = spatialTableSet;
+        symbolization->pointTableSet = pointTableSet;
+    }
+
+    symbolization->items.assign (features.size (), 0);
+    symbolization->points.clear ();
+    symbolization->cspResults.clear ();
+
+    for (auto& bucket: symbolization->spatialsByPriority) bucket.clear ();
+
+    for (size_t i = 0; i < featureTable.size (); ++ i) {
+        TableSet tableSet;
+
+        switch (featureTable.primitive [i]) {
+            case 1: tableSet = pointTableSet; break;
+            case 2: tableSet = TableSet::LINES; break;
+            case 3: tableSet = spatialTableSet; break;
+            default: continue;
+        }
+
+        LookupTableItem *item = features [i].findBestItem (displayCat, tableSet, dai);
+
+        if (!item) continue;
+
+        symbolization->items [i] = item;
+
+        if (featureTable.primitive [i] == 1) {
+            symbolization->points.push_back (i);
+        } else if (item->displayPriority > 0 && item->displayPriority < 10) {
+            symbolization->spatialsByPriority [item->displayPriority].push_back (i);
+        }
+    }
+
+    return *symbolization;
+}
+
+// Returns the item to paint the feature with. A CSP works on a copy of the shared lookup table entry; what it did is
+// recorded so later renders just replay it while the settings (and the zoom, if the procedure depends on it) stay.
+static LookupTableItem *applyCSP (
+    Symbolization& symbolization,
+    size_t featureIndex,
+    Environment& environment,
+    Chart& chart,
+    View& view,
+    DrawQueue& drawQueue
+) {
+    LookupTableItem *entry = symbolization.items [featureIndex];
+
+    if (entry->procIndex == LookupTableItem::NOT_EXIST) return entry;
+
+    auto& feature = chart.features [featureIndex];
+    auto& result = symbolization.cspResults [featureIndex];
+    bool zoomDependent = environment.dai.isZoomDependentProc (entry->procIndex);
+
+    if (result.isValid (environment.settings.generation, view.zoom, zoomDependent)) {
+        if (result.purgesSymbols) drawQueue.removeAllSymbols ();
+
+        for (auto drawer: result.drawers) drawQueue.container.push_back (drawer->clone (drawQueue.view));
+        for (auto& [edgeRef, pres]: result.edgePresentations) drawQueue.edgePresentations.get (*edgeRef) = pres;
+
+        return & result.item;
+    }
+
+    size_t numOfEdgePresBefore = drawQueue.edgePresentations.size ();
+
+    result.clear ();
+    result.item.reset ();
+    result.item.copyFrom (*entry);
+
+    drawQueue.startRecording ();
+    environment.runCSP (& result.item, & feature, chart, view, drawQueue);
+
+    result.recorded = true;
+    result.settingsGeneration = environment.settings.generation;
+    result.zoom = view.zoom;
+    result.purgesSymbols = drawQueue.symbolsPurged;
+
+    for (size_t i = drawQueue.recordStart; i < drawQueue.container.size (); ++ i) {
+        Drawer *drawer = drawQueue.container [i]->clone (drawQueue.view);
+
+        if (!drawer) {
+            result.clear (); break;
+        }
+
+        result.drawers.push_back (drawer);
+    }
+
+    if (result.recorded && drawQueue.edgePresentations.size () > numOfEdgePresBefore) {
+        for (auto& edgeRef: feature.edgeRefs) {
+            auto pres = drawQueue.edgePresentations.find (edgeRef);
+
+            if (pres) result.edgePresentations.emplace_back (& edgeRef, *pres);
+        }
+    }
+
+    return & result.item;
+}
+
 void paintChart (
     RECT& client,
     HDC paintDC,
@@ -637,29 +749,57 @@ void paintChart (
     TableSet spatialObjTableSet,
     TableSet pointObjTableSet
 ) {
-    static char *objectTypes { "PLA" };
-    std::vector<LookupTable *> lookupTables;
-    std::vector<EdgeRef> delayedEdges [10];
+    std::vector<std::pair<EdgeRef *, EdgePresentation *>> delayedEdges [10];
     Nodes& nodes = chart.nodes;
     Edges& edges = chart.edges;
     Features& features = chart.features;
     Dai& dai = environment.dai;
     AttrDictionary& attrDic = environment.attrDictionary;
 
-    auto getTableSet = [pointObjTableSet, spatialObjTableSet] (FeatureObject& feature) {
-        switch (feature.primitive) {
-            case 1: case 4: return pointObjTableSet;
-            case 2: return TableSet::LINES;
-            case 3: return spatialObjTableSet;
-            default: return TableSet::UNKNOWN_DATASET;
-        }
+    if (chart.featureTable.size () != features.size ()) buildFeatureTable (chart);
+
+    Symbolization& symbolization = getSymbolization (chart, dai, displayCat, spatialObjTableSet, pointObjTableSet);
+
+    // Features whose box misses the client area widened by the largest symbol extent can't leave a trace
+    static const int CULLING_MARGIN = 256;
+    FeatureTable& featureTable = chart.featureTable;
+    double viewNorth, viewWest, viewSouth, viewEast;
+    int westX, northY;
+
+    geoToXY (view.north, view.west, view.zoom, westX, northY);
+    xyToGeo (westX - CULLING_MARGIN, northY - CULLING_MARGIN, view.zoom, viewNorth, viewWest);
+    xyToGeo (westX + client.right + CULLING_MARGIN, northY + client.bottom + CULLING_MARGIN, view.zoom, viewSouth, viewEast);
+
+    auto isVisible = [&featureTable, viewNorth, viewWest, viewSouth, viewEast] (size_t index) {
+        return featureTable.intersects (index, viewNorth, viewWest, viewSouth, viewEast);
     };
 
-    for (auto& feature: features) {
-        TableSet tableSet = getTableSet (feature);
-        auto lookupTable = dai.findLookupTable (feature.classCode, displayCat, tableSet, objectTypes [feature.primitive-1]);
-        lookupTables.emplace_back (lookupTable);
-    }
+    // LIGHTS06 draws sector legs from the light outwards, 25 mm long or as long as the nominal range with full sector
+    // length on; those can reach the client area from a light far beyond the symbol margin
+    static const double SECTOR_LEG_MM = 25.0;
+    bool fullSectorLength = environment.settings.fullSectorLength;
+    double sectorLegNm = mmToMiles (SECTOR_LEG_MM, view.zoom);
+
+    auto isLightVisible = [&features, &featureTable, fullSectorLength, sectorLegNm, viewNorth, viewWest, viewSouth, viewEast] (size_t index) {
+        double reachNm = sectorLegNm;
+
+        if (fullSectorLength) {
+            auto valnmr = features [index].getAttr (ATTRS::VALNMR);
+            double nominalRange = (valnmr && !valnmr->noValue) ? valnmr->floatValue () : 9.0;
+
+            if (nominalRange > reachNm) reachNm = nominalRange;
+        }
+
+        // A light within reach lies at most latMargin beyond the view, a degree of longitude is shortest there
+        double latMargin = reachNm / 60.0;
+        double farthestLat = std::max (fabs (viewNorth), fabs (viewSouth)) + latMargin;
+
+        if (farthestLat >= 89.0) return true;
+
+        double lonMargin = latMargin / cos (farthestLat * RAD_IN_DEG);
+
+        return featureTable.intersects (index, viewNorth + latMargin, viewWest - lonMargin, viewSouth - latMargin, viewEast + lonMargin);
+    };
 
     DrawQueue drawQueue (client, paintDC, paletteIndex, dai, attrDic, view);
     DrawQueue textDrawQueue (client, paintDC, paletteIndex, dai, attrDic, view);
@@ -667,21 +807,23 @@ void paintChart (
     for (int prty = 1; prty < 10; ++ prty) {
         drawQueue.clear ();
         
-        for (size_t i = 0; i < features.size (); ++ i) {
-            auto& feature = features [i];
-            if (feature.primitive != 2 && feature.primitive != 3) continue;
-            if (!lookupTables [i]) continue;
+        for (size_t i: symbolization.spatialsByPriority [prty]) {
+            if (!isVisible (i)) continue;
 
-            auto lookupTableItem = feature.findBestItem (displayCat, getTableSet (feature), dai, prty);
-            if (!lookupTableItem) continue;
+            auto& feature = features [i];
 if(feature.fidn==29142253){
 int iii=0;
 ++iii;
 --iii;
 }
-            if (lookupTableItem->procIndex != LookupTableItem::NOT_EXIST) {
-                environment.runCSP (lookupTableItem, & feature, chart, view, drawQueue);
-            }
+            size_t numOfEdgePresBefore = drawQueue.edgePresentations.size ();
+            auto lookupTableItem = applyCSP (symbolization, i, environment, chart, view, drawQueue);
+
+            // Only a CSP of this feature could assign presentations to its edges
+            bool hasEdgePres = drawQueue.edgePresentations.size () > numOfEdgePresBefore;
+            auto findEdgePres = [&drawQueue, hasEdgePres] (EdgeRef& edgeRef) {
+                return hasEdgePres ? drawQueue.edgePresentations.find (edgeRef) : (EdgePresentation *) 0;
+            };
 
             if (feature.primitive == 3) {
                 drawQueue.addArea (lookupTableItem->brushIndex, lookupTableItem->patternBrushIndex, chart);
@@ -695,20 +837,22 @@ int iii=0;
                 if (lookupTableItem->customEdgePres) {
                     for (auto& edgeRef: feature.edgeRefs) {
                         if (edgeRef.hidden) continue;
-                        if (edgeRef.displayPriority > prty) {
-                            auto& ref = delayedEdges [edgeRef.displayPriority].emplace_back (edgeRef);
-                            if (ref.penIndex == LookupTableItem::NOT_EXIST) ref.penIndex = lookupTableItem->edgePenIndex;
-                            if (ref.secondPen && ref.secondPenIndex == LookupTableItem::NOT_EXIST) ref.secondPen = false;
+                        auto pres = findEdgePres (edgeRef);
+                        if (pres && pres->displayPriority > prty) {
+                            if (pres->penIndex == LookupTableItem::NOT_EXIST) pres->penIndex = lookupTableItem->edgePenIndex;
+                            if (pres->secondPen && pres->secondPenIndex == LookupTableItem::NOT_EXIST) pres->secondPen = false;
+                            delayedEdges [pres->displayPriority].emplace_back (& edgeRef, pres);
                         } else {
+                            bool customPres = pres && pres->customPres;
                             drawQueue.addEdgeChain (
-                                edgeRef.customPres ? edgeRef.penIndex : lookupTableItem->edgePenIndex,
-                                edgeRef.customPres ? edgeRef.penStyle : lookupTableItem->edgePenStyle,
-                                edgeRef.customPres ? edgeRef.penWidth : lookupTableItem->edgePenWidth,
+                                customPres ? pres->penIndex : lookupTableItem->edgePenIndex,
+                                customPres ? pres->penStyle : lookupTableItem->edgePenStyle,
+                                customPres ? pres->penWidth : lookupTableItem->edgePenWidth,
                                 chart
                             );
                             drawQueue.addEdge (edgeRef);
-                            if (edgeRef.customPres && edgeRef.secondPen) {
-                                drawQueue.addEdgeChain (edgeRef.secondPenIndex, edgeRef.secondPenStyle, edgeRef.secondPenWidth, chart);
+                            if (customPres && pres->secondPen) {
+                                drawQueue.addEdgeChain (pres->secondPenIndex, pres->secondPenStyle, pres->secondPenWidth, chart);
                                 drawQueue.addEdge (edgeRef);
                             }
                         }
@@ -722,62 +866,53 @@ int iii=0;
                 }
             }
 
-            if (feature.primitive == 2 || feature.primitive == 3) {
+            if (hasEdgePres) {
                 for (auto& edgeRef: feature.edgeRefs) {
-                    if (edgeRef.hidden || edgeRef.displayPriority && edgeRef.displayPriority != prty) continue;
-                    if (!edgeRef.symbols.empty ()) {
-                        for (size_t symbolIndex: edgeRef.symbols) {
-                            drawQueue.addCentralEdgeSymbol (chart, symbolIndex, edgeRef.index, dai);
-                        }
+                    auto pres = findEdgePres (edgeRef);
+                    if (edgeRef.hidden || !pres || pres->displayPriority && pres->displayPriority != prty) continue;
+                    for (size_t symbolIndex: pres->symbols) {
+                        drawQueue.addCentralEdgeSymbol (chart, symbolIndex, edgeRef.index, dai);
                     }
                 }
             }
 
             addAllTextDraws (feature, lookupTableItem, textDrawQueue, chart);
-
-            delete lookupTableItem;
         }
 
         // Draw delayed edges
-        for (auto& edgeRef: delayedEdges [prty]) {
-            drawQueue.addEdgeChain (edgeRef.penIndex, edgeRef.penStyle, edgeRef.penWidth, chart );
-            drawQueue.addEdge (edgeRef);
-            if (edgeRef.customPres && edgeRef.secondPen) {
-                drawQueue.addEdgeChain (edgeRef.secondPenIndex, edgeRef.secondPenStyle, edgeRef.secondPenWidth, chart);
-                drawQueue.addEdge (edgeRef);
+        for (auto& [edgeRef, pres]: delayedEdges [prty]) {
+            drawQueue.addEdgeChain (pres->penIndex, pres->penStyle, pres->penWidth, chart );
+            drawQueue.addEdge (*edgeRef);
+            if (pres->customPres && pres->secondPen) {
+                drawQueue.addEdgeChain (pres->secondPenIndex, pres->secondPenStyle, pres->secondPenWidth, chart);
+                drawQueue.addEdge (*edgeRef);
             }
-            for (size_t symbolIndex: edgeRef.symbols) {
-                drawQueue.addCentralEdgeSymbol (chart, symbolIndex, edgeRef.index, dai);
+            for (size_t symbolIndex: pres->symbols) {
+                drawQueue.addCentralEdgeSymbol (chart, symbolIndex, edgeRef->index, dai);
             }
         }
         
         drawQueue.run ();
     }
 
-    for (size_t i = 0; i < features.size (); ++ i) {
+    for (size_t i: symbolization.points) {
         auto& feature = features [i];
-        if (feature.primitive != 1 && feature.primitive != 4) continue;
-        if (!lookupTables [i]) continue;
-        auto lookupTableItem = feature.findBestItem (displayCat, pointObjTableSet, dai);
-        if (!lookupTableItem) continue;
+
+        if (!isVisible (i) && (feature.classCode != OBJ_CLASSES::LIGHTS || !isLightVisible (i))) continue;
 
         drawQueue.clear ();
 
-        if (lookupTableItem->procIndex != LookupTableItem::NOT_EXIST) {
-            environment.runCSP (lookupTableItem, & feature, chart, view, drawQueue);
-        }
+        auto lookupTableItem = applyCSP (symbolization, i, environment, chart, view, drawQueue);
 
         int offset = 0;
 
         for (auto& symbolDraw: lookupTableItem->symbols) {
-            auto& pos = nodes [feature.nodeIndex].points.front ();
+            auto pos = chart.nodePosition (feature.nodeIndex);
             drawQueue.addSymbol (pos.lat, pos.lon, symbolDraw.symbolIndex, symbolDraw.rotAngle, dai);
         }
         drawQueue.run ();
 
         addAllTextDraws (feature, lookupTableItem, textDrawQueue, chart);
-
-        delete lookupTableItem;
     }
 
     textDrawQueue.run ();
@@ -1282,20 +1417,22 @@ std::tuple<bool, int, int> getCenterPos (size_t edgeIndex, RECT& client, Chart&
         }
     };
 
-    auto checkAddLegByTwoPos = [&checkAddLeg] (Position& pos1, Position& pos2) {
+    auto checkAddLegByTwoPos = [&checkAddLeg] (const Position& pos1, const Position& pos2) {
         checkAddLeg (pos1.lat, pos1.lon, pos2.lat, pos2.lon);
     };
-    if (edge.internalNodes.empty ()) {
+    auto internalNodes = chart.internalNodes (edge);
+
+    if (internalNodes.empty ()) {
         checkAddLegByTwoPos (
-            chart.nodes [edge.beginIndex].points.front (),
-            chart.nodes [edge.endIndex].points.front ()
+            chart.nodePosition (edge.beginIndex),
+            chart.nodePosition (edge.endIndex)
         );
     } else {
-        checkAddLegByTwoPos (chart.nodes [edge.beginIndex].points.front (), edge.internalNodes.front ());
-        for (size_t i = 1, j = edge.internalNodes.size () - 1; i < j; ++ i) {
-            checkAddLegByTwoPos (edge.internalNodes [i-1], edge.internalNodes [i]);
+        checkAddLegByTwoPos (chart.nodePosition (edge.beginIndex), internalNodes.front ());
+        for (size_t i = 1, j = internalNodes.size () - 1; i < j; ++ i) {
+            checkAddLegByTwoPos (internalNodes [i-1], internalNodes [i]);
         }
-        checkAddLegByTwoPos (edge.internalNodes.back (), chart.nodes [edge.endIndex].points.front ());
+        checkAddLegByTwoPos (internalNodes.back (), chart.nodePosition (edge.endIndex));
     }
     if (vertices.empty ()) return std::tuple<bool, int, int> (false, 0, 0);
 
@@ -5,32 +5,51 @@
 #include <map>
 #include <string>
 #include <tuple>
+#include <thread>
+#include <set>
 #include "s57defs.h"
 #include "data.h"
 #include "painter.h"
 #include "abstract_tools.h"
 #include "classes.h"
+#include "scan.h"
+#include "chart_cache.h"
+#include "dai_cache.h"
+#include "crc32.h"
+#include "work_pool.h"
 
 void parseTextInstruction (const char *instr, Dai& dai, AttrDictionary& attrDic, TextDesc& desc);
 
-size_t splitString (std::string source, std::vector<std::string>& parts, char separator) {
+template<typename Part> static size_t splitInto (std::string_view source, std::vector<Part>& parts, char separator) {
     parts.clear ();
 
     if (source.empty ()) return 0;
 
-    parts.emplace_back ();
+    const char *pos = source.data ();
+    const char *end = pos + source.size ();
 
-    for (char chr: source) {
-        if (chr == separator) {
-            parts.emplace_back ();
-        } else {
-            parts.back () += chr;
-        }
+    while (true) {
+        const char *delim = findByte (pos, end, separator);
+
+        parts.emplace_back (pos, delim - pos);
+
+        if (delim == end) break;
+
+        pos = delim + 1;
     }
 
     return parts.size ();
 }
 
+size_t splitString (std::string_view source, std::vector<std::string>& parts, char separator) {
+    return splitInto (source, parts, separator);
+}
+
+// Parts are views into source, so they are valid as long as the source text is
+size_t splitString (std::string_view source, std::vector<std::string_view>& parts, char separator) {
+    return splitInto (source, parts, separator);
+}
+
 size_t splitText (std::string source, std::vector<std::string>& lines) {
     lines.clear ();
 
@@ -38,15 +57,19 @@ size_t splitText (std::string source, std::vector<std::string>& lines) {
 
     lines.emplace_back ();
 
-    for (char chr: source) {
-        switch (chr) {
-            case 13:
-                lines.emplace_back ();
-            case 10:
-                break;
-            default:
-                lines.back () += chr;
-        }
+    const char *pos = source.data ();
+    const char *end = pos + source.size ();
+
+    while (pos < end) {
+        // CR starts a new line, LF is just skipped
+        const char *delim = findEither (pos, end, '\r', '\n');
+
+        lines.back ().append (pos, delim - pos);
+
+        if (delim == end) break;
+        if (*delim == '\r') lines.emplace_back ();
+
+        pos = delim + 1;
     }
 
     return lines.size ();
@@ -60,13 +83,16 @@ size_t loadFile (const char *path, char *& content) {
         fseek (file, 0, SEEK_END);
         size = ftell (file);
         fseek (file, 0, SEEK_SET);
-        content = (char *) malloc (size);
+        content = (char *) malloc (size + 2);
         
         if (!content) {
             size = 0;
         } else if (fread (content, 1, size, file) == 0) {
             free (content);
             size = 0;
+        } else {
+            // Terminated for text in either width
+            content [size] = content [size + 1] = '\0';
         }
 
         fclose (file);
@@ -82,7 +108,7 @@ size_t loadFileAndConvertToAnsi (const char *path, char *& content) {
         if (content [0] == -1 && content [1] == -2) {
             std::string ansi;
 
-            for (wchar_t *chr = (wchar_t *) content + 2; *chr; ++ chr) {
+            for (uint16_t *chr = (uint16_t *) content + 1; *chr; ++ chr) {
                 ansi += (char) (*chr & 255);
             }
 
@@ -132,7 +158,7 @@ bool processDataDesciptiveField (
 
     splitString (arrayDesc, tags, '!');
 
-    auto addFormat = [&item] (std::string& format) {
+    auto addFormat = [&item] (const std::string& format) {
         auto& formatDesc = item.fields.emplace_back ();
         
         formatDesc.format = format [0];
@@ -215,11 +241,10 @@ std::tuple<bool, std::string> getStrValue (RecordFieldDesc& fld, const char *& f
         value.append (fieldPos, fld.modifier.value ());
         fieldPos += fld.modifier.value ();
     } else {
-        size_t k;
-        for (k = 0; fieldPos [k] != UT && fieldPos [k] != FT; ++ k) {
-            value += fieldPos [k];
-        }
-        fieldPos += k + 1;
+        const char *term = findEither (fieldPos, UT, FT);
+
+        value.assign (fieldPos, term - fieldPos);
+        fieldPos = term + 1;
     }
     
     return std::tuple (true, value);
@@ -237,11 +262,10 @@ bool getBinaryValue (RecordFieldDesc& fld, const char *& fieldPos, std::vector<u
         binary.insert (binary.end (), fieldPos, fieldPos + size);
         fieldPos += size;
     } else {
-        size_t k;
-        for (k = 0; isdigit (fieldPos [k]); ++ k) {
-            binary.insert (binary.end (), fieldPos [k]);
-        }
-        fieldPos += k + 1;
+        const char *term = findEither (fieldPos, UT, FT);
+
+        binary.insert (binary.end (), fieldPos, term);
+        fieldPos = term + 1;
     }
     
     return true;
@@ -252,22 +276,19 @@ std::tuple<bool, uint32_t> getIntValue (RecordFieldDesc& fld, const char *& fiel
         fieldPos ++; return std::tuple (false, 0);
     }
 
-    char value [100];
-
-    memset (value, 0, sizeof (value));
+    int32_t value;
 
     if (fld.modifier.has_value ()) {
-        memcpy (value, fieldPos, fld.modifier.value ());
+        value = parseSignedField (fieldPos, fld.modifier.value ());
         fieldPos += fld.modifier.value ();
     } else {
         size_t k;
-        for (k = 0; isdigit (fieldPos [k]); ++ k) {
-            value [k] = fieldPos [k];
-        }
+        for (k = 0; isdigit ((uint8_t) fieldPos [k]); ++ k);
+        value = parseSignedField (fieldPos, k);
         fieldPos += k + 1;
     }
     
-    return std::tuple (true, std::atoi (value));
+    return std::tuple (true, (uint32_t) value);
 }
 
 std::tuple<bool, uint32_t> getBinValue (RecordFieldDesc& fld, const char *& fieldPos) {
@@ -298,12 +319,10 @@ std::tuple<bool, double> getFloatValue (RecordFieldDesc& fld, const char *& fiel
         fieldPos ++; return std::tuple (false, 0.0);
     }
 
-    char value [100];
-
-    memset (value, 0, sizeof (value));
+    double value;
 
     if (fld.modifier.has_value ()) {
-        memcpy (value, fieldPos, fld.modifier.value ());
+        value = parseFloatField (fieldPos, fld.modifier.value ());
         fieldPos += fld.modifier.value ();
     } else {
         size_t k;
@@ -325,13 +344,12 @@ std::tuple<bool, double> getFloatValue (RecordFieldDesc& fld, const char *& fiel
             }
             return false;
         };
-        for (k = 0; validChar (fieldPos [k]); ++ k) {
-            value [k] = fieldPos [k];
-        }
+        for (k = 0; validChar (fieldPos [k]); ++ k);
+        value = parseFloatField (fieldPos, k);
         fieldPos += k + 1;
     }
     
-    return std::tuple (true, std::atof (value));
+    return std::tuple (true, value);
 }
 
 size_t parseDataRecord (
@@ -362,7 +380,7 @@ size_t parseDataRecord (
 
             for (auto j = 0; j < ddf.fields.size (); ++ j) {
                 auto& fld = ddf.fields [j];
-                auto& subFieldInstance = fieldValueInstance.emplace (fld.tag, SubFieldInstance ()).first;
+                auto subFieldInstance = fieldValueInstance.emplace (fld.tag, SubFieldInstance ()).first;
 
                 subFieldInstance->second.type = fld.format;
 
@@ -437,64 +455,75 @@ size_t parseDataDescriptiveRecord (
         std::string arrayDesc;
         std::string fieldValue;
         int utCount = 0;
-        char *curPtr;
-
-        for (curPtr = (char *) (fieldControls + 1); *curPtr != FT; ++ curPtr) {
-            if (*curPtr == UT) {
-                utCount ++;
-            } else if (utCount == 0) {
-                fieldName += *curPtr;
-            } else if (utCount == 1) {
-                arrayDesc += *curPtr;
-            } else {
-                fieldValue += *curPtr;
-            }
+        const char *curPtr = (const char *) (fieldControls + 1);
+        const char *fieldEnd = findEither (curPtr, FT, FT);
+
+        // Name, array descriptor and format controls are separated by UT
+        while (curPtr < fieldEnd) {
+            const char *term = findByte (curPtr, fieldEnd, UT);
+            std::string& dest = utCount == 0 ? fieldName : (utCount == 1 ? arrayDesc : fieldValue);
+
+            dest.append (curPtr, term - curPtr);
+
+            ++ utCount;
+            curPtr = term + 1;
         }
 
         parseDdrField (fieldControls, directory [dirIndex].tag, fieldName, arrayDesc, fieldValue, directory, parsedLeader, fieldTree, dataDescriptiveFields);
 
-        source = curPtr + 1;
+        source = fieldEnd + 1;
         ++ dirIndex;
     }
 
     return parsedLeader.recLength;
 }
 
-void deformatAttrValues (AttrDictionary& attrDictionary, Chart& chart) {
-    Features& features = chart.features;
-    for (size_t i = 0; i < features.size (); ++ i) {
-        auto& feature = features [i];
-        for (auto& attr: feature.attributes) {
-            if (!attr.noValue && !attr.strValue.empty ()) {
-                AttrDesc *attrDesc = (AttrDesc *) attrDictionary.findByCode (attr.classCode);
+void deformatAttrValues (AttrDictionary& attrDictionary, std::vector<Attr>& attributes, StringPool& pool) {
+    for (auto& attr: attributes) {
+        if (!attr.noValue && attr.strLength () > 0) {
+            AttrDesc *attrDesc = (AttrDesc *) attrDictionary.findByCode (attr.classCode);
 
-                switch (attrDesc->domain) {
-                    case 'L': {
-                        std::vector<std::string> parts;
+            if (!attrDesc) continue;
 
-                        attr.listValue.clear ();
+            switch (attrDesc->domain) {
+                case 'L': {
+                    std::vector<std::string> parts;
+                    std::vector<uint8_t> items;
 
-                        splitString (attr.strValue, parts, ',');
+                    splitString (attr.strValue (), parts, ',');
 
-                        for (std::string& part: parts) {
-                            attr.listValue.push_back (std::atoi (part.c_str ()));
-                        }
-                        break;
-                    }
-                    case 'E':
-                    case 'I': {
-                        if (!attr.intValue) attr.intValue = std::atoi (attr.strValue.c_str ());
-                        break;
-                    }
-                    case 'F': {
-                        attr.floatValue = std::atof (attr.strValue.c_str ()); break;
+                    for (std::string& part: parts) {
+                        items.push_back (parseSignedField (part.c_str (), part.length ()));
                     }
+
+                    // An oversized list can't be stored whole, so its value counts as unknown
+                    if (!attr.setList (pool, items.data (), items.size ())) attr.noValue = true;
+                    break;
+                }
+                case 'E':
+                case 'I': {
+                    attr.setInt (attrDesc->domain, parseSignedField (attr.strValue (), attr.strLength ()));
+                    break;
+                }
+                case 'F': {
+                    attr.setFloat (parseFloatField (attr.strValue (), attr.strLength ())); break;
+                }
+                default: {
+                    attr.domain = attrDesc->domain; break;
                 }
             }
         }
     }
 }
 
+void deformatAttrValues (AttrDictionary& attrDictionary, Chart& chart) {
+    Features& features = chart.features;
+    for (size_t i = 0; i < features.size (); ++ i) {
+        deformatAttrValues (attrDictionary, features [i].attributes, chart.strings);
+        features [i].buildAttrIndex ();
+    }
+}
+
 void extractEdges (std::vector<std::vector<FieldInstance>>& records, Chart& chart) {
     Edges& edges = chart.edges;
     Nodes& points = chart.nodes;
@@ -561,17 +590,15 @@ void extractEdges (std::vector<std::vector<FieldInstance>>& records, Chart& char
                             auto& attr = edges.back ().attributes.back ();
                             attr.noValue = false;
                             if (subField.second.intValue.has_value ()) {
-                                attr.intValue = subField.second.intValue.value ();
+                                attr.setInt ('I', subField.second.intValue.value ());
                             } else if (subField.second.floatValue.has_value ()) {
-                                attr.floatValue = subField.second.floatValue.value ();
+                                attr.setFloat (subField.second.floatValue.value ());
                             } else if (subField.second.stringValue.has_value ()) {
-                                attr.strValue = subField.second.stringValue.value ();
+                                auto& value = subField.second.stringValue.value ();
+                                attr.setText (chart.strings, value.c_str (), value.length ());
                             } else if (subField.second.binaryValue.size () > 0) {
-                                attr.listValue.insert (
-                                    attr.listValue.end (),
-                                    subField.second.binaryValue.begin (),
-                                    subField.second.binaryValue.end ()
-                                );
+                                auto& value = subField.second.binaryValue;
+                                if (!attr.setList (chart.strings, value.data (), value.size ())) attr.noValue = true;
                             } else {
                                 attr.noValue = true;
                             }
@@ -581,21 +608,23 @@ void extractEdges (std::vector<std::vector<FieldInstance>>& records, Chart& char
             } else if (field.tag.compare ("SG2D") == 0) {
                 // New internal node
                 GeoEdge& edge = edges.back ();
+                std::vector<Position> points;
                 for (auto& instanceValue: field.instanceValues) {
                     for (auto& subField: instanceValue) {
                         if (subField.first.compare ("*YCOO") == 0) {
-                            auto& point = edge.internalNodes.emplace_back ();
+                            auto& point = points.emplace_back ();
                             if (subField.second.intValue.has_value () && chart.params.coordMultiplier) {
                                 point.lat = (double) (int32_t) subField.second.intValue.value () / (double) chart.params.coordMultiplier.value ();
                             }
                         } else if (subField.first.compare ("XCOO") == 0) {
-                            auto& point = edge.internalNodes.back ();
+                            auto& point = points.back ();
                             if (subField.second.intValue.has_value ()) {
                                 point.lon = (double) (int32_t) subField.second.intValue.value () / (double) chart.params.coordMultiplier.value ();
                             }
                         }
                     }
                 }
+                chart.coords.append (edge.internalNodes, points.data (), points.size ());
             } else if (field.tag.compare ("VRPT") == 0) {
                 for (auto& instanceValue: field.instanceValues) {
                     std::optional<uint8_t> mask;
@@ -706,19 +735,21 @@ void extractNodes (std::vector<std::vector<FieldInstance>>& records, Chart& char
                 }
             } else if (field.tag.compare ("SG2D") == 0) {
                 GeoNode& curPoint = points.back ();
+                std::vector<Position> positions;
                 for (auto& subField: firstFieldValue) {
                     if (subField.first.compare ("*YCOO") == 0) {
-                        auto& point = curPoint.points.emplace_back ();
+                        auto& point = positions.emplace_back ();
                         if (subField.second.intValue.has_value () && chart.params.coordMultiplier) {
                             point.lat = (double) (int32_t) subField.second.intValue.value () / (double) chart.params.coordMultiplier.value ();
                         }
                     } else if (subField.first.compare ("XCOO") == 0) {
-                        auto& point = curPoint.points.back ();
+                        auto& point = positions.back ();
                         if (subField.second.intValue.has_value ()) {
                             point.lon = (double) (int32_t) subField.second.intValue.value () / (double) chart.params.coordMultiplier.value ();
                         }
                     }
                 }
+                chart.coords.append (curPoint.points, positions.data (), positions.size ());
             } else if (field.tag.compare ("SG3D") == 0) {
                 GeoNode& curPoint = points.back ();
                 std::vector<Position> soundings;
@@ -762,7 +793,7 @@ void extractNodes (std::vector<std::vector<FieldInstance>>& records, Chart& char
                     }
                 }
                 if (soundings.size () > 0) {
-                    curPoint.points.insert (curPoint.points.begin (), soundings.begin (), soundings.end ());
+                    chart.coords.insert (curPoint.points, 0, soundings.data (), soundings.size ());
                 }
                 /*for (auto& subField: firstFieldValue) {
                     if (subField.first.compare ("AGEN") == 0) {
@@ -985,17 +1016,15 @@ void extractFeatureObjects (std::vector<std::vector<FieldInstance>>& records, Ch
                             auto& attr = features.back ().attributes.back ();
                             attr.noValue = false;
                             if (subField.second.intValue.has_value ()) {
-                                attr.intValue = subField.second.intValue.value ();
+                                attr.setInt ('I', subField.second.intValue.value ());
                             } else if (subField.second.floatValue.has_value ()) {
-                                attr.floatValue = subField.second.floatValue.value ();
+                                attr.setFloat (subField.second.floatValue.value ());
                             } else if (subField.second.stringValue.has_value ()) {
-                                attr.strValue = subField.second.stringValue.value ();
+                                auto& value = subField.second.stringValue.value ();
+                                attr.setText (chart.strings, value.c_str (), value.length ());
                             } else if (subField.second.binaryValue.size () > 0) {
-                                attr.listValue.insert (
-                                    attr.listValue.end (),
-                                    subField.second.binaryValue.begin (),
-                                    subField.second.binaryValue.end ()
-                                );
+                                auto& value = subField.second.binaryValue;
+                                if (!attr.setList (chart.strings, value.data (), value.size ())) attr.noValue = true;
                             } else {
                                 attr.noValue = true;
                             }
@@ -1161,354 +1190,1636 @@ void extractDatasetParameters (std::vector<std::vector<FieldInstance>>& records,
     }
 }
 
-bool loadParseS57File (char *path, std::vector<std::vector<FieldInstance>>& records) {
-    char *content = 0;
-    size_t size = loadFile (path, content);
-    bool result = false;
+SubFieldDecoder::SubFieldDecoder (RecordFieldDesc *_desc): desc (_desc), format (_desc->format), isSigned (false), width (0), offset (0) {
+    if (desc->modifier.has_value ()) {
+        switch (format) {
+            case 'b':
+                width = (uint32_t) desc->modifier.value () % 10;
+                isSigned = desc->modifier.value () / 10 == 2;
+                break;
+            case 'B':
+                width = (uint32_t) desc->modifier.value () / 8; break;
+            default:
+                width = (uint32_t) desc->modifier.value ();
+        }
+    }
+}
 
-    if (size) {
-        char *recStart = content;
-        std::vector<std::pair<std::string, std::string>> fieldTree;
-        std::map<std::string, DdfDesc> dataDescriptiveFields;
-        size_t processedSize = 0;
-        
-        records.clear ();
+void DdrProgram::compile (std::map<std::string, DdfDesc>& dataDescriptiveFields) {
+    fields.clear ();
+    fields.reserve (dataDescriptiveFields.size ());
+
+    for (auto& ddf: dataDescriptiveFields) {
+        if (ddf.first.length () != 4) continue;
 
-        size_t ddrSize = parseDataDescriptiveRecord (recStart, fieldTree, dataDescriptiveFields);
+        auto& field = fields.emplace_back ();
 
-        recStart += ddrSize;
-        processedSize += ddrSize;
+        field.tag = packTag (ddf.first.c_str ());
+        field.desc = & ddf.second;
+        field.subFields.reserve (ddf.second.fields.size ());
 
-        while (processedSize < size) {
-            auto& fieldInstances = records.emplace_back ();
-            size_t drSize = parseDataRecord (recStart, dataDescriptiveFields, fieldInstances);
+        bool fixedSize = !ddf.second.fields.empty ();
 
-            recStart += drSize;
-            processedSize += drSize;
+        for (auto& fld: ddf.second.fields) {
+            auto& subField = field.subFields.emplace_back (& fld);
+
+            subField.offset = field.instanceSize;
+            field.instanceSize += subField.width;
+
+            if (!subField.width) fixedSize = false;
         }
-        
-        result = true;
-        free (content);
-    }
 
-    return result;
+        if (!fixedSize) field.instanceSize = 0;
+    }
 }
 
-bool parseCatalog (const char *catPath, std::vector<CatalogItem>& catalog) {
-    char *catalogContent = 0;
-    size_t size = loadFile (catPath, catalogContent);
-    bool result = false;
+size_t FieldView::decode (std::vector<SubFieldView>& subFields) {
+    size_t numOfInstances = 0;
+    const char *fieldPos = data;
+    const char *fieldEnd = data + length;
 
-    catalog.clear ();
+    subFields.clear ();
 
-    if (size) {
-        char *recStart = catalogContent;
-        std::vector<std::pair<std::string, std::string>> fieldTree;
-        std::map<std::string, DdfDesc> dataDescriptiveFields;
-        std::vector<FieldInstance> fieldInstances;
-        size_t processedSize = 0;
-        
-        size_t ddrSize = parseDataDescriptiveRecord (recStart, fieldTree, dataDescriptiveFields);
+    if (!decoder || decoder->subFields.empty ()) return 0;
 
-        recStart += ddrSize;
-        processedSize += ddrSize;
+    while ((fieldPos - data + 1) < length) {
+        const char *instanceStart = fieldPos;
 
-        while (processedSize < size) {
-            size_t drSize = parseDataRecord (recStart, dataDescriptiveFields, fieldInstances);
+        for (auto& subFieldDecoder: decoder->subFields) {
+            auto& subField = subFields.emplace_back ();
 
-            auto& item = catalog.emplace_back ();
-            auto& fields = fieldInstances [1];
-            auto& firstFieldValue = fields.instanceValues.front ();
+            subField.decoder = & subFieldDecoder;
+            subField.data = fieldPos;
 
-            auto& rcid = firstFieldValue.find ("RCID");
-            if (rcid != firstFieldValue.end () && rcid->second.intValue.has_value ()) {
-                item.rcid = rcid->second.intValue.value ();
-            }
-            auto& file = firstFieldValue.find ("FILE");
-            if (file != firstFieldValue.end () && file->second.stringValue.has_value ()) {
-                item.fileName = file->second.stringValue.value ();
-            }
-            auto& volume = firstFieldValue.find ("VOLM");
-            if (volume != firstFieldValue.end () && volume->second.stringValue.has_value ()) {
-                item.volume = volume->second.stringValue.value ();
-            }
-            auto& impl = firstFieldValue.find ("IMPL");
-            if (impl != firstFieldValue.end () && impl->second.stringValue.has_value ()) {
-                item.binary = impl->second.stringValue.value ().compare ("BIN") == 0;
-            }
-            auto& southern = firstFieldValue.find ("SLAT");
-            if (southern != firstFieldValue.end () && southern->second.floatValue.has_value ()) {
-                item.southern = southern->second.floatValue.value ();
-            }
-            auto& northern = firstFieldValue.find ("NLAT");
-            if (northern != firstFieldValue.end () && northern->second.floatValue.has_value ()) {
-                item.northern = northern->second.floatValue.value ();
-            }
-            auto& western = firstFieldValue.find ("WLON");
-            if (western != firstFieldValue.end () && western->second.floatValue.has_value ()) {
-                item.western = western->second.floatValue.value ();
-            }
-            auto& eastern = firstFieldValue.find ("ELON");
-            if (eastern != firstFieldValue.end () && eastern->second.floatValue.has_value ()) {
-                item.eastern = eastern->second.floatValue.value ();
-            }
-            auto& crc = firstFieldValue.find ("CRCS");
-            if (crc != firstFieldValue.end () && crc->second.stringValue.has_value ()) {
-                item.crc = crc->second.stringValue.value ();
-            }
+            if (subFieldDecoder.width) {
+                size_t width = subFieldDecoder.width;
 
-            recStart += drSize;
-            processedSize += drSize;
+                if (fieldPos + width > fieldEnd) width = fieldEnd - fieldPos;
+
+                subField.length = (uint32_t) width;
+                subField.hasValue = true;
+                fieldPos += width;
+            } else {
+                size_t k = findEither (fieldPos, fieldEnd, UT, FT) - fieldPos;
+
+                subField.length = (uint32_t) k;
+                subField.hasValue = k > 0;
+                fieldPos += k + 1;
+            }
         }
-        
-        result = true;
-        free (catalogContent);
+
+        ++ numOfInstances;
+
+        if (fieldPos == instanceStart || fieldPos >= fieldEnd) break;
     }
 
-    return result;
+    return numOfInstances;
 }
 
-std::string formatLat (double lat) {
-    double absLat = fabs (lat);
-    int deg = (int) absLat;
-    double min = (absLat - (double) deg) * 60.0;
-    char buffer [30];
-    sprintf (buffer, "%02d %06.3f%C", deg, min, lat < 0.0 ? 'S' : 'N');
+bool MappedS57File::open (const char *path) {
+    fieldTree.clear ();
+    dataDescriptiveFields.clear ();
+    firstRecord = 0;
 
-    return std::string (buffer);
-}
+    if (!file.open (path)) return false;
 
-std::string formatLon (double lon) {
-    double absLon = fabs (lon);
-    int deg = (int) absLon;
-    double min = (absLon - (double) deg) * 60.0;
-    char buffer [30];
-    sprintf (buffer, "%03d %06.3f%C", deg, min, lon < 0.0 ? 'W' : 'E');
+    if (file.size < sizeof (Leader)) {
+        file.close (); return false;
+    }
 
-    return std::string (buffer);
+    size_t ddrSize = parseDataDescriptiveRecord (file.data, fieldTree, dataDescriptiveFields);
+
+    firstRecord = file.data + ddrSize;
+
+    program.compile (dataDescriptiveFields);
+
+    return true;
 }
 
-void loadAttrDictionary (const char *path, AttrDictionary& dictionary) {
-    dictionary.clear ();
+bool MappedS57File::readRecord (const char *& pos, RecordView& record) {
+    record.fields.clear ();
 
-    char *content = 0;
-    size_t size = loadFileAndConvertToAnsi (path, content);
+    if (!pos || (end () - pos) < (ptrdiff_t) sizeof (Leader)) return false;
 
-    if (size && content) {
-        std::vector<std::string> lines;
+    Leader *leader = (Leader *) pos;
+    ParsedLeader parsedLeader (leader);
 
-        splitText (content, lines);
-        free (content);
+    if (parsedLeader.recLength < sizeof (Leader) || parsedLeader.recLength > (size_t) (end () - pos)) return false;
 
-        for (auto& line: lines) {
-            if (line [0] == '#') {
-                // New attr
-                std::vector<std::string> parts;
+    const char *recEnd = pos + parsedLeader.recLength;
+    const char *fieldArea = pos + parsedLeader.fldAreaBaseAddr;
+    const char *source = (const char *) (leader + 1);
+    size_t entrySize = parsedLeader.fieldTagSize + parsedLeader.fieldLengthSize + parsedLeader.fieldPosSize;
 
-                splitString (line.substr (1), parts, ',');
+    if (fieldArea > recEnd || parsedLeader.fieldTagSize != 4) return false;
 
-                if (parts.size () > 4) {
-                    std::string acronym = parts [0];
-                    uint16_t code = std::atoi (parts [1].c_str ());
-                    char domain = parts [3][0];
-                    std::string name = parts [4];
+    record.start = pos;
+    record.length = parsedLeader.recLength;
 
-                    dictionary.checkAddAttr (code, domain, acronym.c_str (), name.c_str ());
-                }
-            } else if (dictionary.items.size () > 0) {
-                if (dictionary.lastItem ().domain == 'E' || dictionary.lastItem ().domain == 'L') {
-                    std::vector<std::string> fields;
-                    splitString (line, fields, ':');
-                    if (fields.size () > 1) {
-                        dictionary.lastItem ().list.emplace (std::atoi (fields [0].c_str ()), fields [1]);
-                    }
-                }
-            }
-        }
+    for (; (source + entrySize) < fieldArea && *source != FT; source += entrySize) {
+        auto& field = record.fields.emplace_back ();
+        uint32_t position = parseField ((char *) source + parsedLeader.fieldTagSize + parsedLeader.fieldLengthSize, parsedLeader.fieldPosSize);
+
+        field.tag = source;
+        field.decoder = program.find (packTag (source));
+        field.data = fieldArea + position;
+        field.length = parseField ((char *) source + parsedLeader.fieldTagSize, parsedLeader.fieldLengthSize);
+
+        if (field.data > recEnd) field.data = recEnd;
+        if (field.data + field.length > recEnd) field.length = (uint32_t) (recEnd - field.data);
     }
+
+    pos = recEnd;
+
+    return true;
 }
 
-void loadObjectDictionary (const char *path, ObjectDictionary& dictionary) {
-    dictionary.clear ();
+// Owned field instances for the structure view. Building the strings and maps costs as much as the old directory
+// parser did (bench/decoder_bench.cpp), so this path gains nothing from the compiled decoder; charts never take it.
+void convertRecordView (RecordView& record, std::vector<FieldInstance>& fieldInstances, std::vector<SubFieldView>& subFields) {
+    fieldInstances.clear ();
 
-    char *content = 0;
-    size_t size = loadFileAndConvertToAnsi (path, content);
+    for (auto& field: record.fields) {
+        auto& fieldInstance = fieldInstances.emplace_back ();
+        size_t numOfInstances = field.decode (subFields);
+        size_t numOfSubFields = field.numOfSubFields ();
 
-    if (size && content) {
-        std::vector<std::string> lines;
+        fieldInstance.tag.assign (field.tag, 4);
 
-        splitText (content, lines);
-        free (content);
+        if (field.decoder) fieldInstance.name = field.decoder->desc->name;
 
-        for (auto& line: lines) {
-            if (line [0] == '#') {
-                // New object
-                std::vector<std::string> parts;
+        for (size_t i = 0; i < numOfInstances; ++ i) {
+            auto& fieldValueInstance = fieldInstance.instanceValues.emplace_back ();
 
-                splitString (line.substr (1), parts, ',');
+            for (size_t j = 0; j < numOfSubFields; ++ j) {
+                auto& subField = subFields [i * numOfSubFields + j];
+                auto& subFieldInstance = fieldValueInstance.emplace (subField.decoder->desc->tag, SubFieldInstance ()).first->second;
 
-                if (parts.size () > 3) {
-                    std::string acronym = parts [0];
-                    uint16_t code = std::atoi (parts [1].c_str ());
-                    std::string name = parts [3];
+                subFieldInstance.type = subField.type ();
 
-                    if (parts.size () > 4) {
-                        name += ',';
-                        name += parts [4];
-                    }
+                if (!subField.hasValue) continue;
 
-                    dictionary.checkAddObject (code, acronym.c_str (), name.c_str ());
+                switch (subField.type ()) {
+                    case 'I':
+                    case 'b':
+                        subFieldInstance.intValue = subField.intValue (); break;
+                    case 'A':
+                        subFieldInstance.stringValue = subField.stringValue (); break;
+                    case 'R':
+                        subFieldInstance.floatValue = subField.floatValue (); break;
+                    case 'B':
+                        subFieldInstance.binaryValue.assign (subField.binaryValue (), subField.binaryValue () + subField.length); break;
                 }
             }
         }
+
+        // Extractors always expect at least one instance
+        if (fieldInstance.instanceValues.empty ()) fieldInstance.instanceValues.emplace_back ();
     }
 }
 
-std::string extractToUnitTerm (char *&source) {
-    std::string result;
+size_t MappedS57File::scanRecords (std::vector<const char *>& recordStarts) {
+    const char *pos = firstRecord;
+
+    recordStarts.clear ();
 
-    while (*source && (*source != UT)) {
-        result += *(source++);
+    while (pos && (end () - pos) >= (ptrdiff_t) sizeof (Leader)) {
+        ParsedLeader parsedLeader ((Leader *) pos);
+
+        if (parsedLeader.recLength < sizeof (Leader) || parsedLeader.recLength > (size_t) (end () - pos)) break;
+
+        recordStarts.push_back (pos);
+        pos += parsedLeader.recLength;
     }
 
-    source++; return result;
+    return recordStarts.size ();
 }
 
-std::string extractFixedSize (char *&source, size_t size) {
-    std::string result;
+// Adds tasks converting the records of the file to field instances in ranges. Every record goes to its own
+// pre-allocated slot so ranges run on any thread, need no merge and keep the file order.
+static void addConvertTasks (MappedS57File& s57File, std::vector<const char *>& recordStarts, std::vector<std::vector<FieldInstance>>& records, std::vector<PoolTask>& tasks) {
+    static const size_t MIN_RECORDS_PER_TASK = 256;
+
+    records.clear ();
+    records.resize (s57File.scanRecords (recordStarts));
+
+    for (size_t first = 0; first < records.size (); first += MIN_RECORDS_PER_TASK) {
+        size_t last = first + MIN_RECORDS_PER_TASK < records.size () ? first + MIN_RECORDS_PER_TASK : records.size ();
 
-    result.append (source, size);
+        tasks.emplace_back ([&s57File, &recordStarts, &records, first, last] () {
+            RecordView record;
+            std::vector<SubFieldView> subFields;
 
-    source += size; return result;
+            for (size_t i = first; i < last; ++ i) {
+                const char *recStart = recordStarts [i];
+
+                if (s57File.readRecord (recStart, record)) convertRecordView (record, records [i], subFields);
+            }
+        });
+    }
 }
 
-void loadLibraryId (std::vector<std::string>& module, LibraryIdentification& libraryId) {
-    char *source = (char *) module [1].c_str () + 9;
+// Only the legacy openFile () takes this path, see convertRecordView ()
+bool loadParseS57File (char *path, std::vector<std::vector<FieldInstance>>& records, size_t numOfThreads) {
+    MappedS57File s57File;
+    std::vector<const char *> recordStarts;
+    std::vector<PoolTask> tasks;
 
-    libraryId.moduleName = extractFixedSize (source, 2);
-    libraryId.rcid = std::atol (extractFixedSize (source, 5).c_str ());
-    libraryId.exchangePurpose = extractFixedSize (source, 3);
-    libraryId.productType = extractToUnitTerm (source);
-    libraryId.exchangeSetSerialNo = extractToUnitTerm (source);
-    libraryId.editionNo = extractToUnitTerm (source);
-    libraryId.compilationDate = extractFixedSize (source, 8);
-    libraryId.compilationTime = extractFixedSize (source, 6);
-    libraryId.libraryProfileVersionsDate = extractFixedSize (source, 8);
-    libraryId.libaryAppProfile = extractFixedSize (source, 2);
-    libraryId.objectCatVersionDate = extractFixedSize (source, 8);
-    libraryId.comment = extractToUnitTerm (source);
+    records.clear ();
+
+    if (!s57File.open (path)) return false;
+
+    addConvertTasks (s57File, recordStarts, records, tasks);
+    runWorkStealing (tasks, numOfThreads);
+
+    return true;
 }
-/*
-void loadColorTable (std::vector<std::string>& module, ColorTable& colorTable) {
-    return;
-    colorTable.clear ();
 
-    for (auto& line: module) {
-        char *source = (char *) line.c_str ();
+// Subfield slots of one field type resolved once per file against the compiled DDR
+struct FieldSlots {
+    FieldDecoder *decoder;
+    size_t numOfSubFields;
+    std::vector<size_t> slots;
 
-        if (memcmp (source, "CCIE", 4) == 0) {
-            source += 9;
-            std::string colorCode = extractFixedSize (source, 5);
-            double x = std::atof (extractToUnitTerm (source).c_str ());
-            double y = std::atof (extractToUnitTerm (source).c_str ());
-            double z = std::atof (extractToUnitTerm (source).c_str ());
-            std::string colorName = extractToUnitTerm (source);
+    FieldSlots (): decoder (0), numOfSubFields (0) {}
 
-            colorTable.emplace (colorCode, ColorItem (colorName.c_str (), x, y, z));
+    void resolve (DdrProgram& program, const char *tag, std::initializer_list<const char *> subFieldTags) {
+        decoder = program.find (tag);
+        numOfSubFields = decoder ? decoder->subFields.size () : 0;
+        slots.clear ();
+
+        for (auto subFieldTag: subFieldTags) {
+            slots.push_back (decoder ? decoder->slot (subFieldTag) : FieldDecoder::NO_SLOT);
         }
     }
-}
-*/
-void parseLineStyle (const char *instruction, int& penStyle, int& penWidth, size_t& penIndex, Dai& dai) {
-    char *comma1 = strchr ((char *) instruction + 3, ',');
-    char *comma2 = comma1 ? strchr (comma1 + 1, ',') : 0;
 
-    if (comma1 && comma2) {
-        if (memcmp (instruction + 3, "SOLD", 4) == 0) {
-            penStyle = PS_SOLID;
-        } else if (memcmp (instruction + 3, "DASH", 4) == 0) {
-            penStyle = PS_DASH;
-        } else if (memcmp (instruction + 3, "DOTT", 4) == 0) {
-            penStyle = PS_DOT;
-        } else {
-            penStyle = PS_SOLID;
-        }
+    // Offset of 32-bit binary subfield inside fixed size instance, NO_SLOT if the layout is not like that
+    size_t int32Offset (size_t index) {
+        size_t slot = slots [index];
 
-        penWidth = isdigit (comma1 [1]) ? comma1 [1] - '0' : 1;
-        penIndex = dai.getBasePenIndex (std::string (comma2 + 1, 5).c_str ());
-    } else {
-        penStyle = PS_SOLID;
-        penWidth = 1;
-        penIndex = dai.getBasePenIndex ("CHBLK");
-    }
-}
+        if (slot == FieldDecoder::NO_SLOT || !decoder->instanceSize) return FieldDecoder::NO_SLOT;
 
-void processInstructions (Dai& dai, AttrDictionary& attrDic, LookupTableItem& item, std::vector<std::string>& instructions) {
-    auto extractInstr = [] (std::string& instruction) {
-        size_t leftBracketPos = instruction.find ('(', 2);
-        size_t rightBracketPos = leftBracketPos == std::string::npos ? std::string::npos : instruction.find (')', leftBracketPos + 1);
-        return std::string (rightBracketPos == std::string::npos ? "" : instruction.substr (leftBracketPos + 1, rightBracketPos - leftBracketPos - 1));
-    };
+        auto& subField = decoder->subFields [slot];
 
-    for (auto& instruction: instructions) {
-        if (instruction [0] == 'L' && instruction [1] == 'S') {
-            item.penIndex = dai.palette.checkPen (instruction.data (), dai.colorTable);
-            parseLineStyle (instruction.c_str (), item.edgePenStyle, item.edgePenWidth, item.edgePenIndex, dai);
-        } else if (instruction [0] == 'S' && instruction [1] == 'Y') {
-            auto symbolName = extractInstr (instruction);
+        return (subField.format == 'b' && subField.width == 4) ? subField.offset : FieldDecoder::NO_SLOT;
+    }
 
-            if (!symbolName.empty ()) {
-                size_t index = dai.getSymbolIndex (symbolName.c_str ());
-                if (index != LookupTableItem::NOT_EXIST) item.symbols.emplace_back (index, 0.0);
-            }
-        } else if (instruction [0] == 'A' && instruction [1] == 'C') {
-            auto colorName = extractInstr (instruction);
+    // Returns subfield of the given instance if it exists and has a value
+    SubFieldView *get (std::vector<SubFieldView>& subFields, size_t instance, size_t index) {
+        size_t slot = slots [index];
 
-            if (!colorName.empty ()) item.brushIndex = dai.palette.getSolidBrushIndex (colorName.c_str ());
-        } else if (instruction [0] == 'T' && (instruction [1] == 'X' || instruction [1] == 'E')) {
-            item.textInstructions.emplace_back (instruction);
-            auto &desc = item.textDescriptions.emplace_back ();
-            parseTextInstruction (instruction.c_str (), dai, attrDic, desc);
-        } else if (instruction [0] == 'C' && instruction [1] == 'S') {
-            auto procName = extractInstr (instruction);
+        if (slot == FieldDecoder::NO_SLOT) return 0;
 
-            if (!procName.empty ()) item.procIndex = dai.getProcIndex (procName.c_str ());
-        } else if (instruction [0] == 'A' && instruction [1] == 'P') {
-            auto patternName = extractInstr (instruction);
+        auto& subField = subFields [instance * numOfSubFields + slot];
 
-            if (!patternName.empty ()) item.patternBrushIndex = dai.palette.getPatternBrushIndex (patternName.c_str ());
-        }
+        return subField.hasValue ? & subField : 0;
+    }
+};
+
+enum DsidSlots { DSID_EDTN, DSID_UPDN };
+enum DspmSlots { DSPM_COMF, DSPM_SOMF, DSPM_COMT, DSPM_COUN, DSPM_CSCL, DSPM_DUNI, DSPM_HDAT, DSPM_HUNI, DSPM_PUNI, DSPM_SDAT, DSPM_VDAT };
+enum RecIdSlots { RECID_RCNM, RECID_RCID, RECID_RUIN, RECID_RVER, RECID_GRUP, RECID_OBJL, RECID_PRIM };
+enum FoidSlots { FOID_AGEN, FOID_FIDN, FOID_FIDS };
+enum AttrSlots { ATTR_ATTL, ATTR_ATVL };
+enum PointerSlots { PTR_NAME, PTR_ORNT, PTR_USAG, PTR_MASK, PTR_TOPI };
+enum CoordSlots { COORD_YCOO, COORD_XCOO, COORD_VE3D };
+
+double convertDepth (double depth, DatasetParams& params) {
+    if (params.depthMeasurement.has_value ()) {
+        switch (params.depthMeasurement.value ()) {
+            case DUNI::DepthFeet: {
+                return depth * 0.3048;
+            }
+            case DUNI::DepthFathomsFractions: {
+                return depth * 6.0 * 0.3048;
+            }
+            case DUNI::DepthFathomsFeet: {
+                double roundedDepth = round (depth);
+                double fractionalDepth = depth - roundedDepth;
+                return roundedDepth * 6.0 * 0.3048 + fractionalDepth * 0.3048;
+            }
+        }
+    }
+
+    return depth;
+}
+
+static inline int32_t readInt32 (const char *data) {
+    int32_t value;
+
+    memcpy (& value, data, sizeof (value));
+
+    return value;
+}
+
+// Cell integers of SG2D/SG3D instances to degrees. YCOO and XCOO are adjacent in every standard layout, then SSE2
+// converts and scales both of them at once and stores them as the lat/lon pair of the position
+static void scaleCoords (const char *instance, size_t instanceSize, size_t latOffset, size_t lonOffset, size_t count, double scale, Position *point) {
+    #if defined (SCAN_SSE2)
+    if (lonOffset == latOffset + sizeof (int32_t)) {
+        const __m128d scales = _mm_set1_pd (scale);
+
+        for (instance += latOffset; count > 0; -- count, ++ point, instance += instanceSize) {
+            _mm_storeu_pd (& point->lat, _mm_mul_pd (_mm_cvtepi32_pd (_mm_loadl_epi64 ((const __m128i *) instance)), scales));
+        }
+        return;
+    }
+    #endif
+
+    for (; count > 0; -- count, ++ point, instance += instanceSize) {
+        point->lat = readInt32 (instance + latOffset) * scale;
+        point->lon = readInt32 (instance + lonOffset) * scale;
+    }
+}
+
+// Same for the fixed point pool, an adjacent pair is copied as a single 64-bit value
+static void copyCoords (const char *instance, size_t instanceSize, size_t latOffset, size_t lonOffset, size_t count, FixedPosition *point) {
+    if (lonOffset == latOffset + sizeof (int32_t)) {
+        for (instance += latOffset; count > 0; -- count, ++ point, instance += instanceSize) memcpy (point, instance, sizeof (int32_t) * 2);
+    } else {
+        for (; count > 0; -- count, ++ point, instance += instanceSize) {
+            point->lat = readInt32 (instance + latOffset);
+            point->lon = readInt32 (instance + lonOffset);
+        }
+    }
+}
+
+// Routes every record to the node/edge/feature builder in one pass over the file.
+// Foreign keys (edge begin/end nodes, feature nodes and edges) are kept raw in the index fields
+// while reading and resolved by resolveForeignKeys () once all the records are in.
+struct ChartExtractor {
+    Chart& chart;
+    FieldSlots dsid, dspm, vrid, attv, vrpt, sg2d, sg3d, frid, foid, attf, fspt;
+    std::vector<SubFieldView> subFields;
+
+    ChartExtractor (Chart& _chart, DdrProgram& program): chart (_chart) {
+        dsid.resolve (program, "DSID", { "EDTN", "UPDN" });
+        dspm.resolve (program, "DSPM", { "COMF", "SOMF", "COMT", "COUN", "CSCL", "DUNI", "HDAT", "HUNI", "PUNI", "SDAT", "VDAT" });
+        vrid.resolve (program, "VRID", { "RCNM", "RCID", "RUIN", "RVER" });
+        attv.resolve (program, "ATTV", { "ATTL", "ATVL" });
+        vrpt.resolve (program, "VRPT", { "NAME", "ORNT", "USAG", "MASK", "TOPI" });
+        sg2d.resolve (program, "SG2D", { "YCOO", "XCOO" });
+        sg3d.resolve (program, "SG3D", { "YCOO", "XCOO", "VE3D" });
+        frid.resolve (program, "FRID", { "RCNM", "RCID", "RUIN", "RVER", "GRUP", "OBJL", "PRIM" });
+        foid.resolve (program, "FOID", { "AGEN", "FIDN", "FIDS" });
+        attf.resolve (program, "ATTF", { "ATTL", "ATVL" });
+        fspt.resolve (program, "FSPT", { "NAME", "ORNT", "USAG", "MASK" });
+    }
+
+    // Scaled by the reciprocal so the generic and the bulk paths round the same way
+    double coord (SubFieldView *value) {
+        return (value && chart.params.coordMultiplier) ? (double) (int32_t) value->intValue () * (1.0 / (double) chart.params.coordMultiplier.value ()) : 0.0;
+    }
+
+    double depth (SubFieldView *value) {
+        return (value && chart.params.soundingMultiplier) ? convertDepth ((double) (int32_t) value->intValue () * (1.0 / (double) chart.params.soundingMultiplier.value ()), chart.params) : 0.0;
+    }
+
+    static uint64_t foreignKey (SubFieldView *name) {
+        return (name && name->length >= 5) ? constructForeignKey (name->binaryValue ()) : LookupTableItem::NOT_EXIST;
+    }
+
+    static uint32_t intValue (SubFieldView *value, uint32_t defValue = 0) {
+        return value ? value->intValue () : defValue;
+    }
+
+    // SG2D/SG3D fast path: fixed size b24 coordinate groups are decoded straight from the field in one tight loop.
+    // Returns false if the field layout doesn't allow that, the generic subfield path should be used then.
+    bool appendCoords (FieldView& field, FieldSlots& slots, PositionSpan& points, size_t maxInstances = SIZE_MAX) {
+        size_t instanceSize = field.decoder->instanceSize;
+        size_t latOffset = slots.int32Offset (COORD_YCOO);
+        size_t lonOffset = slots.int32Offset (COORD_XCOO);
+        size_t depthOffset = slots.slots.size () > COORD_VE3D ? slots.int32Offset (COORD_VE3D) : FieldDecoder::NO_SLOT;
+        bool withDepth = slots.slots.size () > COORD_VE3D;
+
+        if (!instanceSize || !chart.params.coordMultiplier || latOffset == FieldDecoder::NO_SLOT || lonOffset == FieldDecoder::NO_SLOT) return false;
+        if (withDepth && (depthOffset == FieldDecoder::NO_SLOT || !chart.params.soundingMultiplier)) return false;
+
+        size_t payload = (field.length > 0 && field.data [field.length - 1] == FT) ? field.length - 1 : field.length;
+        size_t numOfInstances = min (payload / instanceSize, maxInstances);
+        const double coordScale = 1.0 / (double) chart.params.coordMultiplier.value ();
+        const double soundingScale = withDepth ? 1.0 / (double) chart.params.soundingMultiplier.value () : 0.0;
+        const bool convert = withDepth && chart.params.depthMeasurement.has_value () && chart.params.depthMeasurement.value () != DUNI::DepthMeters;
+        size_t firstIndex = chart.coords.grow (points, numOfInstances);
+
+        // Fixed point pool takes the cell integers as they are
+        if (chart.coords.fixedPoint) {
+            FixedPosition *first = chart.coords.fixedPositions.data () + firstIndex;
+
+            copyCoords (field.data, instanceSize, latOffset, lonOffset, numOfInstances, first);
+
+            if (withDepth) {
+                const char *depthPos = field.data + depthOffset;
+
+                for (size_t i = 0; i < numOfInstances; ++ i, depthPos += instanceSize) {
+                    double value = readInt32 (depthPos) * soundingScale;
+
+                    first [i].depth = (float) (convert ? convertDepth (value, chart.params) : value);
+                }
+            } else {
+                for (size_t i = 0; i < numOfInstances; ++ i) first [i].depth = 0.0f;
+            }
+
+            return true;
+        }
+
+        Position *first = chart.coords.positions.data () + firstIndex;
+
+        scaleCoords (field.data, instanceSize, latOffset, lonOffset, numOfInstances, coordScale, first);
+
+        if (withDepth) {
+            const char *depthPos = field.data + depthOffset;
+
+            for (size_t i = 0; i < numOfInstances; ++ i, depthPos += instanceSize) first [i].depth = readInt32 (depthPos) * soundingScale;
+
+            if (convert) {
+                for (size_t i = 0; i < numOfInstances; ++ i) first [i].depth = convertDepth (first [i].depth, chart.params);
+            }
+        }
+
+        return true;
+    }
+
+    void processRecord (RecordView& record) {
+        for (auto& field: record.fields) {
+            if (!field.decoder) continue;
+
+            if (field.decoder == vrid.decoder) {
+                processVectorRecord (record); break;
+            } else if (field.decoder == frid.decoder) {
+                processFeatureRecord (record); break;
+            } else if (field.decoder == dsid.decoder) {
+                processDatasetId (field, chart.params.edition, chart.params.updateNumber); break;
+            } else if (field.decoder == dspm.decoder) {
+                processDatasetParams (field); break;
+            }
+        }
+    }
+
+    // Vector and feature records follow the dataset description ones
+    bool isObjectRecord (RecordView& record) {
+        for (auto& field: record.fields) {
+            if (field.decoder && (field.decoder == vrid.decoder || field.decoder == frid.decoder)) return true;
+        }
+
+        return false;
+    }
+
+    void processDatasetId (FieldView& field, std::optional<std::string>& edition, std::optional<uint32_t>& updateNumber) {
+        if (field.decode (subFields) == 0) return;
+
+        if (auto value = dsid.get (subFields, 0, DSID_EDTN)) edition = value->stringValue ();
+        if (auto value = dsid.get (subFields, 0, DSID_UPDN)) updateNumber = value->intValue ();
+    }
+
+    void processDatasetParams (FieldView& field) {
+        auto& params = chart.params;
+
+        if (field.decode (subFields) == 0) return;
+
+        if (auto value = dspm.get (subFields, 0, DSPM_COMF)) params.coordMultiplier = value->intValue ();
+        if (auto value = dspm.get (subFields, 0, DSPM_SOMF)) params.soundingMultiplier = value->intValue ();
+        if (auto value = dspm.get (subFields, 0, DSPM_COMT)) params.comment = value->stringValue ();
+        if (auto value = dspm.get (subFields, 0, DSPM_COUN)) params.coordUnit = (COUN) value->intValue ();
+        if (auto value = dspm.get (subFields, 0, DSPM_CSCL)) params.compilationScale = value->intValue ();
+        if (auto value = dspm.get (subFields, 0, DSPM_DUNI)) params.depthMeasurement = (DUNI) value->intValue ();
+        if (auto value = dspm.get (subFields, 0, DSPM_HDAT)) params.horDatum = (HDAT) value->intValue ();
+        if (auto value = dspm.get (subFields, 0, DSPM_HUNI)) params.heightMeasurement = (HUNI) value->intValue ();
+        if (auto value = dspm.get (subFields, 0, DSPM_PUNI)) params.posMeasurement = (PUNI) value->intValue ();
+        if (auto value = dspm.get (subFields, 0, DSPM_SDAT)) params.soundingDatum = value->intValue ();
+        if (auto value = dspm.get (subFields, 0, DSPM_VDAT)) params.verDatum = value->intValue ();
+
+        chart.coords.setCoordMultiplier (params.coordMultiplier.value_or (0));
+    }
+
+    void addAttributes (FieldSlots& slots, size_t numOfInstances, std::vector<Attr>& attributes) {
+        for (size_t i = 0; i < numOfInstances; ++ i) {
+            auto attl = slots.get (subFields, i, ATTR_ATTL);
+
+            if (!attl) continue;
+
+            auto atvl = slots.get (subFields, i, ATTR_ATVL);
+            auto& attr = attributes.emplace_back ();
+
+            attr.classCode = attl->intValue ();
+            attr.noValue = atvl == 0;
+
+            if (atvl) attr.setText (chart.strings, atvl->data, atvl->length);
+        }
+    }
+
+    void processVectorRecord (RecordView& record) {
+        GeoNode *node = 0;
+        GeoEdge *edge = 0;
+
+        for (auto& field: record.fields) {
+            if (!field.decoder) continue;
+
+            if (field.decoder == sg2d.decoder && (node || edge)) {
+                if (node ? appendCoords (field, sg2d, node->points, 1) : appendCoords (field, sg2d, edge->internalNodes)) continue;
+            } else if (field.decoder == sg3d.decoder && node) {
+                PositionSpan soundings;
+
+                // Soundings go in front of any positions the node already has
+                if (appendCoords (field, sg3d, node->points.empty () ? node->points : soundings)) {
+                    node->flags |= NodeFlags::SOUNDING_ARRAY;
+                    if (!soundings.empty ()) {
+                        auto soundingPoints = chart.coords.copy (soundings);
+                        chart.coords.insert (node->points, 0, soundingPoints.data (), soundingPoints.size ());
+                    }
+                    continue;
+                }
+            }
+
+            size_t numOfInstances = field.decode (subFields);
+
+            if (numOfInstances == 0) continue;
+
+            if (field.decoder == vrid.decoder) {
+                uint8_t recName = intValue (vrid.get (subFields, 0, RECID_RCNM));
+                uint32_t rcid = intValue (vrid.get (subFields, 0, RECID_RCID));
+                TopologyObject *object;
+
+                if (!rcid) return;
+
+                switch (recName) {
+                    case RCNM::IsolatedNode:
+                    case RCNM::ConnectedNode:
+                        object = node = & chart.nodes.emplace_back (); break;
+                    case RCNM::Edge:
+                        object = edge = & chart.edges.emplace_back (); break;
+                    default:
+                        return;
+                }
+
+                object->id = rcid;
+                object->recordName = recName;
+                object->updateInstruction = intValue (vrid.get (subFields, 0, RECID_RUIN));
+                object->version = intValue (vrid.get (subFields, 0, RECID_RVER));
+            } else if (field.decoder == sg2d.decoder) {
+                if (node) {
+                    Position point { coord (sg2d.get (subFields, 0, COORD_YCOO)), coord (sg2d.get (subFields, 0, COORD_XCOO)), 0.0 };
+                    chart.coords.append (node->points, & point, 1);
+                } else if (edge) {
+                    size_t first = chart.coords.grow (edge->internalNodes, numOfInstances);
+
+                    for (size_t i = 0; i < numOfInstances; ++ i) {
+                        chart.coords.set (first + i, { coord (sg2d.get (subFields, i, COORD_YCOO)), coord (sg2d.get (subFields, i, COORD_XCOO)), 0.0 });
+                    }
+                }
+            } else if (field.decoder == sg3d.decoder && node) {
+                std::vector<Position> soundings;
+
+                node->flags |= NodeFlags::SOUNDING_ARRAY;
+                soundings.reserve (numOfInstances);
+
+                for (size_t i = 0; i < numOfInstances; ++ i) {
+                    auto& point = soundings.emplace_back ();
+                    point.lat = coord (sg3d.get (subFields, i, COORD_YCOO));
+                    point.lon = coord (sg3d.get (subFields, i, COORD_XCOO));
+                    point.depth = depth (sg3d.get (subFields, i, COORD_VE3D));
+                }
+
+                chart.coords.insert (node->points, 0, soundings.data (), soundings.size ());
+            } else if (field.decoder == attv.decoder && edge) {
+                addAttributes (attv, numOfInstances, edge->attributes);
+            } else if (field.decoder == vrpt.decoder && edge) {
+                for (size_t i = 0; i < numOfInstances; ++ i) {
+                    uint64_t key = foreignKey (vrpt.get (subFields, i, PTR_NAME));
+
+                    if (key == LookupTableItem::NOT_EXIST) continue;
+
+                    switch (intValue (vrpt.get (subFields, i, PTR_TOPI))) {
+                        case TOPI::BeginningNode:
+                            edge->beginIndex = key; break;
+                        case TOPI::EndNode:
+                            edge->endIndex = key; break;
+                    }
+                }
+            }
+        }
+    }
+
+    void processFeatureRecord (RecordView& record) {
+        FeatureObject *feature = 0;
+
+        for (auto& field: record.fields) {
+            if (!field.decoder) continue;
+
+            size_t numOfInstances = field.decode (subFields);
+
+            if (numOfInstances == 0) continue;
+
+            if (field.decoder == frid.decoder) {
+                uint8_t recName = intValue (frid.get (subFields, 0, RECID_RCNM));
+                uint32_t rcid = intValue (frid.get (subFields, 0, RECID_RCID));
+
+                if (!rcid || recName != RCNM::Feature) return;
+
+                feature = & chart.features.emplace_back ();
+                feature->id = rcid;
+                feature->recordName = recName;
+                feature->updateInstruction = intValue (frid.get (subFields, 0, RECID_RUIN));
+                feature->version = intValue (frid.get (subFields, 0, RECID_RVER));
+                feature->group = intValue (frid.get (subFields, 0, RECID_GRUP));
+                feature->classCode = intValue (frid.get (subFields, 0, RECID_OBJL));
+                feature->primitive = intValue (frid.get (subFields, 0, RECID_PRIM));
+            } else if (!feature) {
+                continue;
+            } else if (field.decoder == foid.decoder) {
+                feature->agency = intValue (foid.get (subFields, 0, FOID_AGEN));
+                feature->fidn = intValue (foid.get (subFields, 0, FOID_FIDN));
+                feature->subDiv = intValue (foid.get (subFields, 0, FOID_FIDS));
+            } else if (field.decoder == attf.decoder) {
+                addAttributes (attf, numOfInstances, feature->attributes);
+            } else if (field.decoder == fspt.decoder) {
+                switch (feature->primitive) {
+                    case PRIM::Point: {
+                        uint64_t key = foreignKey (fspt.get (subFields, 0, PTR_NAME));
+
+                        if (key != LookupTableItem::NOT_EXIST) feature->nodeIndex = key;
+                        break;
+                    }
+                    case PRIM::Line:
+                    case PRIM::Area: {
+                        feature->edgeRefs.reserve (feature->edgeRefs.size () + numOfInstances);
+
+                        for (size_t i = 0; i < numOfInstances; ++ i) {
+                            uint64_t key = foreignKey (fspt.get (subFields, i, PTR_NAME));
+
+                            if (key == LookupTableItem::NOT_EXIST) continue;
+
+                            auto& edgeRef = feature->edgeRefs.emplace_back ();
+                            edgeRef.index = key;
+                            edgeRef.hidden = intValue (fspt.get (subFields, i, PTR_MASK)) == 1;
+                            edgeRef.hole = intValue (fspt.get (subFields, i, PTR_USAG)) == USAG::Interior;
+                            edgeRef.unclockwise = intValue (fspt.get (subFields, i, PTR_ORNT)) == ORNT::Reverse;
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    void resolveEdgeKeys (GeoEdge& edge) {
+        if (edge.beginIndex != LookupTableItem::NOT_EXIST) edge.beginIndex = chart.nodes.getIndexByForgeignKey (edge.beginIndex);
+        if (edge.endIndex != LookupTableItem::NOT_EXIST) edge.endIndex = chart.nodes.getIndexByForgeignKey (edge.endIndex);
+    }
+
+    void resolveFeatureKeys (FeatureObject& feature) {
+        if (feature.nodeIndex != LookupTableItem::NOT_EXIST) feature.nodeIndex = chart.nodes.getIndexByForgeignKey (feature.nodeIndex);
+
+        for (auto edgeRef = feature.edgeRefs.begin (); edgeRef != feature.edgeRefs.end ();) {
+            edgeRef->index = chart.edges.getIndexByForgeignKey (edgeRef->index);
+
+            if (edgeRef->index == LookupTableItem::NOT_EXIST) {
+                edgeRef = feature.edgeRefs.erase (edgeRef);
+            } else {
+                ++ edgeRef;
+            }
+        }
+    }
+
+    void resolveForeignKeys () {
+        chart.nodes.buildIndex ();
+        chart.edges.buildIndex ();
+        chart.features.buildIndex ();
+
+        for (auto& edge: chart.edges) resolveEdgeKeys (edge);
+        for (auto& feature: chart.features) resolveFeatureKeys (feature);
+    }
+};
+
+enum UpdateControlSlots { UPD_INSTRUCTION, UPD_INDEX, UPD_COUNT };
+
+// Applies the records of an update (ER) file to the already built chart. Deleted objects become tombstones so
+// every index stays valid, inserted ones are appended. Foreign keys are resolved on the fly, that's why the file is
+// walked three times: nodes first, then edges, then features. Only the objects touched are collected for
+// the topology refresh afterwards.
+struct ChartUpdater: ChartExtractor {
+    enum Pass { NODES, EDGES, FEATURES };
+
+    struct UpdateControl {
+        uint32_t instruction;
+        size_t index;           // 1-based
+        size_t count;
+    };
+
+    struct VectorPointer {
+        size_t index;
+        uint32_t topology;
+    };
+
+    FieldSlots vrpc, sgcc, fspc;
+    std::set<size_t> changedNodes, changedEdges, changedFeatures;
+    bool edgesDeleted;
+
+    ChartUpdater (Chart& _chart, DdrProgram& program): ChartExtractor (_chart, program), edgesDeleted (false) {
+        vrpc.resolve (program, "VRPC", { "VPUI", "VPIX", "NVPT" });
+        sgcc.resolve (program, "SGCC", { "CCUI", "CCIX", "CCNC" });
+        fspc.resolve (program, "FSPC", { "FSUI", "FSIX", "NSPT" });
+    }
+
+    UpdateControl getControl (FieldSlots& slots) {
+        return { intValue (slots.get (subFields, 0, UPD_INSTRUCTION)), intValue (slots.get (subFields, 0, UPD_INDEX), 1), intValue (slots.get (subFields, 0, UPD_COUNT)) };
+    }
+
+    // Inserts, deletes or replaces items starting at the control index; without control the list is replaced as a whole
+    template<typename T> static void applyControl (std::vector<T>& items, std::vector<T>& updates, std::optional<UpdateControl>& control) {
+        if (!control) {
+            items.swap (updates); return;
+        }
+
+        size_t pos = control->index > 0 ? min (control->index - 1, items.size ()) : 0;
+
+        switch (control->instruction) {
+            case RUIN::RuinInsert:
+                items.insert (items.begin () + pos, updates.begin (), updates.end ()); break;
+            case RUIN::RuinDelete:
+                items.erase (items.begin () + pos, items.begin () + min (pos + control->count, items.size ())); break;
+            case RUIN::RuinModify:
+                for (size_t i = 0; i < updates.size () && pos + i < items.size (); ++ i) items [pos + i] = updates [i];
+                break;
+        }
+
+        control.reset ();
+    }
+
+    // Delete instruction comes without the data field, so it is applied as soon as the control field is read
+    template<typename T> static void checkApplyDelete (std::vector<T>& items, std::optional<UpdateControl>& control) {
+        std::vector<T> noUpdates;
+
+        if (control && control->instruction == RUIN::RuinDelete) applyControl (items, noUpdates, control);
+    }
+
+    bool identify (RecordView& record, FieldSlots& slots, uint8_t& recName, uint32_t& rcid, uint32_t& instruction, uint32_t& version) {
+        for (auto& field: record.fields) {
+            if (!field.decoder || field.decoder != slots.decoder || field.decode (subFields) == 0) continue;
+
+            recName = intValue (slots.get (subFields, 0, RECID_RCNM));
+            rcid = intValue (slots.get (subFields, 0, RECID_RCID));
+            instruction = intValue (slots.get (subFields, 0, RECID_RUIN));
+            version = intValue (slots.get (subFields, 0, RECID_RVER));
+
+            return rcid != 0;
+        }
+
+        return false;
+    }
+
+    void updateAttributes (FieldSlots& slots, size_t numOfInstances, std::vector<Attr>& attributes) {
+        for (size_t i = 0; i < numOfInstances; ++ i) {
+            auto attl = slots.get (subFields, i, ATTR_ATTL);
+
+            if (!attl) continue;
+
+            auto atvl = slots.get (subFields, i, ATTR_ATVL);
+            uint16_t classCode = attl->intValue ();
+            auto attr = attributes.begin ();
+
+            while (attr != attributes.end () && attr->classCode != classCode) ++ attr;
+
+            if (atvl && atvl->length == 1 && atvl->data [0] == DEL) {
+                if (attr != attributes.end ()) attributes.erase (attr);
+                continue;
+            }
+
+            if (attr == attributes.end ()) attr = attributes.emplace (attributes.end ());
+
+            *attr = Attr ();
+            attr->classCode = classCode;
+            attr->noValue = atvl == 0;
+
+            if (atvl) attr->setText (chart.strings, atvl->data, atvl->length);
+        }
+    }
+
+    template<typename Collection> size_t appendInserted (Collection& collection, size_t sizeBefore) {
+        if (collection.size () == sizeBefore) return LookupTableItem::NOT_EXIST;
+
+        auto& object = collection.back ();
+
+        collection.index.set (constructForeignKey (object.recordName, object.id), sizeBefore);
+
+        return sizeBefore;
+    }
+
+    template<typename Collection> size_t markDeleted (Collection& collection, uint8_t recName, uint32_t rcid) {
+        uint64_t key = constructForeignKey (recName, rcid);
+        size_t index = collection.getIndexByForgeignKey (key);
+
+        if (index != LookupTableItem::NOT_EXIST) {
+            collection [index].flags |= TopologyFlags::DELETED;
+            collection.index.erase (key);
+        }
+
+        return index;
+    }
+
+    // Modify and delete instructions only apply on top of the version they were issued against
+    template<typename Collection> bool isNextVersion (Collection& collection, uint8_t recName, uint32_t rcid, uint32_t version) {
+        size_t index = collection.getIndexByForgeignKey (constructForeignKey (recName, rcid));
+
+        return index != LookupTableItem::NOT_EXIST && collection [index].version + 1 == version;
+    }
+
+    // Reads EDTN/UPDN of the update file from its DSID record, which comes first
+    bool readDatasetId (MappedS57File& updateFile, std::optional<std::string>& edition, std::optional<uint32_t>& updateNumber) {
+        RecordView record;
+        const char *recStart = updateFile.firstRecord;
+
+        while (updateFile.readRecord (recStart, record)) {
+            for (auto& field: record.fields) {
+                if (field.decoder && field.decoder == dsid.decoder) {
+                    processDatasetId (field, edition, updateNumber); return updateNumber.has_value ();
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void processRecord (RecordView& record, Pass pass) {
+        uint8_t recName;
+        uint32_t rcid, instruction, version;
+
+        if (pass == FEATURES) {
+            if (identify (record, frid, recName, rcid, instruction, version) && recName == RCNM::Feature) updateFeature (record, rcid, instruction, version);
+        } else if (identify (record, vrid, recName, rcid, instruction, version)) {
+            bool isNode = recName == RCNM::IsolatedNode || recName == RCNM::ConnectedNode;
+
+            if ((isNode && pass == NODES) || (recName == RCNM::Edge && pass == EDGES)) updateVector (record, recName, rcid, instruction, version);
+        }
+    }
+
+    void updateVector (RecordView& record, uint8_t recName, uint32_t rcid, uint32_t instruction, uint32_t version) {
+        bool isEdge = recName == RCNM::Edge;
+        size_t index;
+
+        if (instruction != RUIN::RuinInsert) {
+            if (!(isEdge ? isNextVersion (chart.edges, recName, rcid, version) : isNextVersion (chart.nodes, recName, rcid, version))) return;
+        }
+
+        switch (instruction) {
+            case RUIN::RuinInsert: {
+                size_t sizeBefore = isEdge ? chart.edges.size () : chart.nodes.size ();
+
+                processVectorRecord (record);
+
+                if (isEdge) {
+                    index = appendInserted (chart.edges, sizeBefore);
+                    if (index != LookupTableItem::NOT_EXIST) resolveEdgeKeys (chart.edges [index]);
+                } else {
+                    index = appendInserted (chart.nodes, sizeBefore);
+                }
+                break;
+            }
+            case RUIN::RuinDelete: {
+                if (isEdge) {
+                    index = markDeleted (chart.edges, recName, rcid);
+
+                    if (index != LookupTableItem::NOT_EXIST) {
+                        auto& edge = chart.edges [index];
+                        edge.internalNodes = PositionSpan ();
+                        edge.attributes.clear ();
+                        edgesDeleted = true;
+                    }
+                } else {
+                    index = markDeleted (chart.nodes, recName, rcid);
+
+                    if (index != LookupTableItem::NOT_EXIST) chart.nodes [index].points = PositionSpan ();
+                }
+                break;
+            }
+            case RUIN::RuinModify: {
+                index = isEdge ? chart.edges.getIndexByForgeignKey (constructForeignKey (recName, rcid)) : chart.nodes.getIndexByForgeignKey (constructForeignKey (recName, rcid));
+
+                if (index == LookupTableItem::NOT_EXIST) return;
+
+                if (isEdge) {
+                    auto& edge = chart.edges [index];
+                    edge.version = version;
+                    modifyVector (record, edge, edge.internalNodes, & edge);
+                } else {
+                    auto& node = chart.nodes [index];
+                    node.version = version;
+                    modifyVector (record, node, node.points, 0);
+                }
+                break;
+            }
+            default:
+                return;
+        }
+
+        if (index != LookupTableItem::NOT_EXIST) (isEdge ? changedEdges : changedNodes).insert (index);
+    }
+
+    void modifyVector (RecordView& record, TopologyObject& object, PositionSpan& span, GeoEdge *edge) {
+        std::optional<UpdateControl> coordControl, pointerControl;
+        std::vector<Position> coords = chart.coords.copy (span);
+
+        for (auto& field: record.fields) {
+            if (!field.decoder) continue;
+
+            size_t numOfInstances = field.decode (subFields);
+
+            if (numOfInstances == 0) continue;
+
+            if (field.decoder == sgcc.decoder) {
+                coordControl = getControl (sgcc);
+                checkApplyDelete (coords, coordControl);
+            } else if (field.decoder == sg2d.decoder || field.decoder == sg3d.decoder) {
+                bool withDepth = field.decoder == sg3d.decoder;
+                FieldSlots& slots = withDepth ? sg3d : sg2d;
+                std::vector<Position> points (numOfInstances);
+
+                for (size_t i = 0; i < numOfInstances; ++ i) {
+                    points [i].lat = coord (slots.get (subFields, i, COORD_YCOO));
+                    points [i].lon = coord (slots.get (subFields, i, COORD_XCOO));
+                    points [i].depth = withDepth ? depth (slots.get (subFields, i, COORD_VE3D)) : 0.0;
+                }
+
+                if (withDepth) object.flags |= NodeFlags::SOUNDING_ARRAY;
+
+                applyControl (coords, points, coordControl);
+            } else if (!edge) {
+                continue;
+            } else if (field.decoder == attv.decoder) {
+                updateAttributes (attv, numOfInstances, edge->attributes);
+            } else if (field.decoder == vrpc.decoder || field.decoder == vrpt.decoder) {
+                std::vector<VectorPointer> pointers, updates;
+
+                if (edge->beginIndex != LookupTableItem::NOT_EXIST) pointers.push_back ({ edge->beginIndex, TOPI::BeginningNode });
+                if (edge->endIndex != LookupTableItem::NOT_EXIST) pointers.push_back ({ edge->endIndex, TOPI::EndNode });
+
+                if (field.decoder == vrpc.decoder) {
+                    pointerControl = getControl (vrpc);
+                    checkApplyDelete (pointers, pointerControl);
+                } else {
+                    for (size_t i = 0; i < numOfInstances; ++ i) {
+                        size_t nodeIndex = chart.nodes.getIndexByForgeignKey (foreignKey (vrpt.get (subFields, i, PTR_NAME)));
+                        updates.push_back ({ nodeIndex, intValue (vrpt.get (subFields, i, PTR_TOPI)) });
+                    }
+
+                    applyControl (pointers, updates, pointerControl);
+                }
+
+                edge->beginIndex = edge->endIndex = LookupTableItem::NOT_EXIST;
+
+                for (auto& pointer: pointers) {
+                    if (pointer.topology == TOPI::BeginningNode) edge->beginIndex = pointer.index;
+                    if (pointer.topology == TOPI::EndNode) edge->endIndex = pointer.index;
+                }
+            }
+        }
+
+        chart.coords.assign (span, coords.data (), coords.size ());
+    }
+
+    void updateFeature (RecordView& record, uint32_t rcid, uint32_t instruction, uint32_t version) {
+        size_t index;
+
+        if (instruction != RUIN::RuinInsert && !isNextVersion (chart.features, RCNM::Feature, rcid, version)) return;
+
+        switch (instruction) {
+            case RUIN::RuinInsert: {
+                size_t sizeBefore = chart.features.size ();
+
+                processFeatureRecord (record);
+
+                index = appendInserted (chart.features, sizeBefore);
+
+                if (index != LookupTableItem::NOT_EXIST) resolveFeatureKeys (chart.features [index]);
+                break;
+            }
+            case RUIN::RuinDelete: {
+                index = markDeleted (chart.features, RCNM::Feature, rcid);
+
+                if (index != LookupTableItem::NOT_EXIST) {
+                    auto& feature = chart.features [index];
+                    feature.primitive = PRIM::None;
+                    feature.classCode = 0;
+                    feature.nodeIndex = LookupTableItem::NOT_EXIST;
+                    feature.attributes.clear ();
+                    feature.dropAttrIndex ();
+                    feature.edgeRefs.clear ();
+                }
+                break;
+            }
+            case RUIN::RuinModify: {
+                index = chart.features.getIndexByForgeignKey (constructForeignKey (RCNM::Feature, rcid));
+
+                if (index != LookupTableItem::NOT_EXIST) {
+                    auto& feature = chart.features [index];
+                    feature.version = version;
+                    modifyFeature (record, feature);
+                }
+                break;
+            }
+            default:
+                return;
+        }
+
+        if (index != LookupTableItem::NOT_EXIST) changedFeatures.insert (index);
+    }
+
+    void modifyFeature (RecordView& record, FeatureObject& feature) {
+        std::optional<UpdateControl> pointerControl;
+
+        for (auto& field: record.fields) {
+            if (!field.decoder) continue;
+
+            size_t numOfInstances = field.decode (subFields);
+
+            if (numOfInstances == 0) continue;
+
+            if (field.decoder == attf.decoder) {
+                feature.dropAttrIndex ();
+                updateAttributes (attf, numOfInstances, feature.attributes);
+            } else if (field.decoder == fspc.decoder) {
+                pointerControl = getControl (fspc);
+
+                if (feature.primitive == PRIM::Point) {
+                    if (pointerControl->instruction == RUIN::RuinDelete) feature.nodeIndex = LookupTableItem::NOT_EXIST;
+                } else {
+                    checkApplyDelete (feature.edgeRefs, pointerControl);
+                }
+            } else if (field.decoder == fspt.decoder) {
+                if (feature.primitive == PRIM::Point) {
+                    feature.nodeIndex = chart.nodes.getIndexByForgeignKey (foreignKey (fspt.get (subFields, 0, PTR_NAME)));
+                    pointerControl.reset ();
+                } else {
+                    std::vector<EdgeRef> updates;
+
+                    for (size_t i = 0; i < numOfInstances; ++ i) {
+                        size_t edgeIndex = chart.edges.getIndexByForgeignKey (foreignKey (fspt.get (subFields, i, PTR_NAME)));
+
+                        if (edgeIndex == LookupTableItem::NOT_EXIST) continue;
+
+                        auto& edgeRef = updates.emplace_back ();
+                        edgeRef.index = edgeIndex;
+                        edgeRef.hidden = intValue (fspt.get (subFields, i, PTR_MASK)) == 1;
+                        edgeRef.hole = intValue (fspt.get (subFields, i, PTR_USAG)) == USAG::Interior;
+                        edgeRef.unclockwise = intValue (fspt.get (subFields, i, PTR_ORNT)) == ORNT::Reverse;
+                    }
+
+                    applyControl (feature.edgeRefs, updates, pointerControl);
+                }
+            }
+        }
+    }
+
+    // Propagates geometry changes from nodes to edges and further to features, then refreshes derived data
+    void finish (AttrDictionary& attrDictionary) {
+        Edges& edges = chart.edges;
+        Features& features = chart.features;
+
+        if (!changedNodes.empty ()) {
+            for (size_t i = 0; i < edges.size (); ++ i) {
+                if (changedNodes.count (edges [i].beginIndex) || changedNodes.count (edges [i].endIndex)) changedEdges.insert (i);
+            }
+        }
+
+        for (size_t i = 0; i < features.size (); ++ i) {
+            auto& feature = features [i];
+
+            if (feature.isDeleted ()) continue;
+
+            if (feature.nodeIndex != LookupTableItem::NOT_EXIST && changedNodes.count (feature.nodeIndex)) changedFeatures.insert (i);
+
+            for (auto edgeRef = feature.edgeRefs.begin (); edgeRef != feature.edgeRefs.end ();) {
+                if (changedEdges.count (edgeRef->index)) changedFeatures.insert (i);
+
+                if (edgesDeleted && edges [edgeRef->index].isDeleted ()) {
+                    edgeRef = feature.edgeRefs.erase (edgeRef);
+                } else {
+                    ++ edgeRef;
+                }
+            }
+        }
+
+        for (size_t index: changedFeatures) {
+            deformatAttrValues (attrDictionary, features [index].attributes, chart.strings);
+            features [index].buildAttrIndex ();
+        }
+
+        updatePointLocationInfo (chart, changedFeatures);
+        chart.featureTable.clear ();
+        chart.symbolization.clear ();
+    }
+};
+
+// Returns false when the update is missing or out of sequence, so no further updates can be applied. Updates already
+// included into the base cell (UPDN not above the current one) are skipped.
+bool applyChartUpdate (const char *path, Chart& chart, Environment& env) {
+    MappedS57File updateFile;
+    RecordView record;
+
+    if (!updateFile.open (path)) return false;
+
+    ChartUpdater updater (chart, updateFile.program);
+    std::optional<std::string> edition;
+    std::optional<uint32_t> updateNumber;
+    uint32_t currentNumber = chart.params.updateNumber.value_or (0);
+
+    if (!updater.readDatasetId (updateFile, edition, updateNumber)) return false;
+    if (chart.params.edition && edition != chart.params.edition) return false;
+    if (updateNumber.value () <= currentNumber) return true;
+    if (updateNumber.value () != currentNumber + 1) return false;
+
+    for (auto pass: { ChartUpdater::NODES, ChartUpdater::EDGES, ChartUpdater::FEATURES }) {
+        const char *recStart = updateFile.firstRecord;
+
+        while (updateFile.readRecord (recStart, record)) updater.processRecord (record, pass);
+    }
+
+    updater.finish (env.attrDictionary);
+    chart.params.updateNumber = updateNumber;
+
+    return true;
+}
+
+// Moves the objects of a partial chart behind the ones already in the chart. Spans are rebased onto the chart
+// coordinate pool, attribute texts stay where they are as the string chunks are taken over.
+static void appendPartialChart (Chart& chart, Chart& partial) {
+    uint32_t base = (uint32_t) chart.coords.absorb (partial.coords);
+
+    for (auto& node: partial.nodes) {
+        node.points.offset += base;
+        chart.nodes.container.push_back (std::move (node));
+    }
+    for (auto& edge: partial.edges) {
+        edge.internalNodes.offset += base;
+        chart.edges.container.push_back (std::move (edge));
+    }
+    for (auto& feature: partial.features) chart.features.container.push_back (std::move (feature));
+
+    chart.strings.absorb (partial.strings);
+}
+
+// Dataset description records in front are extracted on the calling thread as everything else depends on COMF/SOMF.
+// The rest is split into ranges extracted on the work pool, each into its own partial chart with own coordinate and
+// string pools; the partial charts are appended in file order so the result is the same as from one pass. Only the
+// foreign keys are resolved sequentially at the end. getRecord (index, scratch) returns the record or 0.
+template<typename GetRecord> static void extractRecords (DdrProgram& program, size_t numOfRecords, GetRecord getRecord, Chart& chart) {
+    static const size_t MIN_RECORDS_PER_TASK = 1024;
+    static const size_t TASKS_PER_WORKER = 4;
+
+    ChartExtractor extractor (chart, program);
+    RecordView scratch;
+    size_t first = 0;
+
+    for (; first < numOfRecords; ++ first) {
+        RecordView *record = getRecord (first, scratch);
+
+        if (!record) continue;
+        if (extractor.isObjectRecord (*record)) break;
+
+        extractor.processRecord (*record);
+    }
+
+    size_t numOfWorkers = getNumOfWorkers (0, (numOfRecords - first) / MIN_RECORDS_PER_TASK);
+
+    if (numOfWorkers < 2) {
+        for (size_t i = first; i < numOfRecords; ++ i) {
+            if (RecordView *record = getRecord (i, scratch)) extractor.processRecord (*record);
+        }
+
+        extractor.resolveForeignKeys (); return;
+    }
+
+    size_t numOfTasks = numOfWorkers * TASKS_PER_WORKER;
+    size_t recordsPerTask = max (MIN_RECORDS_PER_TASK, (numOfRecords - first + numOfTasks - 1) / numOfTasks);
+    std::vector<Chart> partials ((numOfRecords - first + recordsPerTask - 1) / recordsPerTask);
+    std::vector<PoolTask> tasks;
+
+    for (size_t i = 0; i < partials.size (); ++ i) {
+        size_t begin = first + i * recordsPerTask;
+        size_t end = min (begin + recordsPerTask, numOfRecords);
+        Chart& partial = partials [i];
+
+        partial.params = chart.params;
+        partial.coords.fixedPoint = chart.coords.fixedPoint;
+        partial.coords.coordMultiplier = chart.coords.coordMultiplier;
+
+        tasks.emplace_back ([&program, &getRecord, &partial, begin, end] () {
+            ChartExtractor partialExtractor (partial, program);
+            RecordView record;
+
+            for (size_t index = begin; index < end; ++ index) {
+                if (RecordView *view = getRecord (index, record)) partialExtractor.processRecord (*view);
+            }
+        });
+    }
+
+    runWorkStealing (tasks, numOfWorkers);
+
+    for (auto& partial: partials) appendPartialChart (chart, partial);
+
+    extractor.resolveForeignKeys ();
+}
+
+void extractChart (MappedS57File& s57File, Chart& chart, std::vector<std::vector<FieldInstance>> *records) {
+    if (!records) {
+        std::vector<const char *> recordStarts;
+        auto readRecord = [&s57File, &recordStarts] (size_t index, RecordView& record) {
+            const char *recStart = recordStarts [index];
+
+            return s57File.readRecord (recStart, record) ? & record : (RecordView *) 0;
+        };
+
+        extractRecords (s57File.program, s57File.scanRecords (recordStarts), readRecord, chart); return;
+    }
+
+    auto extract = [&s57File, &chart] () {
+        ChartExtractor extractor (chart, s57File.program);
+        RecordView record;
+        const char *recStart = s57File.firstRecord;
+
+        while (s57File.readRecord (recStart, record)) extractor.processRecord (record);
+
+        extractor.resolveForeignKeys ();
+    };
+
+    // Raw records for the structure view are converted by the other workers while the chart is being extracted. The
+    // extraction goes last so the worker it is dealt to starts with it.
+    std::vector<const char *> recordStarts;
+    std::vector<PoolTask> tasks;
+
+    addConvertTasks (s57File, recordStarts, *records, tasks);
+    tasks.emplace_back (extract);
+    runWorkStealing (tasks);
+}
+
+size_t decodeRecords (MappedS57File& s57File, std::vector<RecordView>& records) {
+    const char *recStart = s57File.firstRecord;
+
+    records.clear ();
+
+    while (s57File.readRecord (recStart, records.emplace_back ()));
+
+    records.pop_back ();
+
+    return records.size ();
+}
+
+void extractChart (DdrProgram& program, std::vector<RecordView>& records, Chart& chart) {
+    auto getRecord = [&records] (size_t index, RecordView&) { return & records [index]; };
+
+    extractRecords (program, records.size (), getRecord, chart);
+}
+
+bool parseCatalog (const char *catPath, std::vector<CatalogItem>& catalog) {
+    MappedS57File catalogFile;
+
+    catalog.clear ();
+
+    if (!catalogFile.open (catPath)) return false;
+
+    FieldDecoder *catd = catalogFile.program.find ("CATD");
+
+    if (!catd) return false;
+
+    size_t rcidSlot = catd->slot ("RCID");
+    size_t fileSlot = catd->slot ("FILE");
+    size_t volumeSlot = catd->slot ("VOLM");
+    size_t implSlot = catd->slot ("IMPL");
+    size_t southernSlot = catd->slot ("SLAT");
+    size_t northernSlot = catd->slot ("NLAT");
+    size_t westernSlot = catd->slot ("WLON");
+    size_t easternSlot = catd->slot ("ELON");
+    size_t crcSlot = catd->slot ("CRCS");
+
+    RecordView record;
+    std::vector<SubFieldView> subFields;
+    const char *recStart = catalogFile.firstRecord;
+
+    while (catalogFile.readRecord (recStart, record)) {
+        auto& item = catalog.emplace_back ();
+
+        for (auto& field: record.fields) {
+            if (field.decoder != catd || field.decode (subFields) == 0) continue;
+
+            auto getSubField = [&subFields] (size_t slot) {
+                return (slot != FieldDecoder::NO_SLOT && subFields [slot].hasValue) ? & subFields [slot] : (SubFieldView *) 0;
+            };
+
+            if (auto rcid = getSubField (rcidSlot)) item.rcid = rcid->intValue ();
+            if (auto file = getSubField (fileSlot)) item.fileName = file->stringValue ();
+            if (auto volume = getSubField (volumeSlot)) item.volume = volume->stringValue ();
+            if (auto impl = getSubField (implSlot)) item.binary = impl->stringValue ().compare ("BIN") == 0;
+            if (auto southern = getSubField (southernSlot)) item.southern = southern->floatValue ();
+            if (auto northern = getSubField (northernSlot)) item.northern = northern->floatValue ();
+            if (auto western = getSubField (westernSlot)) item.western = western->floatValue ();
+            if (auto eastern = getSubField (easternSlot)) item.eastern = eastern->floatValue ();
+            if (auto crc = getSubField (crcSlot)) item.crc = crc->stringValue ();
+            break;
+        }
+    }
+
+    return true;
+}
+
+std::string formatLat (double lat) {
+    double absLat = fabs (lat);
+    int deg = (int) absLat;
+    double min = (absLat - (double) deg) * 60.0;
+    char buffer [30];
+    sprintf (buffer, "%02d %06.3f%C", deg, min, lat < 0.0 ? 'S' : 'N');
+
+    return std::string (buffer);
+}
+
+std::string formatLon (double lon) {
+    double absLon = fabs (lon);
+    int deg = (int) absLon;
+    double min = (absLon - (double) deg) * 60.0;
+    char buffer [30];
+    sprintf (buffer, "%03d %06.3f%C", deg, min, lon < 0.0 ? 'W' : 'E');
+
+    return std::string (buffer);
+}
+
+void loadAttrDictionary (const char *path, AttrDictionary& dictionary) {
+    dictionary.clear ();
+
+    char *content = 0;
+    size_t size = loadFileAndConvertToAnsi (path, content);
+
+    if (size && content) {
+        std::vector<std::string> lines;
+
+        splitText (content, lines);
+        free (content);
+
+        for (auto& line: lines) {
+            if (line [0] == '#') {
+                // New attr
+                std::vector<std::string> parts;
+
+                splitString (line.substr (1), parts, ',');
+
+                if (parts.size () > 4) {
+                    std::string acronym = parts [0];
+                    uint16_t code = std::atoi (parts [1].c_str ());
+                    char domain = parts [3][0];
+                    std::string name = parts [4];
+
+                    dictionary.checkAddAttr (code, domain, acronym.c_str (), name.c_str ());
+                }
+            } else if (dictionary.items.size () > 0) {
+                if (dictionary.lastItem ().domain == 'E' || dictionary.lastItem ().domain == 'L') {
+                    std::vector<std::string> fields;
+                    splitString (line, fields, ':');
+                    if (fields.size () > 1) {
+                        dictionary.lastItem ().list.emplace (std::atoi (fields [0].c_str ()), fields [1]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void loadObjectDictionary (const char *path, ObjectDictionary& dictionary) {
+    dictionary.clear ();
+
+    char *content = 0;
+    size_t size = loadFileAndConvertToAnsi (path, content);
+
+    if (size && content) {
+        std::vector<std::string> lines;
+
+        splitText (content, lines);
+        free (content);
+
+        for (auto& line: lines) {
+            if (line [0] == '#') {
+                // New object
+                std::vector<std::string> parts;
+
+                splitString (line.substr (1), parts, ',');
+
+                if (parts.size () > 3) {
+                    std::string acronym = parts [0];
+                    uint16_t code = std::atoi (parts [1].c_str ());
+                    std::string name = parts [3];
+
+                    if (parts.size () > 4) {
+                        name += ',';
+                        name += parts [4];
+                    }
+
+                    dictionary.checkAddObject (code, acronym.c_str (), name.c_str ());
+                }
+            }
+        }
+    }
+}
+
+// Module of the .dai file, a range of line views between two "****" lines
+struct DaiModule {
+    const std::string_view *first;
+    const std::string_view *last;
+
+    const std::string_view *begin () const { return first; }
+    const std::string_view *end () const { return last; }
+    size_t size () const { return last - first; }
+    const std::string_view& operator [] (size_t index) const { return first [index]; }
+};
+
+// Splits the text into line views; CR LF, CR and LF all end a line
+size_t splitLines (std::string_view text, std::vector<std::string_view>& lines) {
+    const char *pos = text.data ();
+    const char *end = pos + text.size ();
+
+    lines.clear ();
+
+    while (pos < end) {
+        const char *delim = findEither (pos, end, '\r', '\n');
+
+        lines.emplace_back (pos, delim - pos);
+
+        if (delim == end) break;
+
+        pos = delim + 1;
+
+        if (*delim == '\r' && pos < end && *pos == '\n') ++ pos;
+    }
+
+    return lines.size ();
+}
+
+bool isDaiTag (std::string_view line, const char *tag) {
+    return line.compare (0, 4, tag) == 0;
+}
+
+// Field data follows the 4-char tag and 5-char length
+std::string_view getDaiFieldData (std::string_view line) {
+    return line.size () > 9 ? line.substr (9) : std::string_view ();
+}
+
+char getFirstChar (std::string_view field) {
+    return field.empty () ? '\0' : field [0];
+}
+
+std::string_view extractToUnitTerm (std::string_view& source) {
+    size_t length = findByte (source.data (), source.data () + source.size (), UT) - source.data ();
+    std::string_view result = source.substr (0, length);
+
+    // The terminator is skipped too unless the field runs up to the end of the line
+    source.remove_prefix (length < source.size () ? length + 1 : length); return result;
+}
+
+std::string_view extractFixedSize (std::string_view& source, size_t size) {
+    std::string_view result = source.substr (0, size);
+
+    source.remove_prefix (result.size ()); return result;
+}
+
+int32_t extractFixedInt (std::string_view& source, size_t size) {
+    std::string_view field = extractFixedSize (source, size);
+
+    return parseSignedField (field.data (), field.size ());
+}
+
+double extractFloatToUnitTerm (std::string_view& source) {
+    std::string_view field = extractToUnitTerm (source);
+
+    return parseFloatField (field.data (), field.size ());
+}
+
+void loadLibraryId (const DaiModule& module, LibraryIdentification& libraryId) {
+    std::string_view source = getDaiFieldData (module [1]);
+
+    libraryId.moduleName = extractFixedSize (source, 2);
+    libraryId.rcid = extractFixedInt (source, 5);
+    libraryId.exchangePurpose = extractFixedSize (source, 3);
+    libraryId.productType = extractToUnitTerm (source);
+    libraryId.exchangeSetSerialNo = extractToUnitTerm (source);
+    libraryId.editionNo = extractToUnitTerm (source);
+    libraryId.compilationDate = extractFixedSize (source, 8);
+    libraryId.compilationTime = extractFixedSize (source, 6);
+    libraryId.libraryProfileVersionsDate = extractFixedSize (source, 8);
+    libraryId.libaryAppProfile = extractFixedSize (source, 2);
+    libraryId.objectCatVersionDate = extractFixedSize (source, 8);
+    libraryId.comment = extractToUnitTerm (source);
+}
+/*
+void loadColorTable (std::vector<std::string>& module, ColorTable& colorTable) {
+    return;
+    colorTable.clear ();
+
+    for (auto& line: module) {
+        char *source = (char *) line.c_str ();
+
+        if (memcmp (source, "CCIE", 4) == 0) {
+            source += 9;
+            std::string colorCode = extractFixedSize (source, 5);
+            double x = extractFloatToUnitTerm (source);
+            double y = extractFloatToUnitTerm (source);
+            double z = extractFloatToUnitTerm (source);
+            std::string colorName = extractToUnitTerm (source);
+
+            colorTable.emplace (colorCode, ColorItem (colorName.c_str (), x, y, z));
+        }
+    }
+}
+*/
+void parseLineStyle (const char *instruction, int& penStyle, int& penWidth, size_t& penIndex, Dai& dai) {
+    char *comma1 = strchr ((char *) instruction + 3, ',');
+    char *comma2 = comma1 ? strchr (comma1 + 1, ',') : 0;
+
+    if (comma1 && comma2) {
+        if (memcmp (instruction + 3, "SOLD", 4) == 0) {
+            penStyle = PS_SOLID;
+        } else if (memcmp (instruction + 3, "DASH", 4) == 0) {
+            penStyle = PS_DASH;
+        } else if (memcmp (instruction + 3, "DOTT", 4) == 0) {
+            penStyle = PS_DOT;
+        } else {
+            penStyle = PS_SOLID;
+        }
+
+        penWidth = isdigit (comma1 [1]) ? comma1 [1] - '0' : 1;
+        penIndex = dai.getBasePenIndex (std::string (comma2 + 1, 5).c_str ());
+    } else {
+        penStyle = PS_SOLID;
+        penWidth = 1;
+        penIndex = dai.getBasePenIndex ("CHBLK");
+    }
+}
+
+void processInstructions (Dai& dai, AttrDictionary& attrDic, LookupTableItem& item, std::vector<std::string_view>& instructions) {
+    auto extractInstr = [] (std::string_view instruction) {
+        size_t leftBracketPos = instruction.find ('(', 2);
+        size_t rightBracketPos = leftBracketPos == std::string_view::npos ? std::string_view::npos : instruction.find (')', leftBracketPos + 1);
+        return rightBracketPos == std::string_view::npos ? std::string () : std::string (instruction.substr (leftBracketPos + 1, rightBracketPos - leftBracketPos - 1));
+    };
+
+    for (auto& instruction: instructions) {
+        if (instruction.size () < 2) continue;
+
+        if (instruction [0] == 'L' && instruction [1] == 'S') {
+            std::string lineStyle (instruction);
+
+            item.penIndex = dai.palette.checkPen (lineStyle.data (), dai.colorTable);
+            parseLineStyle (lineStyle.c_str (), item.edgePenStyle, item.edgePenWidth, item.edgePenIndex, dai);
+        } else if (instruction [0] == 'S' && instruction [1] == 'Y') {
+            auto symbolName = extractInstr (instruction);
+
+            if (!symbolName.empty ()) {
+                size_t index = dai.getSymbolIndex (symbolName.c_str ());
+                if (index != LookupTableItem::NOT_EXIST) item.symbols.emplace_back (index, 0.0);
+            }
+        } else if (instruction [0] == 'A' && instruction [1] == 'C') {
+            auto colorName = extractInstr (instruction);
+
+            if (!colorName.empty ()) item.brushIndex = dai.palette.getSolidBrushIndex (colorName.c_str ());
+        } else if (instruction [0] == 'T' && (instruction [1] == 'X' || instruction [1] == 'E')) {
+            auto& textInstruction = item.textInstructions.emplace_back (instruction);
+            auto &desc = item.textDescriptions.emplace_back ();
+            parseTextInstruction (textInstruction.c_str (), dai, attrDic, desc);
+        } else if (instruction [0] == 'C' && instruction [1] == 'S') {
+            auto procName = extractInstr (instruction);
+
+            if (!procName.empty ()) item.procIndex = dai.getProcIndex (procName.c_str ());
+        } else if (instruction [0] == 'A' && instruction [1] == 'P') {
+            auto patternName = extractInstr (instruction);
+
+            if (!patternName.empty ()) item.patternBrushIndex = dai.palette.getPatternBrushIndex (patternName.c_str ());
+        }
     }
 }
 
 void loadLookupTableItem (
-    std::vector<std::string>& module,
+    const DaiModule& module,
     Dai& dai, 
     ObjectDictionary& objectDictionary,
     AttrDictionary& attrDictionary
 ) {
     size_t index = -1;
     LookupTableItem item;
+    std::vector<std::string_view> parts;
 
     for (auto& line: module) {
-        char *source = (char *) line.c_str ();
-
-        if (memcmp (source, "LUPT", 4) == 0) {
-            source += 9;
-            std::string moduleName = extractFixedSize (source, 2);
-            uint32_t rcid = std::atoi (extractFixedSize (source, 5).c_str ());
-            std::string status = extractFixedSize (source, 3);
-            std::string acronym = extractFixedSize (source, 6);
-            ObjectDesc *objectDesc = objectDictionary.findByAcronym (acronym.c_str ());
-            std::string objType = extractFixedSize (source, 1);
-            uint32_t displayPriority = std::atoi (extractFixedSize (source, 5).c_str ());
-            std::string radarPriority = extractFixedSize (source, 1);
-            std::string tableSet = extractToUnitTerm (source);
-
-            memcpy (item.acronym, acronym.c_str (), 6);
+        std::string_view source = getDaiFieldData (line);
+
+        if (isDaiTag (line, "LUPT")) {
+            std::string_view moduleName = extractFixedSize (source, 2);
+            uint32_t rcid = extractFixedInt (source, 5);
+            std::string_view status = extractFixedSize (source, 3);
+            std::string_view acronym = extractFixedSize (source, 6);
+            ObjectDesc *objectDesc = objectDictionary.findByAcronym (std::string (acronym).c_str ());
+            std::string_view objType = extractFixedSize (source, 1);
+            uint32_t displayPriority = extractFixedInt (source, 5);
+            std::string_view radarPriority = extractFixedSize (source, 1);
+            std::string_view tableSet = extractToUnitTerm (source);
+
+            memcpy (item.acronym, acronym.data (), acronym.size ());
             item.displayPriority = displayPriority;
-            item.radarPriority = radarPriority [0];
-            item.objectType = objType [0];
+            item.radarPriority = getFirstChar (radarPriority);
+            item.objectType = getFirstChar (objType);
             item.attrCombination.clear ();
             item.classCode = objectDesc ? objectDesc->code : 0;
             item.comment.clear ();
@@ -1526,48 +2837,45 @@ void loadLookupTableItem (
             } else if (tableSet.compare ("LINES") == 0) {
                 item.tableSet = TableSet::LINES;
             }
-        } else if (memcmp (source, "ATTC", 4) == 0) {
+        } else if (isDaiTag (line, "ATTC")) {
             if (index >= 0) {
-                source += 9;
-
-                std::string acronym;
-                std::string value;
+                std::string_view acronym;
+                std::string_view value;
 
-                if (*source == UT) {
+                if (getFirstChar (source) == UT) {
                     // No-attribute instance (general default rule)
                 } else {
-                    while (*source && *source != UT) {
+                    while (!source.empty () && source [0] != UT) {
                         acronym = extractFixedSize (source, 6);
                         value = extractToUnitTerm (source);
 
                         if (!acronym.empty ()) {
                             auto& instance = item.attrCombination.emplace_back ();
 
-                            AttrDesc *desc = (AttrDesc *) attrDictionary.findByAcronym (acronym.c_str ());
+                            AttrDesc *desc = (AttrDesc *) attrDictionary.findByAcronym (std::string (acronym).c_str ());
 
                             instance.acronym = acronym;
                             instance.strValue = value;
-                            instance.domain = desc->domain;
+                            instance.domain = desc ? desc->domain : 0;
 
-                            if (value [0] == '?') instance.missing = true;
+                            if (getFirstChar (value) == '?') instance.missing = true;
 
                             switch (instance.domain) {
                                 case 'E':
                                 case 'I': {
                                     instance.noValue = false;
-                                    instance.intValue = std::atoi (value.c_str ());
+                                    instance.intValue = parseSignedField (value.data (), value.length ());
                                     break;
                                 }
                                 case 'F': {
                                     instance.noValue = false;
-                                    instance.floatValue = std::atof (value.c_str ());
+                                    instance.floatValue = parseFloatField (value.data (), value.length ());
                                     break;
                                 }
                                 case 'L': {
-                                    std::vector<std::string> parts;
-                                    splitString (value.c_str (), parts, ',');
+                                    splitString (value, parts, ',');
                                     for (auto& part: parts) {
-                                        instance.listValue.insert (instance.listValue.begin (), (uint8_t) std::atoi (part.c_str ()));
+                                        instance.listValue.insert (instance.listValue.begin (), (uint8_t) parseSignedField (part.data (), part.length ()));
                                     }
                                     instance.noValue = instance.listValue.empty ();
                                     break;
@@ -1579,23 +2887,20 @@ void loadLookupTableItem (
                     }
                 }
             }
-        } else if (memcmp (source, "INST", 4) == 0) {
-            source += 9;
+        } else if (isDaiTag (line, "INST")) {
             item.instruction = extractToUnitTerm (source);
             //std::vector<std::string> parts;
             //splitString (item.instruction, parts, ';');
             //processInstructions (dai, item, parts);
-        } else if (memcmp (source, "DISC", 4) == 0) {
-            source += 9;
-            std::string displayCat = extractToUnitTerm (source);
+        } else if (isDaiTag (line, "DISC")) {
+            std::string_view displayCat = extractToUnitTerm (source);
             
             if (displayCat.compare ("STANDARD") == 0) {
                 item.displayCat = DisplayCat::STANDARD;
             } else if (displayCat.compare ("DISPLAY_BASE") == 0) {
                 item.displayCat = DisplayCat::DISPLAY_BASE;
             }
-        } else if (memcmp (source, "LUCM", 4) == 0) {
-            source += 9;
+        } else if (isDaiTag (line, "LUCM")) {
             item.comment = extractToUnitTerm (source);
 
             // Item has been completed; need to add into table set
@@ -1622,11 +2927,11 @@ void loadLookupTableItem (std::vector<std::string>& module, std::map<std::string
         if (memcmp (source, "LUPT", 4) == 0) {
             source += 9;
             std::string moduleName = extractFixedSize (source, 2);
-            uint32_t rcid = std::atoi (extractFixedSize (source, 5).c_str ());
+            uint32_t rcid = extractFixedInt (source, 5);
             std::string status = extractFixedSize (source, 3);
             std::string acronym = extractFixedSize (source, 6);
             std::string objType = extractFixedSize (source, 1);
-            uint32_t displayPriority = std::atoi (extractFixedSize (source, 5).c_str ());
+            uint32_t displayPriority = extractFixedInt (source, 5);
             std::string radarPriority = extractFixedSize (source, 1);
             std::string tableSet = extractToUnitTerm (source);
 
@@ -1697,27 +3002,26 @@ void loadLookupTableItem (std::vector<std::string>& module, std::map<std::string
     }
 }
 */
-void loadPattern (std::vector<std::string>& module, Dai& dai) {
+void loadPattern (const DaiModule& module, Dai& dai) {
     size_t patternIndex = LookupTableItem::NOT_EXIST;
 
     for (auto& line: module) {
-        char *source = (char *) line.c_str ();
-
-        if (memcmp (source, "PATT", 4) == 0) {
-        } else if (memcmp (source, "PATD", 4) == 0) {
-            source += 9;
-            std::string name = extractFixedSize (source, 8);
-            std::string type = extractFixedSize (source, 1);
-            std::string fillType = extractFixedSize (source, 3);
-            std::string spacing = extractFixedSize (source, 3);
-            uint32_t minDistance = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t maxDistance = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t pivotPtCol = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t pivotPtRow = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t bBoxWidth = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t bBoxHeight = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t bBoxCol = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t bBoxRow = std::atol (extractFixedSize (source, 5).c_str ());
+        std::string_view source = getDaiFieldData (line);
+
+        if (isDaiTag (line, "PATT")) {
+        } else if (isDaiTag (line, "PATD")) {
+            std::string name (extractFixedSize (source, 8));
+            std::string_view type = extractFixedSize (source, 1);
+            std::string_view fillType = extractFixedSize (source, 3);
+            std::string_view spacing = extractFixedSize (source, 3);
+            uint32_t minDistance = extractFixedInt (source, 5);
+            uint32_t maxDistance = extractFixedInt (source, 5);
+            uint32_t pivotPtCol = extractFixedInt (source, 5);
+            uint32_t pivotPtRow = extractFixedInt (source, 5);
+            uint32_t bBoxWidth = extractFixedInt (source, 5);
+            uint32_t bBoxHeight = extractFixedInt (source, 5);
+            uint32_t bBoxCol = extractFixedInt (source, 5);
+            uint32_t bBoxRow = extractFixedInt (source, 5);
             
             auto pos = dai.patternIndex.find (name);
 
@@ -1730,7 +3034,7 @@ void loadPattern (std::vector<std::string>& module, Dai& dai) {
             auto& patternDesc = dai.patterns.back ();
 
             patternDesc.name = name;
-            patternDesc.type = type [0];
+            patternDesc.type = getFirstChar (type);
             patternDesc.bBoxCol = bBoxCol;
             patternDesc.bBoxRow = bBoxRow;
             patternDesc.bBoxWidth = bBoxWidth;
@@ -1751,20 +3055,16 @@ void loadPattern (std::vector<std::string>& module, Dai& dai) {
             } else if (fillType.compare ("LIN") == 0) {
                 patternDesc.fillType = FillType::LINEAR;
             }
-        } else if (memcmp (source, "PXPO", 4) == 0) {
-            source += 9;
+        } else if (isDaiTag (line, "PXPO")) {
             dai.patterns.back ().exposition = extractToUnitTerm (source);
-        } else if (memcmp (source, "PCRF", 4) == 0) {
-            source += 9;
-            while (*source) {
-                std::string colorDef = extractFixedSize (source, 6);
-                dai.patterns.back ().drawProc.definePen (colorDef [0], colorDef.substr (1).c_str (), dai.colorTable.index);
+        } else if (isDaiTag (line, "PCRF")) {
+            while (!source.empty ()) {
+                std::string_view colorDef = extractFixedSize (source, 6);
+                dai.patterns.back ().drawProc.definePen (colorDef [0], std::string (colorDef.substr (1)).c_str (), dai.colorTable.index);
             }
-        } else if (memcmp (source, "PBTM", 4) == 0) {
-            source += 9;
+        } else if (isDaiTag (line, "PBTM")) {
             dai.patterns.back ().bitmap = extractToUnitTerm (source);
-        } else if (memcmp (source, "PVCT", 4) == 0) {
-            source += 9;
+        } else if (isDaiTag (line, "PVCT")) {
             auto& svg = dai.patterns.back ().svgs.emplace_back ();
             splitString (extractToUnitTerm (source), svg, ';');
             for (auto& instr: svg) {
@@ -1774,23 +3074,22 @@ void loadPattern (std::vector<std::string>& module, Dai& dai) {
     }
 }
 
-void loadSymbol (std::vector<std::string>& module, Dai& dai) {
+void loadSymbol (const DaiModule& module, Dai& dai) {
     size_t symbolIndex = LookupTableItem::NOT_EXIST;
 
     for (auto& line: module) {
-        char *source = (char *) line.c_str ();
-
-        if (memcmp (source, "SYMB", 4) == 0) {
-        } else if (memcmp (source, "SYMD", 4) == 0) {
-            source += 9;
-            std::string name = extractFixedSize (source, 8);
-            std::string type = extractFixedSize (source, 1);
-            uint32_t pivotPtCol = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t pivotPtRow = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t bBoxWidth = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t bBoxHeight = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t bBoxCol = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t bBoxRow = std::atol (extractFixedSize (source, 5).c_str ());
+        std::string_view source = getDaiFieldData (line);
+
+        if (isDaiTag (line, "SYMB")) {
+        } else if (isDaiTag (line, "SYMD")) {
+            std::string name (extractFixedSize (source, 8));
+            std::string_view type = extractFixedSize (source, 1);
+            uint32_t pivotPtCol = extractFixedInt (source, 5);
+            uint32_t pivotPtRow = extractFixedInt (source, 5);
+            uint32_t bBoxWidth = extractFixedInt (source, 5);
+            uint32_t bBoxHeight = extractFixedInt (source, 5);
+            uint32_t bBoxCol = extractFixedInt (source, 5);
+            uint32_t bBoxRow = extractFixedInt (source, 5);
 
             auto pos = dai.symbolIndex.find (name);
 
@@ -1802,27 +3101,23 @@ void loadSymbol (std::vector<std::string>& module, Dai& dai) {
 
             auto& symbolDesc = dai.symbols.back ();
             symbolDesc.name = name.c_str ();
-            symbolDesc.type = type [0];
+            symbolDesc.type = getFirstChar (type);
             symbolDesc.bBoxCol = bBoxCol;
             symbolDesc.bBoxRow = bBoxRow;
             symbolDesc.bBoxWidth = bBoxWidth;
             symbolDesc.bBoxHeight = bBoxHeight;
             symbolDesc.pivotPtCol = pivotPtCol;
             symbolDesc.pivotPtRow = pivotPtRow;
-        } else if (memcmp (source, "SXPO", 4) == 0) {
-            source += 9;
+        } else if (isDaiTag (line, "SXPO")) {
             dai.symbols.back ().exposition = extractToUnitTerm (source);
-        } else if (memcmp (source, "SCRF", 4) == 0) {
-            source += 9;
-            while (*source) {
-                std::string colorDef = extractFixedSize (source, 6);
-                dai.symbols.back ().drawProc.definePen (colorDef [0], colorDef.substr (1).c_str (), dai.colorTable.index);
+        } else if (isDaiTag (line, "SCRF")) {
+            while (!source.empty ()) {
+                std::string_view colorDef = extractFixedSize (source, 6);
+                dai.symbols.back ().drawProc.definePen (colorDef [0], std::string (colorDef.substr (1)).c_str (), dai.colorTable.index);
             }
-        } else if (memcmp (source, "SBTM", 4) == 0) {
-            source += 9;
+        } else if (isDaiTag (line, "SBTM")) {
             dai.symbols.back ().bitmap = extractToUnitTerm (source);
-        } else if (memcmp (source, "SVCT", 4) == 0) {
-            source += 9;
+        } else if (isDaiTag (line, "SVCT")) {
             auto& svg = dai.symbols.back ().svgs.emplace_back ();
             splitString (extractToUnitTerm (source), svg, ';');
             for (auto& instr: svg) {
@@ -1832,27 +3127,26 @@ void loadSymbol (std::vector<std::string>& module, Dai& dai) {
     }
 }
 
-void loadLine (std::vector<std::string>& module, Dai& dai) {
+void loadLine (const DaiModule& module, Dai& dai) {
     size_t lineIndex = LookupTableItem::NOT_EXIST;
 
     for (auto& line: module) {
-        char *source = (char *) line.c_str ();
-
-        if (memcmp (source, "LNST", 4) == 0) {
-        } else if (memcmp (source, "LIND", 4) == 0) {
-            source += 9;
-            std::string name = extractFixedSize (source, 8);
-            uint32_t pivotPtCol = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t pivotPtRow = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t bBoxWidth = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t bBoxHeight = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t bBoxCol = std::atol (extractFixedSize (source, 5).c_str ());
-            uint32_t bBoxRow = std::atol (extractFixedSize (source, 5).c_str ());
+        std::string_view source = getDaiFieldData (line);
+
+        if (isDaiTag (line, "LNST")) {
+        } else if (isDaiTag (line, "LIND")) {
+            std::string name (extractFixedSize (source, 8));
+            uint32_t pivotPtCol = extractFixedInt (source, 5);
+            uint32_t pivotPtRow = extractFixedInt (source, 5);
+            uint32_t bBoxWidth = extractFixedInt (source, 5);
+            uint32_t bBoxHeight = extractFixedInt (source, 5);
+            uint32_t bBoxCol = extractFixedInt (source, 5);
+            uint32_t bBoxRow = extractFixedInt (source, 5);
             
             auto pos = dai.lineIndex.find (name);
 
             if (pos == dai.lineIndex.end ()) {
-                lineIndex = dai.symbols.size ();
+                lineIndex = dai.lines.size ();
                 dai.lines.emplace_back (LineDesc ());
                 dai.lineIndex.emplace (name, lineIndex);
             }
@@ -1866,17 +3160,14 @@ void loadLine (std::vector<std::string>& module, Dai& dai) {
             lineDesc.bBoxHeight = bBoxHeight;
             lineDesc.pivotPtCol = pivotPtCol;
             lineDesc.pivotPtRow = pivotPtRow;
-        } else if (memcmp (source, "LXPO", 4) == 0) {
-            source += 9;
+        } else if (isDaiTag (line, "LXPO")) {
             dai.lines.back ().exposition = extractToUnitTerm (source);
-        } else if (memcmp (source, "LCRF", 4) == 0) {
-            source += 9;
-            while (*source) {
-                std::string colorDef = extractFixedSize (source, 6);
-                dai.lines.back ().drawProc.definePen (colorDef [0], colorDef.substr (1).c_str (), dai.colorTable.index);
+        } else if (isDaiTag (line, "LCRF")) {
+            while (!source.empty ()) {
+                std::string_view colorDef = extractFixedSize (source, 6);
+                dai.lines.back ().drawProc.definePen (colorDef [0], std::string (colorDef.substr (1)).c_str (), dai.colorTable.index);
             }
-        } else if (memcmp (source, "LVCT", 4) == 0) {
-            source += 9;
+        } else if (isDaiTag (line, "LVCT")) {
             auto& svg = dai.lines.back ().svgs.emplace_back ();
             splitString (extractToUnitTerm (source), svg, ';');
             for (auto& instr: svg) {
@@ -1969,74 +3260,111 @@ void parseInstructionList (const char *source, DrawProcedure& drawProcedure) {
 
 }
 
-void loadDai (const char *path, Environment& environment) {
+// Full parse of the .dai file followed by translation of the lookup table instructions. Lines are views into the mapped
+// file; lookup table, pattern, symbol and line style modules fill separate parts of the Dai so the four groups are
+// loaded in parallel, each in file order so the indexes match a sequential load.
+static void parseDai (const char *path, Environment& environment) {
     Dai& dai = environment.dai;
     ObjectDictionary& objectDictionary = environment.objectDictionary;
     AttrDictionary& attrDictionary = environment.attrDictionary;
-    char *content = 0;
-    size_t size = loadFileAndConvertToAnsi (path, content);
+    MappedFile file (path);
+    std::string ansi;
+    std::string_view text;
 
-    std::vector<std::vector<std::string>> modules;
+    if (!file.isOpen ()) return;
 
-    modules.emplace_back ();
+    if (file.size > 1 && file.data [0] == (char) 0xFF && file.data [1] == (char) 0xFE) {
+        // UTF-16 library, the low byte of each character is taken
+        ansi.reserve (file.size / 2);
 
-    std::vector<std::string> lines;
+        for (size_t i = 2; i + 1 < file.size && (file.data [i] || file.data [i + 1]); i += 2) {
+            ansi += file.data [i];
+        }
 
-    splitText (content, lines);
-    free (content);
+        text = ansi;
+    } else {
+        text = std::string_view (file.data, file.size);
+    }
+
+    std::vector<std::string_view> lines;
+    std::vector<DaiModule> modules;
+
+    splitLines (text, lines);
+
+    const std::string_view *moduleStart = lines.data ();
 
     for (auto& line: lines) {
-        if (memcmp (line.c_str (), "****", 4) == 0) {
-            modules.emplace_back ();
-        } else {
-            modules.back ().emplace_back (line.c_str ());
+        if (isDaiTag (line, "****")) {
+            modules.push_back ({ moduleStart, & line });
+            moduleStart = & line + 1;
         }
     }
 
+    modules.push_back ({ moduleStart, lines.data () + lines.size () });
+
+    std::vector<const DaiModule *> lookupTableModules, patternModules, symbolModules, lineModules;
+
     for (auto& module: modules) {
         if (module.size () > 1) {
-            const char *moduleName = module [1].c_str ();
+            std::string_view moduleName = module [1];
 
-            if (memcmp (moduleName, "LBID", 4) == 0) {
+            if (isDaiTag (moduleName, "LBID")) {
                 loadLibraryId (module, dai.libraryId);
-            } else if (memcmp (moduleName, "COLS", 4) == 0) {
-                if (memcmp (moduleName + 19, "DAY", 3) == 0) {
-                    // It's not clear how to do - use external color table instead
-                    //loadColorTable (module, dai.dayColorTable);
-                } else if (memcmp (moduleName + 19, "DUSK", 4) == 0) {
-                    // It's not clear how to do - use external color table instead
-                    //loadColorTable (module, dai.duskColorTable);
-                } else if (memcmp (moduleName + 19, "NIGHT", 5) == 0) {
-                    // It's not clear how to do - use external color table instead
-                    //loadColorTable (module, dai.nightColorTable);
-                }
-            } else if (memcmp (moduleName, "LUPT", 4) == 0) {
-                //loadLookupTableItem (module, dai.lookupTables);
-                loadLookupTableItem (module, dai, objectDictionary, attrDictionary);
-            } else if (memcmp (moduleName, "PATT", 4) == 0) {
-                loadPattern (module, dai);
-            } else if (memcmp (moduleName, "SYMB", 4) == 0) {
-                loadSymbol (module, dai);
-            } else if (memcmp (moduleName, "LNST", 4) == 0) {
-                loadLine (module, dai);
+            } else if (isDaiTag (moduleName, "COLS")) {
+                // It's not clear how to do - use external color table instead
+            } else if (isDaiTag (moduleName, "LUPT")) {
+                lookupTableModules.push_back (& module);
+            } else if (isDaiTag (moduleName, "PATT")) {
+                patternModules.push_back (& module);
+            } else if (isDaiTag (moduleName, "SYMB")) {
+                symbolModules.push_back (& module);
+            } else if (isDaiTag (moduleName, "LNST")) {
+                lineModules.push_back (& module);
             }
         }
     }
 
+    std::vector<PoolTask> tasks {
+        [&] () {
+            for (auto module: lookupTableModules) loadLookupTableItem (*module, dai, objectDictionary, attrDictionary);
+        },
+        [&] () {
+            for (auto module: patternModules) loadPattern (*module, dai);
+        },
+        [&] () {
+            for (auto module: symbolModules) loadSymbol (*module, dai);
+        },
+        [&] () {
+            for (auto module: lineModules) loadLine (*module, dai);
+        },
+    };
+
+    runWorkStealing (tasks);
+
     // Create bitmaps
     dai.composePatternBrushes ();
 
-    // Translate instructions
+    // Translate instructions; pens are created in this order so it stays sequential
+    std::vector<std::string_view> parts;
+
     for (auto& lookupTable: dai.lookupTables) {
         for (auto& item: lookupTable) {
-            std::vector<std::string> parts;
             splitString (item.instruction, parts, ';');
             processInstructions (dai, attrDictionary, item, parts);
         }
     }
+}
+
+void loadDai (const char *path, Environment& environment) {
+    if (!loadDaiCache (path, environment)) {
+        parseDai (path, environment);
+        saveDaiCache (path, environment);
+    }
+
+    environment.dai.compileLookupTables ();
 
     // Create pattern tools
-    createPatternTools (dai);
+    createPatternTools (environment.dai);
 }
 
 std::string getAttrStringValue (Attr *attr, AttrDictionary& dic) {
@@ -2050,15 +3378,15 @@ std::string getAttrStringValue (Attr *attr, AttrDictionary& dic) {
 
     switch (desc->domain) {
         case 'I': {
-            return std::to_string (attr->intValue);
+            return std::to_string (attr->intValue ());
         }
         case 'E': {
-            return desc->listValue (attr->intValue);
+            return desc->listValue (attr->intValue ());
         }
         case 'L': {
             std::string result;
 
-            for (uint8_t code: attr->listValue) {
+            for (uint8_t code: attr->listValue ()) {
                 if (!result.empty ()) result += ' ';
                 result += desc->listValue (code);
             }
@@ -2066,13 +3394,13 @@ std::string getAttrStringValue (Attr *attr, AttrDictionary& dic) {
             return result;
         }
         case 'A': case 'S': {
-            return attr->strValue;
+            return attr->strValue ();
         }
         case 'F': {
-            if (desc->format.empty ()) return std::to_string (attr->floatValue);
+            if (desc->format.empty ()) return std::to_string (attr->floatValue ());
 
             char buffer [100];
-            sprintf (buffer, desc->format.c_str (), attr->floatValue);
+            sprintf (buffer, desc->format.c_str (), attr->floatValue ());
 
             return std::string (buffer);
         }
@@ -2099,7 +3427,9 @@ int getZoomToCover (double north, double west, double south, double east) {
     return zoom;
 }
 
-std::tuple<bool, int, double, double, double, double> getCoverageRect (Features& features, Nodes& nodes, Edges& edges) {
+std::tuple<bool, int, double, double, double, double> getCoverageRect (Chart& chart) {
+    Features& features = chart.features;
+    Edges& edges = chart.edges;
     int zoom = 0;
     bool hasCoverage = false;
     double west = 1.0e10, east = -1.0e10, north = -1.0e10, south = 1.0e10;
@@ -2114,17 +3444,17 @@ std::tuple<bool, int, double, double, double, double> getCoverageRect (Features&
         if (feature.classCode == OBJ_CLASSES::M_COVR && feature.primitive == 3) {
             auto coverage = feature.getAttr (ATTRS::CATCOV);
 
-            if (coverage && !coverage->noValue && coverage->intValue == 1) {
+            if (coverage && !coverage->noValue && coverage->intValue () == 1) {
                 for (auto& edgeRef: feature.edgeRefs) {
                     auto& edge = edges [edgeRef.index];
-                    auto& begin = nodes [edge.beginIndex].points.front ();
-                    auto& end = nodes [edge.endIndex].points.front ();
+                    auto begin = chart.nodePosition (edge.beginIndex);
+                    auto end = chart.nodePosition (edge.endIndex);
                     checkPoint (begin.lat, begin.lon);
                     checkPoint (end.lat, end.lon);
 
-                    for (auto& pos: edge.internalNodes) {
+                    chart.internalNodes (edge).forEach ([&checkPoint] (const Position& pos) {
                         checkPoint (pos.lat, pos.lon);
-                    }
+                    });
                 }
 
                 hasCoverage = true; break;
@@ -2141,22 +3471,82 @@ std::tuple<bool, int, double, double, double, double> getCoverageRect (Features&
     return std::tuple<bool, int, double, double, double, double> (hasCoverage, zoom, north, west, south, east);
 }
 
+// Derived data of a freshly extracted base cell; the result goes to the chart cache
+void completeChart (const char *path, const char *crc, Chart& chart, Environment& env) {
+    deformatAttrValues (env.attrDictionary, chart);
+    buildPointLocationInfo (chart);
+    saveChartCache (path, crc, chart);
+}
+
+// Sequential updates <cell>.001, <cell>.002... are applied on top of the base cell while they exist
+void applyChartUpdates (const char *path, Chart& chart, Environment& env) {
+    size_t pathLength = strlen (path);
+
+    if (pathLength > 4 && strcmp (path + pathLength - 4, ".000") == 0) {
+        std::string updatePath (path);
+
+        for (int updateNumber = 1; updateNumber < 1000; ++ updateNumber) {
+            snprintf (updatePath.data () + pathLength - 3, 4, "%03d", updateNumber);
+
+            if (!applyChartUpdate (updatePath.c_str (), chart, env)) break;
+        }
+    }
+}
+
+// Cell content against CRCS from the catalog, nothing to check against means valid
+bool isCrcValid (MappedFile& file, const char *crc) {
+    uint32_t expected;
+
+    return !parseCrcs (crc, expected) || calcCrc32 (file.data, file.size) == expected;
+}
+
+// View independent part of openChart (), safe to run for different charts in parallel
+bool loadChart (
+    const char *path,
+    Chart& chart,
+    Environment& env,
+    std::vector<std::vector<FieldInstance>> *records,
+    const char *crc,
+    bool verifyCrc) {
+    chart.nodes.clear ();
+    chart.edges.clear ();
+    chart.features.clear ();
+    chart.featureTable.clear ();
+    chart.symbolization.clear ();
+    chart.areaTopologyMap.clear ();
+    chart.strings.clear ();
+    chart.coords.clear ();
+    chart.coords.preferFixedPoint = env.fixedPointCoords;
+    chart.params = DatasetParams ();
+
+    if (records) records->clear ();
+
+    // Raw records are only available from the cell itself, the same applies to verification
+    if (records || verifyCrc || !loadChartCache (path, crc, chart)) {
+        MappedS57File s57File;
+
+        if (!s57File.open (path) || (verifyCrc && !isCrcValid (s57File.file, crc))) return false;
+
+        extractChart (s57File, chart, records);
+        completeChart (path, crc, chart, env);
+    }
+
+    applyChartUpdates (path, chart, env);
+
+    return true;
+}
+
 void openChart (
     char *path,
     Chart& chart,
     Environment& env,
     View& view,
-    std::vector<std::vector<FieldInstance>>& records,
-    bool extendView = false) {
-    loadParseS57File (path, records);
-    extractDatasetParameters (records, chart.params);
-    extractNodes (records, chart);
-    extractEdges (records, chart);
-    extractFeatureObjects (records, chart);
-    deformatAttrValues (env.attrDictionary, chart);
-    buildPointLocationInfo (chart);
+    std::vector<std::vector<FieldInstance>> *records,
+    bool extendView,
+    const char *crc) {
+    if (!loadChart (path, chart, env, records, crc, false)) return;
 
-    auto [hasCoverage, zoom, north, west, south, east] = getCoverageRect (chart.features, chart.nodes, chart.edges);
+    auto [hasCoverage, zoom, north, west, south, east] = getCoverageRect (chart);
 
     if (hasCoverage) {
         if (extendView) {
@@ -5,7 +5,9 @@
 #include "data.h"
 
 bool parseCatalog (const char *catPath, std::vector<CatalogItem>& catalog);
-bool loadParseS57File (char *path, std::vector<std::vector<FieldInstance>>& records);
+bool loadParseS57File (char *path, std::vector<std::vector<FieldInstance>>& records, size_t numOfThreads = 0);
+size_t parseDataRecord (const char *start, std::map<std::string, DdfDesc>& dataDescriptiveFields, std::vector<FieldInstance>& fieldInstances);
+void convertRecordView (RecordView& record, std::vector<FieldInstance>& fieldInstances, std::vector<SubFieldView>& subFields);
 void extractDatasetParameters (std::vector<std::vector<FieldInstance>>& records, DatasetParams& datasetParams);
 //void extractFeatureObjects (std::vector<std::vector<FieldInstance>>& records, std::vector<FeatureDesc>& objects);
 void extractFeatureObjects (std::vector<std::vector<FieldInstance>>& records, Chart& chart);
@@ -19,12 +21,20 @@ void loadColorTable (const char *path, Dai& dai);
 size_t parseRecord (const char *start);
 std::string formatLat (double lat);
 std::string formatLon (double lon);
-void processInstructions (Dai& dai, AttrDictionary& attrDic, LookupTableItem& item, std::vector<std::string>& instructions);
+void processInstructions (Dai& dai, AttrDictionary& attrDic, LookupTableItem& item, std::vector<std::string_view>& instructions);
 void parseTextInstruction (const char *instr, Dai& dai, AttrDictionary& attrDic, TextDesc& desc);
 std::string getAttrStringValue (Attr *attr, AttrDictionary& dic);
-std::tuple<bool, int, double, double, double, double> getCoverageRect (Features& features, Nodes& nodes, Edges& edges);
+std::tuple<bool, int, double, double, double, double> getCoverageRect (Chart& chart);
 int getZoomToCover (double north, double west, double south, double east);
-void openChart (char *path, Chart& chart, Environment& env, View& view, std::vector<std::vector<FieldInstance>>& records, bool extendView = false);
+void extractChart (MappedS57File& s57File, Chart& chart, std::vector<std::vector<FieldInstance>> *records = 0);
+size_t decodeRecords (MappedS57File& s57File, std::vector<RecordView>& records);
+void extractChart (DdrProgram& program, std::vector<RecordView>& records, Chart& chart);
+void completeChart (const char *path, const char *crc, Chart& chart, Environment& env);
+void applyChartUpdates (const char *path, Chart& chart, Environment& env);
+bool applyChartUpdate (const char *path, Chart& chart, Environment& env);
+bool isCrcValid (MappedFile& file, const char *crc);
+bool loadChart (const char *path, Chart& chart, Environment& env, std::vector<std::vector<FieldInstance>> *records = 0, const char *crc = 0, bool verifyCrc = false);
+void openChart (char *path, Chart& chart, Environment& env, View& view, std::vector<std::vector<FieldInstance>> *records = 0, bool extendView = false, const char *crc = 0);
 
 
 
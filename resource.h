@@ -20,6 +20,10 @@
 #define ID_GYRO_PORT                            208
 #define ID_GPS_BAUD                             209
 #define ID_GYRO_BAUD                            210
+#define ID_FIXED_POINT_COORDS                   211
+#define ID_LOAD_EXCHANGE_SET                    212
+#define ID_VERIFY_EXCHANGE_SET                  213
+#define ID_LOAD_EXCHANGE_SET_PIPELINED          214
 
 #define IDC_CATALOG                             300
 #define IDC_RECORDS                             301
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <map>
@@ -303,6 +304,277 @@ void Dai::composePatternBrushes () {
     }
 }
 
+void Dai::compileLookupTables () {
+    lookupTableDirectory.build (lookupTableIndex);
+    lookupTableMatchers.resize (lookupTables.size ());
+
+    for (size_t i = 0; i < lookupTables.size (); ++ i) {
+        lookupTableMatchers [i].compile (lookupTables [i]);
+    }
+}
+
+void LookupTableDirectory::build (std::map<uint32_t, size_t>& lookupTableIndex) {
+    clear ();
+
+    if (lookupTableIndex.empty ()) return;
+
+    // Keys are ordered by class code which is in the upper half
+    rowIndex.resize ((lookupTableIndex.rbegin ()->first >> 16) + 1, (uint32_t) NO_TABLE);
+
+    for (auto& [key, index]: lookupTableIndex) {
+        uint16_t classCode = (uint16_t) (key >> 16);
+        DisplayCat displayCat = (DisplayCat) ((key >> 12) & 15);
+        TableSet tableSet = (TableSet) ((key >> 8) & 15);
+        char objectType = (char) (key & 255);
+
+        // Tables for anything but points, lines and areas are never looked up
+        if (displayCat >= NUM_OF_DISPLAY_CATS || tableSet >= NUM_OF_TABLE_SETS || getObjectTypeIndex (objectType) == 0) continue;
+
+        if (rowIndex [classCode] == NO_TABLE) {
+            rowIndex [classCode] = (uint32_t) (slots.size () / ROW_SIZE);
+            slots.resize (slots.size () + ROW_SIZE, (uint32_t) NO_TABLE);
+        }
+
+        slots [rowIndex [classCode] * ROW_SIZE + getSlot (displayCat, tableSet, objectType)] = (uint32_t) index;
+    }
+}
+
+void LookupTableMatcher::compile (LookupTable& table) {
+    std::vector<Rule> tableRules;
+
+    conditions.clear ();
+    listValues.clear ();
+    rules.clear ();
+    branches.clear ();
+    memset (branchCodes, 0, sizeof (branchCodes));
+
+    unconditionalItem = table.size ();
+
+    // Items following the first one without conditions are never chosen
+    for (size_t i = 1; i < table.size (); ++ i) {
+        Rule rule { (uint32_t) i, (uint32_t) conditions.size (), 0 };
+
+        for (auto& requiredAttr: table [i].attrCombination) {
+            auto& condition = conditions.emplace_back ();
+
+            condition.classCode = requiredAttr.classCode;
+            condition.intValue = requiredAttr.intValue;
+            condition.floatValue = requiredAttr.floatValue;
+            condition.listOffset = (uint32_t) listValues.size ();
+            condition.listSize = 0;
+
+            if (requiredAttr.noValue) {
+                condition.kind = ConditionKind::NO_VALUE; break;
+            }
+
+            switch (requiredAttr.domain) {
+                case 'E':
+                case 'I':
+                    condition.kind = ConditionKind::INT_VALUE; break;
+                case 'F':
+                    condition.kind = ConditionKind::FLOAT_VALUE; break;
+                case 'L':
+                    condition.kind = ConditionKind::LIST_VALUE;
+                    condition.listSize = (uint32_t) requiredAttr.listValue.size ();
+                    listValues.insert (listValues.end (), requiredAttr.listValue.begin (), requiredAttr.listValue.end ());
+                    break;
+                default:
+                    condition.kind = ConditionKind::PRESENT; break;
+            }
+        }
+
+        rule.numOfConditions = (uint32_t) conditions.size () - rule.firstCondition;
+
+        if (rule.numOfConditions == 0) {
+            unconditionalItem = i; break;
+        }
+
+        tableRules.push_back (rule);
+    }
+
+    auto getBranchKey = [this] (const Rule& rule) {
+        auto& condition = conditions [rule.firstCondition];
+        bool anyValue = condition.kind != ConditionKind::INT_VALUE;
+
+        return std::tuple<uint16_t, bool, uint32_t> (condition.classCode, anyValue, anyValue ? 0 : condition.intValue);
+    };
+
+    // Stable order keeps the rules of a branch in table order
+    std::stable_sort (tableRules.begin (), tableRules.end (), [&getBranchKey] (const Rule& rule1, const Rule& rule2) {
+        return getBranchKey (rule1) < getBranchKey (rule2);
+    });
+
+    for (auto& rule: tableRules) {
+        auto [classCode, anyValue, value] = getBranchKey (rule);
+
+        if (branches.empty () || branches.back ().classCode != classCode || branches.back ().anyValue != anyValue || branches.back ().value != value) {
+            branches.push_back ({ classCode, anyValue, value, (uint32_t) rules.size (), 0 });
+        }
+
+        rules.push_back (rule);
+        ++ branches.back ().numOfRules;
+
+        if (classCode < MAX_MASK_WORDS * 64) branchCodes [classCode >> 6] |= 1ull << (classCode & 63);
+    }
+}
+
+std::unique_ptr<uint16_t []> AttrIndex::build (const std::vector<Attr>& attributes) {
+    if (attributes.empty () || attributes.size () > 0xFFFF) return 0;
+
+    // Code and position of the first occurrence of every code, in code order
+    std::vector<std::pair<uint16_t, uint16_t>> codes;
+
+    codes.reserve (attributes.size ());
+
+    for (size_t i = 0; i < attributes.size (); ++ i) codes.emplace_back (attributes [i].classCode, (uint16_t) i);
+
+    std::stable_sort (codes.begin (), codes.end (), [] (const std::pair<uint16_t, uint16_t>& first, const std::pair<uint16_t, uint16_t>& second) {
+        return first.first < second.first;
+    });
+    codes.erase (std::unique (codes.begin (), codes.end (), [] (const std::pair<uint16_t, uint16_t>& first, const std::pair<uint16_t, uint16_t>& second) {
+        return first.first == second.first;
+    }), codes.end ());
+
+    size_t numOfWords = 0, numOfMasked = 0;
+
+    for (auto& code: codes) {
+        if (code.first >= MAX_MASK_WORDS * 64) break;
+
+        numOfWords = (code.first >> 6) + 1;
+        ++ numOfMasked;
+    }
+
+    size_t numOfHigh = codes.size () - numOfMasked;
+    size_t size = HEADER_SIZE + numOfWords * 5 + codes.size () + numOfHigh;
+    std::unique_ptr<uint16_t []> index (new uint16_t [size]);
+    uint64_t masks [MAX_MASK_WORDS] {};
+    uint16_t *ranks = index.get () + HEADER_SIZE + numOfWords * 4;
+    uint16_t *positions = ranks + numOfWords;
+    uint16_t *highCodes = positions + codes.size ();
+
+    index [NUM_OF_WORDS] = (uint16_t) numOfWords;
+    index [NUM_OF_MASKED] = (uint16_t) numOfMasked;
+    index [NUM_OF_HIGH] = (uint16_t) numOfHigh;
+    index [HEADER_SIZE - 1] = 0;
+
+    for (size_t i = 0; i < codes.size (); ++ i) {
+        positions [i] = codes [i].second;
+
+        if (i < numOfMasked) {
+            masks [codes [i].first >> 6] |= 1ull << (codes [i].first & 63);
+        } else {
+            highCodes [i - numOfMasked] = codes [i].first;
+        }
+    }
+
+    memcpy (index.get () + HEADER_SIZE, masks, numOfWords * sizeof (uint64_t));
+
+    for (size_t i = 0, rank = 0; i < numOfWords; ++ i) {
+        ranks [i] = (uint16_t) rank;
+        rank += countSetBits (masks [i]);
+    }
+
+    return index;
+}
+
+void ForeignKeyIndex::build (std::vector<uint64_t>& keys) {
+    struct KeyRange {
+        uint32_t firstRcid, lastRcid;
+        size_t count;
+    };
+
+    KeyRange ranges [256];
+    int tableIndex [256];
+
+    clear ();
+    memset (ranges, 0, sizeof (ranges));
+
+    for (auto key: keys) {
+        if (key == LookupTableItem::NOT_EXIST) continue;
+
+        auto& range = ranges [(uint8_t) (key >> 32)];
+        uint32_t rcid = (uint32_t) key;
+
+        if (range.count == 0 || rcid < range.firstRcid) range.firstRcid = rcid;
+        if (range.count == 0 || rcid > range.lastRcid) range.lastRcid = rcid;
+
+        ++ range.count;
+    }
+
+    // A slot takes a quarter of a sparse entry so a table pays off while at least a quarter of its range is in use
+    for (size_t recName = 0; recName < 256; ++ recName) {
+        auto& range = ranges [recName];
+        uint64_t rangeSize = (uint64_t) range.lastRcid - range.firstRcid + 1;
+
+        tableIndex [recName] = -1;
+
+        if (range.count == 0 || keys.size () >= EMPTY_SLOT || rangeSize > range.count * 4) continue;
+
+        tableIndex [recName] = (int) directTables.size ();
+
+        auto& table = directTables.emplace_back ();
+
+        table.recName = (uint8_t) recName;
+        table.firstRcid = range.firstRcid;
+        table.slots.assign ((size_t) rangeSize, (uint32_t) EMPTY_SLOT);
+    }
+
+    for (size_t i = 0; i < keys.size (); ++ i) {
+        uint64_t key = keys [i];
+
+        if (key == LookupTableItem::NOT_EXIST) continue;
+
+        int table = tableIndex [(uint8_t) (key >> 32)];
+
+        if (table >= 0) {
+            auto& slot = directTables [table].slots [(uint32_t) key - directTables [table].firstRcid];
+
+            if (slot == EMPTY_SLOT) slot = (uint32_t) i;
+        } else {
+            sparseKeys.emplace_back (key, i);
+        }
+    }
+
+    std::stable_sort (sparseKeys.begin (), sparseKeys.end (), [] (const std::pair<uint64_t, size_t>& first, const std::pair<uint64_t, size_t>& second) {
+        return first.first < second.first;
+    });
+    sparseKeys.erase (std::unique (sparseKeys.begin (), sparseKeys.end (), [] (const std::pair<uint64_t, size_t>& first, const std::pair<uint64_t, size_t>& second) {
+        return first.first == second.first;
+    }), sparseKeys.end ());
+}
+
+void ForeignKeyIndex::set (uint64_t key, size_t index) {
+    uint32_t *slot = getDirectSlot (key);
+
+    if (slot) {
+        *slot = (uint32_t) index; return;
+    }
+
+    auto pos = std::lower_bound (sparseKeys.begin (), sparseKeys.end (), key, [] (const std::pair<uint64_t, size_t>& item, uint64_t key) {
+        return item.first < key;
+    });
+
+    if (pos != sparseKeys.end () && pos->first == key) {
+        pos->second = index;
+    } else {
+        sparseKeys.emplace (pos, key, index);
+    }
+}
+
+void ForeignKeyIndex::erase (uint64_t key) {
+    uint32_t *slot = getDirectSlot (key);
+
+    if (slot) {
+        *slot = EMPTY_SLOT; return;
+    }
+
+    auto pos = std::lower_bound (sparseKeys.begin (), sparseKeys.end (), key, [] (const std::pair<uint64_t, size_t>& item, uint64_t key) {
+        return item.first < key;
+    });
+
+    if (pos != sparseKeys.end () && pos->first == key) sparseKeys.erase (pos);
+}
+
 Attr *FeatureObject::getAttr (const char *acronym, struct AttrDictionary& dic) {
     auto desc = dic.findByAcronym (acronym);
 
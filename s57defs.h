@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <optional>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <tuple>
@@ -9,13 +11,17 @@
 #include <Windows.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <charconv>
 #include "csp.h"
 #include "geo.h"
+#include "mapped_file.h"
+#include "field_values.h"
 
 #pragma pack(1)
 
-size_t splitString (std::string source, std::vector<std::string>& parts, char separator);
-HBRUSH createPatternBrush (struct PatternDesc& pattern, enum PaletteIndex paletteIndex, struct Dai& dai);
+size_t splitString (std::string_view source, std::vector<std::string>& parts, char separator);
+size_t splitString (std::string_view source, std::vector<std::string_view>& parts, char separator);
 
 enum PaletteIndex {
     Day = 1,
@@ -23,6 +29,8 @@ enum PaletteIndex {
     Night,
 };
 
+HBRUSH createPatternBrush (struct PatternDesc& pattern, PaletteIndex paletteIndex, struct Dai& dai);
+
 enum RCNM {
     DatasetGeneralInfo = 10,
     DatasetGeoRef = 20,
@@ -143,6 +151,13 @@ namespace USAG {
     inline char ExteriorTruncatedAnsi = 'C';
 }
 
+// Record update instruction; FSUI, VPUI and CCUI use the same codes
+enum RUIN {
+    RuinInsert = 1,
+    RuinDelete = 2,
+    RuinModify = 3,
+};
+
 enum TOPI {
     ContainingFace = 5,
     BeginningNode = 1,
@@ -168,17 +183,7 @@ enum RIND {
 
 inline char FT = '\x1e';
 inline char UT = '\x1f';
-
-inline uint32_t parseField (char *field, size_t size) {
-    uint32_t result = 0;
-
-    for (size_t i = 0; i < size; ++ i) {
-        result *= 10;
-        result += field [i] - '0';
-    }
-
-    return result;
-}
+inline char DEL = '\x7f';       // ATVL of an update record deleting the attribute
 
 struct EntryMap {
                                 // Meaning or mandatory content
@@ -290,6 +295,141 @@ struct FieldInstance {
     std::vector<std::map<std::string, SubFieldInstance>> instanceValues;
 };
 
+inline uint32_t packTag (const char *tag) {
+    uint32_t result;
+    memcpy (& result, tag, sizeof (result));
+    return result;
+}
+
+// DDR field description compiled once per file into a flat decoding program; subfields are addressed by slot index
+struct SubFieldDecoder {
+    RecordFieldDesc *desc;
+    char format;
+    bool isSigned;
+    uint32_t width;             // 0 means UT-terminated subfield
+    uint32_t offset;            // Offset inside the instance, valid only if the field has fixed instance size
+
+    SubFieldDecoder (RecordFieldDesc *_desc);
+};
+
+struct FieldDecoder {
+    uint32_t tag;
+    DdfDesc *desc;
+    std::vector<SubFieldDecoder> subFields;
+    uint32_t instanceSize;      // Sum of subfield widths if all of them are fixed, 0 otherwise
+
+    static const size_t NO_SLOT = SIZE_MAX;
+
+    FieldDecoder (): tag (0), desc (0), instanceSize (0) {}
+
+    // Repeating group marker '*' is ignored so both "*YCOO" and "YCOO" resolve
+    size_t slot (const char *subFieldTag) {
+        if (*subFieldTag == '*') ++ subFieldTag;
+
+        for (size_t i = 0; i < subFields.size (); ++ i) {
+            const char *tag = subFields [i].desc->tag.c_str ();
+
+            if (*tag == '*') ++ tag;
+            if (strcmp (tag, subFieldTag) == 0) return i;
+        }
+
+        return NO_SLOT;
+    }
+};
+
+struct DdrProgram {
+    std::vector<FieldDecoder> fields;
+
+    void compile (std::map<std::string, DdfDesc>& dataDescriptiveFields);
+
+    FieldDecoder *find (uint32_t tag) {
+        for (auto& field: fields) {
+            if (field.tag == tag) return & field;
+        }
+        return 0;
+    }
+    FieldDecoder *find (const char *tag) {
+        return find (packTag (tag));
+    }
+};
+
+// Zero-copy views into a mapped ISO 8211 file; values are decoded on access
+struct SubFieldView {
+    SubFieldDecoder *decoder;
+    const char *data;
+    uint32_t length;
+    bool hasValue;
+
+    SubFieldView (): decoder (0), data (0), length (0), hasValue (false) {}
+
+    char type () { return decoder->format; }
+    bool is (const char *tag) { return decoder->desc->tag.compare (tag) == 0; }
+
+    uint32_t intValue () {
+        if (decoder->format == 'b') {
+            uint32_t value = 0;
+            size_t width = length < sizeof (value) ? length : sizeof (value);
+
+            memcpy (& value, data, width);
+
+            if (decoder->isSigned && width > 0 && width < sizeof (value) && (data [width - 1] & 0x80)) {
+                value |= 0xFFFFFFFF << (width * 8);
+            }
+
+            return value;
+        }
+
+        return (uint32_t) parseSignedField (data, length);
+    }
+    double floatValue () { return parseFloatField (data, length); }
+    std::string stringValue () { return std::string (data, length); }
+    uint8_t *binaryValue () { return (uint8_t *) data; }
+};
+
+struct FieldView {
+    const char *tag;
+    const char *data;
+    uint32_t length;
+    FieldDecoder *decoder;
+
+    FieldView (): tag (0), data (0), length (0), decoder (0) {}
+
+    bool is (const char *fieldTag) { return memcmp (tag, fieldTag, 4) == 0; }
+    bool is (uint32_t fieldTag) { return decoder && decoder->tag == fieldTag; }
+    size_t numOfSubFields () { return decoder ? decoder->subFields.size () : 0; }
+
+    // Splits the field into subfield views of all its instances (numOfSubFields () views per instance), returns number of instances
+    size_t decode (std::vector<SubFieldView>& subFields);
+};
+
+struct RecordView {
+    const char *start;
+    uint32_t length;
+    std::vector<FieldView> fields;
+
+    RecordView (): start (0), length (0) {}
+};
+
+struct MappedS57File {
+    MappedFile file;
+    std::vector<std::pair<std::string, std::string>> fieldTree;
+    std::map<std::string, DdfDesc> dataDescriptiveFields;
+    DdrProgram program;
+    const char *firstRecord;
+
+    MappedS57File (): firstRecord (0) {}
+
+    bool open (const char *path);
+
+    // Fills the record view at pos and moves pos to the next record, returns false at the end of file or on damaged record
+    bool readRecord (const char *& pos, RecordView& record);
+
+    // Walks record leaders only and collects the record start positions, returns number of records
+    size_t scanRecords (std::vector<const char *>& recordStarts);
+
+    const char *end () { return file.end (); }
+};
+
 struct CatalogItem {
     bool binary;
     uint32_t rcid;
@@ -314,6 +454,8 @@ struct DatasetParams {
     std::optional<HDAT> horDatum;               // HDAT
     std::optional<uint32_t> soundingDatum;      // VERDAT values
     std::optional<uint32_t> verDatum;           // VERDAT values
+    std::optional<std::string> edition;         // DSID EDTN
+    std::optional<uint32_t> updateNumber;       // DSID UPDN, raised by each applied update
 };
 
 struct Position {
@@ -703,7 +845,7 @@ struct LookupTableItem {
 
     static const size_t NOT_EXIST = 0xFFFFFFFFFFFFFFFF;
 
-    LookupTableItem (LookupTableItem &source) {
+    LookupTableItem (const LookupTableItem& source) {
         copyFrom (source);
     }
     LookupTableItem (LookupTableItem *source) {
@@ -751,7 +893,7 @@ struct LookupTableItem {
         return composeKey (classCode, displayCat, tableSet, objectType);
     }
 
-    void copyFrom (LookupTableItem& source) {
+    void copyFrom (const LookupTableItem& source) {
         memcpy (acronym, source.acronym, sizeof (source.acronym));
         attrCombination.insert (attrCombination.begin (), source.attrCombination.begin (), source.attrCombination.end ());
         instruction.insert (instruction.begin (), source.instruction.begin (), source.instruction.end ());
@@ -816,6 +958,115 @@ struct Pens {
 
 typedef std::vector<LookupTableItem> LookupTable;
 
+// Direct index of the lookup tables by class code, display category, table set and object type, built from
+// Dai::lookupTableIndex once the library is loaded. rowIndex is indexed by the class code itself up to the largest
+// one having tables (about 17000 entries with inland ENC classes); only classes having tables get a row of slots,
+// one slot for each combination of the small enums.
+struct LookupTableDirectory {
+    static const uint32_t NO_TABLE = 0xFFFFFFFF;
+    static const size_t NUM_OF_DISPLAY_CATS = 4;
+    static const size_t NUM_OF_TABLE_SETS = 8;
+    static const size_t NUM_OF_OBJECT_TYPES = 4;
+    static const size_t ROW_SIZE = NUM_OF_DISPLAY_CATS * NUM_OF_TABLE_SETS * NUM_OF_OBJECT_TYPES;
+
+    std::vector<uint32_t> rowIndex;     // Row of every class code up to the largest one, NO_TABLE if the class has no tables
+    std::vector<uint32_t> slots;
+
+    static size_t getObjectTypeIndex (char objectType) {
+        switch (objectType) {
+            case 'P': return 1;
+            case 'L': return 2;
+            case 'A': return 3;
+            default: return 0;
+        }
+    }
+    static size_t getSlot (DisplayCat displayCat, TableSet tableSet, char objectType) {
+        return ((((size_t) displayCat & (NUM_OF_DISPLAY_CATS - 1)) * NUM_OF_TABLE_SETS + ((size_t) tableSet & (NUM_OF_TABLE_SETS - 1))) * NUM_OF_OBJECT_TYPES) + getObjectTypeIndex (objectType);
+    }
+
+    void clear () {
+        rowIndex.clear ();
+        slots.clear ();
+    }
+    bool empty () { return rowIndex.empty (); }
+    void build (std::map<uint32_t, size_t>& lookupTableIndex);
+
+    // Index of the table in Dai::lookupTables or LookupTableItem::NOT_EXIST
+    size_t find (uint16_t classCode, DisplayCat displayCat, TableSet tableSet, char objectType) {
+        uint32_t row = classCode < rowIndex.size () ? rowIndex [classCode] : NO_TABLE;
+
+        if (row == NO_TABLE) return LookupTableItem::NOT_EXIST;
+
+        uint32_t table = slots [row * ROW_SIZE + getSlot (displayCat, tableSet, objectType)];
+
+        return table == NO_TABLE ? LookupTableItem::NOT_EXIST : table;
+    }
+};
+
+// Lookup table compiled for attribute matching. Every item but the first one (the default) becomes a rule, a list of
+// conditions checked exactly as FeatureObject::fitsInAttrsRequired does. Rules are grouped into branches by the class
+// code of their first condition and, if it demands an integer value, by that value too, so a feature only tries the
+// rules whose first condition may hold for one of its attributes.
+struct LookupTableMatcher {
+    enum ConditionKind: uint8_t {
+        PRESENT = 0,        // Attribute has to exist, the value is not checked
+        NO_VALUE,           // Decides the rule: attribute has to exist and have no value
+        INT_VALUE,
+        FLOAT_VALUE,
+        LIST_VALUE,
+    };
+
+    struct Condition {
+        uint16_t classCode;
+        ConditionKind kind;
+        uint32_t intValue;
+        double floatValue;
+        uint32_t listOffset, listSize;
+    };
+
+    struct Rule {
+        uint32_t itemIndex;
+        uint32_t firstCondition, numOfConditions;
+    };
+
+    struct Branch {
+        uint16_t classCode;
+        bool anyValue;
+        uint32_t value;
+        uint32_t firstRule, numOfRules;
+    };
+
+    std::vector<Condition> conditions;
+    std::vector<uint8_t> listValues;
+    std::vector<Rule> rules;            // Grouped by branch, table order within a branch
+    std::vector<Branch> branches;       // Sorted by class code
+    size_t unconditionalItem;           // First item with no conditions, table size if there is no such item
+
+    static const size_t MAX_MASK_WORDS = 8;
+    uint64_t branchCodes [MAX_MASK_WORDS];      // Class codes below 512 having a branch
+
+    LookupTableMatcher (): unconditionalItem (0) {
+        memset (branchCodes, 0, sizeof (branchCodes));
+    }
+
+    void compile (LookupTable& table);
+
+    // Most attributes of a feature start no rule, the mask saves searching the branches for them
+    bool mayHaveBranches (uint16_t classCode) {
+        return classCode >= MAX_MASK_WORDS * 64 || (branchCodes [classCode >> 6] & (1ull << (classCode & 63))) != 0;
+    }
+    std::pair<Branch *, Branch *> findBranches (uint16_t classCode) {
+        auto first = std::lower_bound (branches.begin (), branches.end (), classCode, [] (Branch& branch, uint16_t code) {
+            return branch.classCode < code;
+        });
+        auto last = first;
+
+        while (last != branches.end () && last->classCode == classCode) ++ last;
+
+        return std::pair<Branch *, Branch *> (branches.data () + (first - branches.begin ()), branches.data () + (last - branches.begin ()));
+    }
+};
+
 template<typename TYPE>
 struct DrawToolItem {
     TYPE day, dusk, night;
@@ -894,15 +1145,26 @@ struct Dai {
     StringIndex procIndex;
     std::vector<LookupTable> lookupTables;
     std::map<uint32_t, size_t> lookupTableIndex;
+    LookupTableDirectory lookupTableDirectory;              // Built with the matchers after every load
+    std::vector<LookupTableMatcher> lookupTableMatchers;    // Built from lookupTables after every load
     std::vector<PatternDesc> patterns;
     std::vector<SymbolDesc> symbols;
     std::vector<LineDesc> lines;
     std::vector<CSP> procedures;
+    std::vector<bool> zoomDependentProcs;     // Procedures whose output changes with the scale of the view
+
+    // Both lookups go through the directory once it is built; the map is only searched while the library is loading
+    size_t findLookupTableIndex (uint16_t code, DisplayCat displayCat, TableSet tableSet, char objectType) {
+        if (!lookupTableDirectory.empty ()) return lookupTableDirectory.find (code, displayCat, tableSet, objectType);
 
-    LookupTable *findLookupTable (uint16_t code, DisplayCat displayCat, TableSet tableSet, char objectType) {
         auto pos = lookupTableIndex.find (LookupTableItem::composeKey (code, displayCat, tableSet, objectType));
 
-        return pos == lookupTableIndex.end () ? 0 : & lookupTables [pos->second];
+        return pos == lookupTableIndex.end () ? LookupTableItem::NOT_EXIST : pos->second;
+    }
+    LookupTable *findLookupTable (uint16_t code, DisplayCat displayCat, TableSet tableSet, char objectType) {
+        size_t index = findLookupTableIndex (code, displayCat, tableSet, objectType);
+
+        return index == LookupTableItem::NOT_EXIST ? 0 : & lookupTables [index];
     }
     size_t getItemIndex  (const char *name, StringIndex& index) {
         auto pos = index.find (name);
@@ -927,9 +1189,14 @@ struct Dai {
         return getItemIndex (name, patternIndex);
     }
     void composePatternBrushes ();
-    void addCSP (const char *name, CSP proc) {
+    void compileLookupTables ();
+    void addCSP (const char *name, CSP proc, bool zoomDependent = false) {
         procIndex.emplace (name, procedures.size ());
         procedures.emplace_back (proc);
+        zoomDependentProcs.push_back (zoomDependent);
+    }
+    bool isZoomDependentProc (size_t index) {
+        return index < zoomDependentProcs.size () && zoomDependentProcs [index];
     }
 };
 
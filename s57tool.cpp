@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include <thread>
+#include <chrono>
 #include <map>
 #include "resource.h"
 #include "parser.h"
@@ -13,6 +14,7 @@
 #include "common_defs.h"
 #include "ui.h"
 #include "nmea_settings.h"
+#include "exchange_set.h"
 
 const int COL_FILENAME = 0;
 const int COL_VOLUME = 1;
@@ -72,6 +74,7 @@ struct Ctx {
     std::string basePath;
     std::string splashText;
     Chart chart;
+    ChartCollection exchangeSet;
     Environment environment;
     NmeaSettings nmeaSettings;
 
@@ -92,7 +95,7 @@ struct Ctx {
     }
 };
 
-void openFile (Ctx *ctx, char *path);
+void openFile (Ctx *ctx, char *path, const char *crc = 0);
 void openFile (Ctx *ctx, CatalogItem *item);
 
 bool queryExit (HWND wnd) {
@@ -324,6 +327,110 @@ void loadCatalog (Ctx *ctx) {
     }
 }
 
+bool selectCatalog (Ctx *ctx, char *path, size_t size, const char *title) {
+    OPENFILENAME ofn;
+
+    static char *CAT_FILTER = "S57 Catalogs (catalog.*)\0catalog.*\0All files\0*.*\0\0";
+
+    memset (path, 0, size);
+    memset (& ofn, 0, sizeof (ofn));
+
+    ofn.Flags = OFN_FILEMUSTEXIST | OFN_HIDEREADONLY;
+    ofn.hInstance = ctx->instance;
+    ofn.lpstrFile = path;
+    ofn.lpstrTitle = title;
+    ofn.lStructSize = sizeof (ofn);
+    ofn.nMaxFile = size;
+    ofn.hwndOwner = ctx->mainWnd;
+    ofn.lpstrFilter = CAT_FILTER;
+
+    return GetOpenFileName (& ofn) != 0;
+}
+
+std::string formatMs (double milliseconds) {
+    char buffer [32];
+
+    snprintf (buffer, sizeof (buffer), "%.1f ms", milliseconds);
+
+    return buffer;
+}
+
+std::string formatStageStats (const char *name, PipelineStageStats& stage) {
+    char buffer [256];
+
+    snprintf (
+        buffer,
+        sizeof (buffer),
+        "\n%s: %zu cells, busy %.1f ms, starved %.1f ms, blocked %.1f ms, queue avg %.1f max %zu",
+        name,
+        stage.numOfItems,
+        stage.busyMs,
+        stage.starvedMs,
+        stage.blockedMs,
+        stage.avgQueueLength,
+        stage.maxQueueLength
+    );
+
+    return buffer;
+}
+
+// Loads all base cells of the exchange set in parallel or through the stage pipeline, the charts are kept until
+// the next exchange set is loaded
+void openExchangeSet (Ctx *ctx, bool pipelined) {
+    char path [MAX_PATH];
+    std::vector<CellLoadReport> reports;
+    PipelineStats stats;
+
+    if (!ctx->loaded || !selectCatalog (ctx, path, sizeof (path), "Load Exchange Set")) return;
+
+    HCURSOR cursor = SetCursor (LoadCursor (0, IDC_WAIT));
+    auto startedAt = std::chrono::steady_clock::now ();
+
+    ctx->exchangeSet.clear ();
+
+    size_t numOfLoaded = pipelined ?
+        loadExchangeSetPipelined (path, ctx->exchangeSet, ctx->environment, reports, stats) :
+        loadExchangeSet (path, ctx->exchangeSet, ctx->environment, reports);
+    double totalMs = std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - startedAt).count ();
+    const CellLoadReport *slowest = 0;
+    std::string summary = "Loaded " + std::to_string (numOfLoaded) + " of " + std::to_string (reports.size ()) + " cells in " + formatMs (totalMs);
+
+    SetCursor (cursor);
+
+    for (auto& report: reports) {
+        if (!slowest || report.milliseconds > slowest->milliseconds) slowest = & report;
+    }
+
+    if (slowest) summary += "\nSlowest cell: " + slowest->fileName + " (" + formatMs (slowest->milliseconds) + ")";
+
+    if (pipelined) summary += formatStageStats ("I/O", stats.io) + formatStageStats ("Decode", stats.decode) + formatStageStats ("Extract", stats.extract) + formatStageStats ("Update", stats.update);
+
+    for (auto& report: reports) {
+        if (!report.loaded) summary += "\n" + report.fileName + ": " + report.error;
+    }
+
+    MessageBox (ctx->mainWnd, summary.c_str (), "Exchange set", numOfLoaded == reports.size () ? MB_ICONINFORMATION : MB_ICONEXCLAMATION);
+}
+
+void checkExchangeSet (Ctx *ctx) {
+    char path [MAX_PATH];
+    std::vector<CellCheckReport> reports;
+
+    if (!selectCatalog (ctx, path, sizeof (path), "Verify Exchange Set")) return;
+
+    HCURSOR cursor = SetCursor (LoadCursor (0, IDC_WAIT));
+    size_t numOfValid = verifyExchangeSet (path, reports);
+    std::string summary = std::to_string (numOfValid) + " of " + std::to_string (reports.size ()) + " files match their CRC";
+
+    SetCursor (cursor);
+
+    for (auto& report: reports) {
+        if (!report.valid) summary += "\n" + report.fileName + ": " + report.error;
+    }
+
+    MessageBox (ctx->mainWnd, summary.c_str (), "Exchange set", numOfValid == reports.size () ? MB_ICONINFORMATION : MB_ICONEXCLAMATION);
+}
+
 const char *coordUnitName (COUN unit) {
     switch (unit) {
         case COUN::EastingNorthing: return "Easting/Northing";
@@ -399,12 +506,13 @@ void showChartStructure (Ctx *ctx, DatasetParams& datasetParams, std::vector<std
 
         LVITEM item;
         auto& node = nodes [index];
+        auto points = ctx->chart.points (node);
 
         std::string id { std::to_string (node.id) };
-        std::string lat { formatLat (node.points.front ().lat) };
-        std::string lon { formatLon (node.points.front ().lon) };
+        std::string lat { formatLat (points.front ().lat) };
+        std::string lon { formatLon (points.front ().lon) };
         std::string type { getNodeType (node.flags) };
-        std::string depth { (node.flags & NodeFlags::SOUNDING_ARRAY) ? std::to_string (node.points.front ().depth) : "" };
+        std::string depth { (node.flags & NodeFlags::SOUNDING_ARRAY) ? std::to_string (points.front ().depth) : "" };
 
         int itemIndex = addListItem (ctx->nodeList, id.data (), item);
         setListItemText (ctx->nodeList, itemIndex, COL_NODE_TYPE, type.data (), item);
@@ -412,10 +520,10 @@ void showChartStructure (Ctx *ctx, DatasetParams& datasetParams, std::vector<std
         setListItemText (ctx->nodeList, itemIndex, COL_NODE_LON, lon.data (), item);
         setListItemText (ctx->nodeList, itemIndex, COL_NODE_DEPTH, depth.data (), item);
 
-        for (size_t i = 1; i < node.points.size (); ++ i) {
-            std::string lat { formatLat (node.points [i].lat) };
-            std::string lon { formatLon (node.points [i].lon) };
-            std::string depth { (node.flags & NodeFlags::SOUNDING_ARRAY) ? std::to_string (node.points [i].depth) : "" };
+        for (size_t i = 1; i < points.size (); ++ i) {
+            std::string lat { formatLat (points [i].lat) };
+            std::string lon { formatLon (points [i].lon) };
+            std::string depth { (node.flags & NodeFlags::SOUNDING_ARRAY) ? std::to_string (points [i].depth) : "" };
 
             itemIndex = addListItem (ctx->nodeList, "", item);
             setListItemText (ctx->nodeList, itemIndex, COL_NODE_TYPE, "", item);
@@ -562,26 +670,26 @@ void showChartStructure (Ctx *ctx, DatasetParams& datasetParams, std::vector<std
             } else {
                 switch (attrDesc->domain) {
                     case 'E': {
-                        attrValue += attrDesc->listValue (attr.intValue); break;
+                        attrValue += attrDesc->listValue (attr.intValue ()); break;
                     }
                     case 'I': {
-                        attrValue += std::to_string (attr.intValue); break;
+                        attrValue += std::to_string (attr.intValue ()); break;
                     }
                     case 'F': {
-                        attrValue += std::to_string (attr.floatValue); break;
+                        attrValue += std::to_string (attr.floatValue ()); break;
                     }
                     case 'L': {
-                        for (uint8_t value: attr.listValue) {
+                        for (uint8_t value: attr.listValue ()) {
                             attrValue += attrDesc->listValue (value);
                             attrValue += ";";
                         }
                         break;
                     }
                     case 'A': {
-                        attrValue += attr.strValue; break;
+                        attrValue += attr.strValue (); break;
                     }
                     case 'S': {
-                        attrValue += attr.strValue; break;
+                        attrValue += attr.strValue (); break;
                     }
                     default: {
                         attrType += "Unknown";
@@ -594,7 +702,7 @@ void showChartStructure (Ctx *ctx, DatasetParams& datasetParams, std::vector<std
             SendMessage (ctx->featureTree, TVM_INSERTITEM, 0, (LPARAM) & data);
         }
 
-        auto addPointItem = [&data, &ctx, &objectItem] (Position& pos, char *label, HTREEITEM parentItem) {
+        auto addPointItem = [&data, &ctx, &objectItem] (const Position& pos, char *label, HTREEITEM parentItem) {
             data.hParent = parentItem;
             data.item.pszText = label;
             
@@ -610,7 +718,7 @@ void showChartStructure (Ctx *ctx, DatasetParams& datasetParams, std::vector<std
             SendMessage (ctx->featureTree, TVM_INSERTITEM, 0, (LPARAM) & data);
         };
         if (feature.primitive == PRIM::Point) {
-            auto& pointsArray = ctx->chart.nodes [feature.nodeIndex].points;
+            auto pointsArray = ctx->chart.points (ctx->chart.nodes [feature.nodeIndex]);
             if (pointsArray.size () == 1) {
                 addPointItem (pointsArray.front (), "Position", objectItem);
             } else if (pointsArray.size () > 1) {
@@ -649,11 +757,12 @@ void showChartStructure (Ctx *ctx, DatasetParams& datasetParams, std::vector<std
                     (HTREEITEM) SendMessage (ctx->featureTree, TVM_INSERTITEM, 0, (LPARAM) & data);
                 }
                 auto& edge = ctx->chart.edges [feature.edgeRefs [i].index];
-                addPointItem (ctx->chart.nodes [edge.beginIndex].points [0], "Begin", edgeItem);
-                for (size_t j = 0; j < edge.internalNodes.size (); ++ j) {
-                    addPointItem (edge.internalNodes [j], std::to_string (j).data (), edgeItem);
+                auto internalNodes = ctx->chart.internalNodes (edge);
+                addPointItem (ctx->chart.nodePosition (edge.beginIndex), "Begin", edgeItem);
+                for (size_t j = 0; j < internalNodes.size (); ++ j) {
+                    addPointItem (internalNodes [j], std::to_string (j).data (), edgeItem);
                 }
-                addPointItem (ctx->chart.nodes [edge.endIndex].points [0], "End", edgeItem);
+                addPointItem (ctx->chart.nodePosition (edge.endIndex), "End", edgeItem);
             }
         }
     }
@@ -679,8 +788,9 @@ void showChartStructure (Ctx *ctx, DatasetParams& datasetParams, std::vector<std
 
             HTREEITEM nodeItem = (HTREEITEM) SendMessage (ctx->edgeTree, TVM_INSERTITEM, 0, (LPARAM) & data);
 
-            std::string lat = "Lat " + formatLat (node.points [0].lat);
-            std::string lon = "Lon " + formatLon (node.points [0].lon);
+            auto pos = ctx->chart.points (node) [0];
+            std::string lat = "Lat " + formatLat (pos.lat);
+            std::string lon = "Lon " + formatLon (pos.lon);
 
             data.hParent = nodeItem;
             data.item.pszText = lat.data ();
@@ -703,7 +813,7 @@ void showChartStructure (Ctx *ctx, DatasetParams& datasetParams, std::vector<std
 
             HTREEITEM internalNodesItem = (HTREEITEM) SendMessage (ctx->edgeTree, TVM_INSERTITEM, 0, (LPARAM) & data);
 
-            for (auto& node: edge.internalNodes) {
+            for (auto node: ctx->chart.coords.copy (edge.internalNodes)) {
                 label = std::to_string (count++);
                 
                 data.hParent = internalNodesItem;
@@ -823,17 +933,17 @@ int iii=0;
     }
 }
 
-void openFile (Ctx *ctx, char *path) {
+void openFile (Ctx *ctx, char *path, const char *crc) {
     std::vector<std::vector<FieldInstance>> records;
 
-    openChart (path, ctx->chart, ctx->environment, ctx->view, records);
+    openChart (path, ctx->chart, ctx->environment, ctx->view, ctx->onlyPaintCharts ? 0 : & records, false, crc);
 
     InvalidateRect (ctx->chartWnd, 0, TRUE);
 
     if (!ctx->onlyPaintCharts) showChartStructure (ctx, ctx->chart.params, records);
 }
 #else
-void openFile (Ctx *ctx, char *path) {
+void openFile (Ctx *ctx, char *path, const char *crc) {
     std::vector<std::vector<FieldInstance>> records;
     //std::vector<FeatureDesc> objects;
     DatasetParams datasetParams;
@@ -846,8 +956,10 @@ void openFile (Ctx *ctx, char *path) {
     extractFeatureObjects (records, ctx->chart);
     deformatAttrValues (ctx->environment.attrDictionary, ctx->chart);
     buildPointLocationInfo (ctx->chart);
+    ctx->chart.featureTable.clear ();
+    ctx->chart.symbolization.clear ();
 
-    auto [hasCoverage, zoom, north, west, south, east] = getCoverageRect (ctx->chart.features, ctx->chart.nodes, ctx->chart.edges);
+    auto [hasCoverage, zoom, north, west, south, east] = getCoverageRect (ctx->chart);
 
     if (hasCoverage) {
         ctx->view.north = north;
@@ -898,12 +1010,13 @@ void openFile (Ctx *ctx, char *path) {
 
         LVITEM item;
         auto& node = nodes [index];
+        auto points = ctx->chart.points (node);
 
         std::string id { std::to_string (node.id) };
-        std::string lat { formatLat (node.points.front ().lat) };
-        std::string lon { formatLon (node.points.front ().lon) };
+        std::string lat { formatLat (points.front ().lat) };
+        std::string lon { formatLon (points.front ().lon) };
         std::string type { getNodeType (node.flags) };
-        std::string depth { (node.flags & NodeFlags::SOUNDING_ARRAY) ? std::to_string (node.points.front ().depth) : "" };
+        std::string depth { (node.flags & NodeFlags::SOUNDING_ARRAY) ? std::to_string (points.front ().depth) : "" };
 
         int itemIndex = addListItem (ctx->nodeList, id.data (), item);
         setListItemText (ctx->nodeList, itemIndex, COL_NODE_TYPE, type.data (), item);
@@ -911,10 +1024,10 @@ void openFile (Ctx *ctx, char *path) {
         setListItemText (ctx->nodeList, itemIndex, COL_NODE_LON, lon.data (), item);
         setListItemText (ctx->nodeList, itemIndex, COL_NODE_DEPTH, depth.data (), item);
 
-        for (size_t i = 1; i < node.points.size (); ++ i) {
-            std::string lat { formatLat (node.points [i].lat) };
-            std::string lon { formatLon (node.points [i].lon) };
-            std::string depth { (node.flags & NodeFlags::SOUNDING_ARRAY) ? std::to_string (node.points [i].depth) : "" };
+        for (size_t i = 1; i < points.size (); ++ i) {
+            std::string lat { formatLat (points [i].lat) };
+            std::string lon { formatLon (points [i].lon) };
+            std::string depth { (node.flags & NodeFlags::SOUNDING_ARRAY) ? std::to_string (points [i].depth) : "" };
 
             itemIndex = addListItem (ctx->nodeList, "", item);
             setListItemText (ctx->nodeList, itemIndex, COL_NODE_TYPE, "", item);
@@ -1061,26 +1174,26 @@ void openFile (Ctx *ctx, char *path) {
             } else {
                 switch (attrDesc->domain) {
                     case 'E': {
-                        attrValue += attrDesc->listValue (attr.intValue); break;
+                        attrValue += attrDesc->listValue (attr.intValue ()); break;
                     }
                     case 'I': {
-                        attrValue += std::to_string (attr.intValue); break;
+                        attrValue += std::to_string (attr.intValue ()); break;
                     }
                     case 'F': {
-                        attrValue += std::to_string (attr.floatValue); break;
+                        attrValue += std::to_string (attr.floatValue ()); break;
                     }
                     case 'L': {
-                        for (uint8_t value: attr.listValue) {
+                        for (uint8_t value: attr.listValue ()) {
                             attrValue += attrDesc->listValue (value);
                             attrValue += ";";
                         }
                         break;
                     }
                     case 'A': {
-                        attrValue += attr.strValue; break;
+                        attrValue += attr.strValue (); break;
                     }
                     case 'S': {
-                        attrValue += attr.strValue; break;
+                        attrValue += attr.strValue (); break;
                     }
                     default: {
                         attrType += "Unknown";
@@ -1093,7 +1206,7 @@ void openFile (Ctx *ctx, char *path) {
             SendMessage (ctx->featureTree, TVM_INSERTITEM, 0, (LPARAM) & data);
         }
 
-        auto addPointItem = [&data, &ctx, &objectItem] (Position& pos, char *label, HTREEITEM parentItem) {
+        auto addPointItem = [&data, &ctx, &objectItem] (const Position& pos, char *label, HTREEITEM parentItem) {
             data.hParent = parentItem;
             data.item.pszText = label;
             
@@ -1109,7 +1222,7 @@ void openFile (Ctx *ctx, char *path) {
             SendMessage (ctx->featureTree, TVM_INSERTITEM, 0, (LPARAM) & data);
         };
         if (feature.primitive == PRIM::Point) {
-            auto& pointsArray = ctx->chart.nodes [feature.nodeIndex].points;
+            auto pointsArray = ctx->chart.points (ctx->chart.nodes [feature.nodeIndex]);
             if (pointsArray.size () == 1) {
                 addPointItem (pointsArray.front (), "Position", objectItem);
             } else if (pointsArray.size () > 1) {
@@ -1148,11 +1261,12 @@ void openFile (Ctx *ctx, char *path) {
                     (HTREEITEM) SendMessage (ctx->featureTree, TVM_INSERTITEM, 0, (LPARAM) & data);
                 }
                 auto& edge = ctx->chart.edges [feature.edgeRefs [i].index];
-                addPointItem (ctx->chart.nodes [edge.beginIndex].points [0], "Begin", edgeItem);
-                for (size_t j = 0; j < edge.internalNodes.size (); ++ j) {
-                    addPointItem (edge.internalNodes [j], std::to_string (j).data (), edgeItem);
+                auto internalNodes = ctx->chart.internalNodes (edge);
+                addPointItem (ctx->chart.nodePosition (edge.beginIndex), "Begin", edgeItem);
+                for (size_t j = 0; j < internalNodes.size (); ++ j) {
+                    addPointItem (internalNodes [j], std::to_string (j).data (), edgeItem);
                 }
-                addPointItem (ctx->chart.nodes [edge.endIndex].points [0], "End", edgeItem);
+                addPointItem (ctx->chart.nodePosition (edge.endIndex), "End", edgeItem);
             }
         }
     }
@@ -1178,8 +1292,9 @@ void openFile (Ctx *ctx, char *path) {
 
             HTREEITEM nodeItem = (HTREEITEM) SendMessage (ctx->edgeTree, TVM_INSERTITEM, 0, (LPARAM) & data);
 
-            std::string lat = "Lat " + formatLat (node.points [0].lat);
-            std::string lon = "Lon " + formatLon (node.points [0].lon);
+            auto pos = ctx->chart.points (node) [0];
+            std::string lat = "Lat " + formatLat (pos.lat);
+            std::string lon = "Lon " + formatLon (pos.lon);
 
             data.hParent = nodeItem;
             data.item.pszText = lat.data ();
@@ -1202,7 +1317,7 @@ void openFile (Ctx *ctx, char *path) {
 
             HTREEITEM internalNodesItem = (HTREEITEM) SendMessage (ctx->edgeTree, TVM_INSERTITEM, 0, (LPARAM) & data);
 
-            for (auto& node: edge.internalNodes) {
+            for (auto node: ctx->chart.coords.copy (edge.internalNodes)) {
                 label = std::to_string (count++);
                 
                 data.hParent = internalNodesItem;
@@ -1327,7 +1442,7 @@ int iii=0;
 void openFile (Ctx *ctx, CatalogItem *item) {
     char path [MAX_PATH];
     PathCombine (path, ctx->basePath.c_str (), item->fileName.c_str ());
-    openFile (ctx, path);
+    openFile (ctx, path, item->crc.has_value () ? item->crc.value ().c_str () : 0);
 }
 
 void openFileByIndex (Ctx *ctx, int itemIndex) {
@@ -1351,14 +1466,31 @@ void toggleChartLoadMode (HWND wnd) {
     CheckMenuItem (GetSubMenu (GetMenu (wnd), 1), ID_ONLY_PAINT_CHART, MF_BYCOMMAND | (ctx->onlyPaintCharts ? MF_CHECKED : MF_UNCHECKED));
 }
 
+// Applies to charts opened afterwards, the current one keeps its coordinate pool
+void toggleFixedPointCoords (HWND wnd) {
+    Ctx *ctx = (Ctx *) GetWindowLongPtr (wnd, GWLP_USERDATA);
+
+    ctx->environment.fixedPointCoords = !ctx->environment.fixedPointCoords;
+
+    CheckMenuItem (GetSubMenu (GetMenu (wnd), 1), ID_FIXED_POINT_COORDS, MF_BYCOMMAND | (ctx->environment.fixedPointCoords ? MF_CHECKED : MF_UNCHECKED));
+}
+
 void doCommand (HWND wnd, uint16_t command, uint16_t notification) {
     Ctx *ctx = (Ctx *) GetWindowLongPtr (wnd, GWLP_USERDATA);
 
     switch (command) {
         case ID_ONLY_PAINT_CHART:
             toggleChartLoadMode (wnd); break;
+        case ID_FIXED_POINT_COORDS:
+            toggleFixedPointCoords (wnd); break;
         case ID_OPEN_CATALOG:
             loadCatalog (ctx); break;
+        case ID_LOAD_EXCHANGE_SET:
+            openExchangeSet (ctx, false); break;
+        case ID_LOAD_EXCHANGE_SET_PIPELINED:
+            openExchangeSet (ctx, true); break;
+        case ID_VERIFY_EXCHANGE_SET:
+            checkExchangeSet (ctx); break;
         case ID_EXIT:
             if (queryExit (wnd)) DestroyWindow (wnd);
             break;
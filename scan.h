@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <stddef.h>
+
+#if defined (__AVX2__)
+    #include <immintrin.h>
+    #define SCAN_AVX2
+    #define SCAN_SSE2
+#elif defined (_M_X64) || defined (__SSE2__) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SCAN_SSE2
+#endif
+
+#if defined (_MSC_VER)
+    #include <intrin.h>
+#endif
+
+// Delimiter scanning used by ISO 8211 and DAI parsers
+
+inline unsigned firstSetBit (uint32_t mask) {
+    #if defined (_MSC_VER)
+        unsigned long index;
+        _BitScanForward (& index, mask);
+        return (unsigned) index;
+    #else
+        return (unsigned) __builtin_ctz (mask);
+    #endif
+}
+
+inline unsigned countSetBits (uint64_t mask) {
+    #if defined (_MSC_VER) && defined (_M_X64) && defined (__AVX2__)
+        return (unsigned) __popcnt64 (mask);
+    #elif defined (_MSC_VER)
+        mask = mask - ((mask >> 1) & 0x5555555555555555ull);
+        mask = (mask & 0x3333333333333333ull) + ((mask >> 2) & 0x3333333333333333ull);
+        mask = (mask + (mask >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+        return (unsigned) ((mask * 0x0101010101010101ull) >> 56);
+    #else
+        return (unsigned) __builtin_popcountll (mask);
+    #endif
+}
+
+// Returns the first position in [begin, end) holding either delim1 or delim2, or end if there is no one
+inline const char *findEither (const char *begin, const char *end, char delim1, char delim2) {
+    const char *pos = begin;
+
+    #if defined (SCAN_AVX2)
+        const __m256i wideNeedle1 = _mm256_set1_epi8 (delim1);
+        const __m256i wideNeedle2 = _mm256_set1_epi8 (delim2);
+
+        for (; end - pos >= 32; pos += 32) {
+            __m256i chunk = _mm256_loadu_si256 ((const __m256i *) pos);
+            uint32_t mask = (uint32_t) _mm256_movemask_epi8 (_mm256_or_si256 (_mm256_cmpeq_epi8 (chunk, wideNeedle1), _mm256_cmpeq_epi8 (chunk, wideNeedle2)));
+
+            if (mask) return pos + firstSetBit (mask);
+        }
+    #endif
+
+    #if defined (SCAN_SSE2)
+        const __m128i needle1 = _mm_set1_epi8 (delim1);
+        const __m128i needle2 = _mm_set1_epi8 (delim2);
+
+        for (; end - pos >= 16; pos += 16) {
+            __m128i chunk = _mm_loadu_si128 ((const __m128i *) pos);
+            uint32_t mask = (uint32_t) _mm_movemask_epi8 (_mm_or_si128 (_mm_cmpeq_epi8 (chunk, needle1), _mm_cmpeq_epi8 (chunk, needle2)));
+
+            if (mask) return pos + firstSetBit (mask);
+        }
+    #endif
+
+    for (; pos < end; ++ pos) {
+        if (*pos == delim1 || *pos == delim2) return pos;
+    }
+
+    return end;
+}
+
+inline const char *findByte (const char *begin, const char *end, char delim) {
+    return findEither (begin, end, delim, delim);
+}
+
+// Unbounded version for buffers known to contain one of the delimiters (terminated fields, zero-terminated text).
+// Aligned loads never cross a page boundary, so reading past the delimiter inside the block is safe.
+inline const char *findEither (const char *begin, char delim1, char delim2) {
+    #if defined (SCAN_SSE2)
+        const __m128i needle1 = _mm_set1_epi8 (delim1);
+        const __m128i needle2 = _mm_set1_epi8 (delim2);
+        size_t misalignment = (size_t) begin & 15;
+        const char *pos = begin - misalignment;
+        __m128i chunk = _mm_load_si128 ((const __m128i *) pos);
+        uint32_t mask = (uint32_t) _mm_movemask_epi8 (_mm_or_si128 (_mm_cmpeq_epi8 (chunk, needle1), _mm_cmpeq_epi8 (chunk, needle2)));
+
+        // Skip bytes preceding begin in the first block
+        mask &= 0xFFFFFFFF << misalignment;
+
+        while (!mask) {
+            pos += 16;
+            chunk = _mm_load_si128 ((const __m128i *) pos);
+            mask = (uint32_t) _mm_movemask_epi8 (_mm_or_si128 (_mm_cmpeq_epi8 (chunk, needle1), _mm_cmpeq_epi8 (chunk, needle2)));
+        }
+
+        return pos + firstSetBit (mask);
+    #else
+        const char *pos = begin;
+
+        while (*pos != delim1 && *pos != delim2) ++ pos;
+
+        return pos;
+    #endif
+}
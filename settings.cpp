@@ -13,5 +13,6 @@ ChartSettings::ChartSettings ():
     safetyContour (30.0),
     shallowContour (2.0),
     deepContour (30.0),
-    safetyDepth (30.0) {
+    safetyDepth (30.0),
+    generation (0) {
 }
\ No newline at end of file
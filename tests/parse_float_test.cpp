@@ -0,0 +1,117 @@
+// Checks parseFloatField against strtod and parseSignedField against strtol on a generated corpus, then times
+// parseFloatField against atof. Needs no Windows headers:
+//     cl /O2 /EHsc /std:c++17 /I.. parse_float_test.cpp
+//     g++ -O2 -std=c++17 -I.. parse_float_test.cpp -o parse_float_test
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "field_values.h"
+
+static void buildCorpus (std::vector<std::string>& corpus) {
+    std::mt19937_64 random (1);
+
+    corpus = {
+        "0", "-0", "+0", "0.0", "000000.000000", "0." + std::string (40, '0'), "-0." + std::string (60, '0'),
+        std::string (30, '0') + "." + std::string (30, '0'), ".", "", " ", "  12.5", "-3.25", "1e5", "1.5E-3",
+        "123456789012345678901234", "0." + std::string (30, '0') + "1", "0.1", "0.3", "12345.6789", "-179.999999",
+        "99999999999999.9", "0.000001", "1" + std::string (25, '0'), "inf", "-nan", "7.", "-.5",
+    };
+
+    for (int i = 0; i < 200000; ++ i) {
+        char buffer [64];
+
+        switch (i % 4) {
+            case 0:
+                snprintf (buffer, sizeof (buffer), "%.*f", (int) (random () % 10), (double) (int64_t) (random () % 2000000000) / 1000.0 - 1e6); break;
+            case 1:
+                snprintf (buffer, sizeof (buffer), "%.*f", (int) (random () % 25), (double) (random () % 100000) * 1e-9); break;
+            case 2:
+                snprintf (buffer, sizeof (buffer), "%.17g", std::ldexp ((double) (random () >> 11), (int) (random () % 100) - 80)); break;
+            default: {
+                std::string value = "0.";
+
+                value.append (random () % 40, '0');
+                value += std::to_string (random () % 1000);
+                snprintf (buffer, sizeof (buffer), "%s", value.c_str ());
+            }
+        }
+
+        corpus.push_back (buffer);
+    }
+}
+
+static size_t checkFloats (std::vector<std::string>& corpus) {
+    size_t numOfMismatches = 0;
+
+    for (auto& text: corpus) {
+        double actual = parseFloatField (text.data (), text.size ());
+        double expected = strtod (text.c_str (), 0);
+
+        if (memcmp (& actual, & expected, sizeof (double)) != 0 && !(std::isnan (actual) && std::isnan (expected))) {
+            if (numOfMismatches ++ < 10) printf ("parseFloatField ('%s') = %.17g, strtod gives %.17g\n", text.c_str (), actual, expected);
+        }
+    }
+
+    return numOfMismatches;
+}
+
+static size_t checkIntegers () {
+    std::vector<std::string> corpus = {
+        "", " ", "0", "-0", "+7", "  42", "2147483647", "2147483648", "-2147483648", "-2147483649",
+        "99999999999", "-99999999999", "123456789012345678901234567890", "12abc", "-",
+    };
+    std::mt19937_64 random (2);
+    size_t numOfMismatches = 0;
+
+    for (int i = 0; i < 100000; ++ i) corpus.push_back (std::to_string ((int64_t) random () >> (random () % 64)));
+
+    for (auto& text: corpus) {
+        long long expected = strtoll (text.c_str (), 0, 10);
+        int32_t actual = parseSignedField (text.data (), text.size ());
+
+        if (expected > INT_MAX) expected = INT_MAX;
+        if (expected < INT_MIN) expected = INT_MIN;
+
+        if (actual != expected && numOfMismatches ++ < 10) printf ("parseSignedField ('%s') = %d, expected %lld\n", text.c_str (), actual, expected);
+    }
+
+    return numOfMismatches;
+}
+
+int main () {
+    std::vector<std::string> corpus;
+
+    buildCorpus (corpus);
+
+    size_t floatMismatches = checkFloats (corpus);
+    size_t intMismatches = checkIntegers ();
+
+    printf ("%zu float strings, %zu mismatches; %zu integer mismatches\n", corpus.size (), floatMismatches, intMismatches);
+
+    double sum = 0.0;
+    auto startedAt = std::chrono::steady_clock::now ();
+
+    for (int i = 0; i < 20; ++ i) for (auto& text: corpus) sum += parseFloatField (text.data (), text.size ());
+
+    auto parsedAt = std::chrono::steady_clock::now ();
+
+    for (int i = 0; i < 20; ++ i) for (auto& text: corpus) sum += atof (text.c_str ());
+
+    auto finishedAt = std::chrono::steady_clock::now ();
+    double numOfValues = 20.0 * corpus.size ();
+
+    printf (
+        "parseFloatField %.1f ns/value, atof %.1f ns/value (%g)\n",
+        std::chrono::duration<double, std::nano> (parsedAt - startedAt).count () / numOfValues,
+        std::chrono::duration<double, std::nano> (finishedAt - parsedAt).count () / numOfValues,
+        sum
+    );
+
+    return floatMismatches == 0 && intMismatches == 0 ? 0 : 1;
+}
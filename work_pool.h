@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef std::function<void ()> PoolTask;
+
+inline size_t getNumOfWorkers (size_t numOfThreads, size_t numOfTasks) {
+    if (numOfThreads == 0) numOfThreads = std::thread::hardware_concurrency ();
+    if (numOfThreads == 0) numOfThreads = 1;
+
+    return numOfThreads < numOfTasks ? numOfThreads : (numOfTasks > 0 ? numOfTasks : 1);
+}
+
+// Runs the tasks on a fixed set of workers and returns when all of them are done. Tasks are dealt round robin into
+// per-worker deques; a worker takes its own tasks from the back and steals from the front of the others once its
+// deque is empty, so tasks of very different cost get balanced without a single contended queue.
+inline void runWorkStealing (std::vector<PoolTask>& tasks, size_t numOfThreads = 0) {
+    struct WorkQueue {
+        std::mutex lock;
+        std::deque<PoolTask *> tasks;
+    };
+
+    size_t numOfWorkers = getNumOfWorkers (numOfThreads, tasks.size ());
+    std::vector<WorkQueue> queues (numOfWorkers);
+    std::vector<std::thread> workers;
+
+    for (size_t i = 0; i < tasks.size (); ++ i) {
+        queues [i % numOfWorkers].tasks.push_back (& tasks [i]);
+    }
+
+    auto takeOwn = [&queues] (size_t worker) {
+        std::lock_guard<std::mutex> guard (queues [worker].lock);
+        PoolTask *task = 0;
+
+        if (!queues [worker].tasks.empty ()) {
+            task = queues [worker].tasks.back ();
+            queues [worker].tasks.pop_back ();
+        }
+
+        return task;
+    };
+    auto steal = [&queues, numOfWorkers] (size_t worker) {
+        for (size_t i = 1; i < numOfWorkers; ++ i) {
+            auto& victim = queues [(worker + i) % numOfWorkers];
+            std::lock_guard<std::mutex> guard (victim.lock);
+
+            if (!victim.tasks.empty ()) {
+                PoolTask *task = victim.tasks.front ();
+                victim.tasks.pop_front ();
+                return task;
+            }
+        }
+
+        return (PoolTask *) 0;
+    };
+    auto work = [&takeOwn, &steal] (size_t worker) {
+        // Tasks never spawn new tasks so once nothing could be stolen the work is over
+        for (PoolTask *task = takeOwn (worker); task || (task = steal (worker)); task = takeOwn (worker)) {
+            (*task) ();
+        }
+    };
+
+    for (size_t i = 1; i < numOfWorkers; ++ i) {
+        workers.emplace_back (work, i);
+    }
+
+    work (0);
+
+    for (auto& worker: workers) worker.join ();
+}
+
+// Blocking FIFO of limited capacity connecting pipeline stages. close () lets the consumer drain the rest and stop.
+// Queue length is sampled at every push to show how busy the consumer is.
+template<typename T>
+struct BoundedQueue {
+    std::mutex lock;
+    std::condition_variable notEmpty, notFull;
+    std::deque<T> items;
+    size_t capacity;
+    bool closed;
+    uint64_t numOfPushes;
+    uint64_t sumOfLengths;
+    size_t maxLength;
+
+    BoundedQueue (size_t _capacity): capacity (_capacity ? _capacity : 1), closed (false), numOfPushes (0), sumOfLengths (0), maxLength (0) {}
+
+    void push (T item) {
+        std::unique_lock<std::mutex> guard (lock);
+
+        notFull.wait (guard, [this] () { return items.size () < capacity; });
+
+        items.push_back (std::move (item));
+
+        ++ numOfPushes;
+        sumOfLengths += items.size ();
+        if (items.size () > maxLength) maxLength = items.size ();
+
+        guard.unlock ();
+        notEmpty.notify_one ();
+    }
+
+    // Returns false once the queue is closed and empty
+    bool pop (T& item) {
+        std::unique_lock<std::mutex> guard (lock);
+
+        notEmpty.wait (guard, [this] () { return !items.empty () || closed; });
+
+        if (items.empty ()) return false;
+
+        item = std::move (items.front ());
+        items.pop_front ();
+
+        guard.unlock ();
+        notFull.notify_one ();
+
+        return true;
+    }
+
+    void close () {
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            closed = true;
+        }
+        notEmpty.notify_all ();
+    }
+
+    double averageLength () {
+        return numOfPushes ? (double) sumOfLengths / (double) numOfPushes : 0.0;
+    }
+};